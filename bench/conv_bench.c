@@ -0,0 +1,1110 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  conv_bench.c
+  @brief Offline benchmark of the data conversions of the driver.
+
+  The driver is linked statically and its handles are set up without any
+  server: a statement gets a synthetic result set with a column of each
+  MySQL type, filled with values of the usual shapes and lengths. Every
+  pair of a column and an ODBC C type is then converted both ways:
+
+  - get: the text of the server to the C type, with sql_get_data(), which
+    goes through copy_ansi_result(), copy_wchar_result(), copy_binary_result(),
+    copy_binhex_result(), str_to_ts() or sqlnum_from_str() as the pair
+    requires;
+  - put: the C values obtained above back to the SQL type of the column,
+    with insert_param(), which goes through convert_c_type2str() and the
+    escaping of the statement text.
+
+  SQL_C_CHAR is measured with an utf8 ANSI character set, the same as the
+  connection, and with latin1 as well (CHAR_LATIN1), which goes through the
+  conversion tables of copy_and_convert().
+
+  chunk: a single large value of the VARCHAR and BLOB columns is read with
+  sql_get_data() in small pieces, as an application calling SQLGetData()
+  again and again with a small buffer does, to any variable length C type.
+  Such cells are reported by chunk rather than by value.
+
+  The standalone kernels str_to_ts(), sqlnum_from_str() and sqlnum_to_str()
+  are measured on their own as well. Each cell is run several rounds over
+  the same values and the best round is reported, as nanoseconds per value
+  and as megabytes per second of the text of the values.
+
+  Usage: mdbodbc-bench-conv [-n values] [-r rounds] [-f pattern]
+                            [-c chunk] [-o file.csv] [-b baseline.csv]
+                            [-t tolerance]
+
+  -f runs only the cells whose name, like get/DECIMAL/NUMERIC, contains the
+  pattern. -o writes the results as CSV, and -b compares them with such a
+  file, the exit status being 1 if a cell is slower than in the baseline by
+  more than the tolerance factor (1.10 by default).
+*/
+
+#include "driver.h"
+#include <locale.h>
+#include <math.h>
+
+#define BENCH_VALUES      5000
+#define BENCH_ROUNDS      5
+#define BENCH_TOLERANCE   1.10
+#define BENCH_TEXT_SIZE   520     /* room for the text of any value */
+#define BENCH_VAR_SIZE    4096    /* buffer of a variable length C value */
+#define BENCH_PACKET_SIZE (16L * 1024L * 1024L)
+#define BENCH_NULL_RATE   50      /* one value in that many is NULL */
+#define BENCH_MAX_CELLS   1024
+#define BENCH_NUM_TEXT    64      /* room for the text of a SQL_NUMERIC */
+#define BENCH_CHUNK       100     /* buffer of a chunk, in bytes */
+#define BENCH_CHUNK_VALUE (1024L * 1024L)  /* length of a chunked value */
+
+
+typedef struct
+{
+  ulonglong state;
+} BENCH_RNG;
+
+
+/* Generator of the text of a value, returns its length */
+typedef uint (*bench_gen)(BENCH_RNG *rng, char *to);
+
+
+typedef struct
+{
+  const char           *name;
+  enum enum_field_types type;
+  uint                  flags;
+  uint                  charsetnr;
+  ulong                 length;
+  uint                  decimals;
+  SQLSMALLINT           sql_type;   /* SQL type of the parameters sent */
+  bench_gen             gen;
+} BENCH_COLUMN;
+
+
+typedef struct
+{
+  const char  *name;
+  SQLSMALLINT  type;
+  SQLLEN       size;                /* 0 for variable length types */
+  const char  *charset;             /* ANSI character set, NULL for utf8 */
+} BENCH_CTYPE;
+
+
+typedef struct
+{
+  char      **values;               /* NULL for SQL NULL */
+  ulong      *lengths;
+  ulonglong   bytes;                /* total length of the values */
+  char       *arena;
+} BENCH_DATA;
+
+
+typedef struct
+{
+  char        cell[64];
+  double      ns;
+} BENCH_RESULT;
+
+
+typedef struct
+{
+  /* options */
+  ulong         values;
+  uint          rounds;
+  ulong         chunk;
+  const char   *filter;
+  FILE         *csv;
+  double        tolerance;
+
+  /* cells of the baseline, if any */
+  BENCH_RESULT *baseline;
+  uint          baseline_count;
+  uint          regressions;
+
+  /* fixture */
+  SQLHENV       henv;
+  SQLHDBC       hdbc;
+  STMT         *stmt;
+  MYSQL_RES     result;
+  MYSQL_FIELD  *fields;
+} BENCH;
+
+
+static ulonglong rng_next(BENCH_RNG *rng)
+{
+  /* xorshift64*, the values only have to be the same from run to run */
+  rng->state^= rng->state >> 12;
+  rng->state^= rng->state << 25;
+  rng->state^= rng->state >> 27;
+  return rng->state * 2685821657736338717ULL;
+}
+
+
+static uint rng_below(BENCH_RNG *rng, uint bound)
+{
+  return (uint)(rng_next(rng) % bound);
+}
+
+
+/**
+  Integer with a number of digits uniform up to max_digits, so that short
+  values are as common as long ones, and a quarter of them negative.
+*/
+static uint gen_integer(BENCH_RNG *rng, char *to, uint max_digits,
+                        ulonglong limit)
+{
+  uint digits= 1 + rng_below(rng, max_digits);
+  ulonglong value= rng_next(rng);
+  ulonglong bound= 1;
+
+  while (digits--)
+  {
+    bound*= 10;
+  }
+  value%= myodbc_min(bound, limit);
+
+  return sprintf(to, "%s%llu", value && !rng_below(rng, 4) ? "-" : "", value);
+}
+
+
+static uint gen_tinyint(BENCH_RNG *rng, char *to)
+{
+  return gen_integer(rng, to, 3, 128);
+}
+
+
+static uint gen_smallint(BENCH_RNG *rng, char *to)
+{
+  return gen_integer(rng, to, 5, 32768);
+}
+
+
+static uint gen_int(BENCH_RNG *rng, char *to)
+{
+  return gen_integer(rng, to, 10, 2147483648ULL);
+}
+
+
+static uint gen_bigint(BENCH_RNG *rng, char *to)
+{
+  return gen_integer(rng, to, 19, 9223372036854775807ULL);
+}
+
+
+static uint gen_double(BENCH_RNG *rng, char *to)
+{
+  double value= (double)(rng_next(rng) >> 11) / (double)(1ULL << 53);
+  int exponent= (int)rng_below(rng, 21) - 10;
+
+  value*= pow(10.0, exponent);
+  if (!rng_below(rng, 4))
+  {
+    value= -value;
+  }
+
+  /* Mostly short values, as a server prints the stored ones */
+  return sprintf(to, "%.*g", 1 + (int)rng_below(rng, 17), value);
+}
+
+
+/* DECIMAL(20,4) */
+static uint gen_decimal(BENCH_RNG *rng, char *to)
+{
+  char whole[24];
+
+  gen_integer(rng, whole, 16, 10000000000000000ULL);
+  return sprintf(to, "%s.%04u", whole, rng_below(rng, 10000));
+}
+
+
+static uint gen_date(BENCH_RNG *rng, char *to)
+{
+  return sprintf(to, "%04u-%02u-%02u", 1970 + rng_below(rng, 68),
+                 1 + rng_below(rng, 12), 1 + rng_below(rng, 28));
+}
+
+
+static uint gen_time(BENCH_RNG *rng, char *to)
+{
+  return sprintf(to, "%02u:%02u:%02u", rng_below(rng, 24),
+                 rng_below(rng, 60), rng_below(rng, 60));
+}
+
+
+/* DATETIME(6), a third of the values with a fractional part */
+static uint gen_datetime(BENCH_RNG *rng, char *to)
+{
+  uint length= gen_date(rng, to);
+
+  to[length++]= ' ';
+  length+= gen_time(rng, to + length);
+  if (!rng_below(rng, 3))
+  {
+    length+= sprintf(to + length, ".%06u", rng_below(rng, 1000000));
+  }
+
+  return length;
+}
+
+
+static uint gen_timestamp(BENCH_RNG *rng, char *to)
+{
+  uint length= gen_date(rng, to);
+
+  to[length++]= ' ';
+  return length + gen_time(rng, to + length);
+}
+
+
+/*
+  Mostly short ASCII strings, some up to 64 characters, and one in ten with
+  two and three byte UTF-8 characters.
+*/
+static uint gen_varchar(BENCH_RNG *rng, char *to)
+{
+  static const char ascii[]= "abcdefghijklmnopqrstuvwxyz"
+                             "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ";
+  uint shape= rng_below(rng, 20);
+  uint chars= shape == 0 ? 0 : shape < 15 ? 1 + rng_below(rng, 16) :
+                                            17 + rng_below(rng, 48);
+  my_bool multibyte= !rng_below(rng, 10);
+  char *pos= to;
+
+  while (chars--)
+  {
+    if (multibyte && !rng_below(rng, 4))
+    {
+      pos= strmov(pos, rng_below(rng, 2) ? "\xc3\xa9" : "\xe4\xb8\xad");
+    }
+    else
+    {
+      *pos++= ascii[rng_below(rng, sizeof(ascii) - 1)];
+    }
+  }
+  *pos= 0;
+
+  return (uint)(pos - to);
+}
+
+
+static uint gen_blob(BENCH_RNG *rng, char *to)
+{
+  uint length= rng_below(rng, 513);
+  uint i;
+
+  for (i= 0; i < length; ++i)
+  {
+    to[i]= (char)rng_next(rng);
+  }
+  to[length]= 0;
+
+  return length;
+}
+
+
+/* BIT(1), sent as one byte */
+static uint gen_bit(BENCH_RNG *rng, char *to)
+{
+  to[0]= (char)rng_below(rng, 2);
+  to[1]= 0;
+  return 1;
+}
+
+
+static const BENCH_COLUMN columns[]=
+{
+  {"TINYINT", MYSQL_TYPE_TINY, NUM_FLAG, BINARY_CHARSET_NUMBER, 4, 0,
+   SQL_TINYINT, gen_tinyint},
+  {"SMALLINT", MYSQL_TYPE_SHORT, NUM_FLAG, BINARY_CHARSET_NUMBER, 6, 0,
+   SQL_SMALLINT, gen_smallint},
+  {"INT", MYSQL_TYPE_LONG, NUM_FLAG, BINARY_CHARSET_NUMBER, 11, 0,
+   SQL_INTEGER, gen_int},
+  {"BIGINT", MYSQL_TYPE_LONGLONG, NUM_FLAG, BINARY_CHARSET_NUMBER, 20, 0,
+   SQL_BIGINT, gen_bigint},
+  {"DOUBLE", MYSQL_TYPE_DOUBLE, NUM_FLAG, BINARY_CHARSET_NUMBER, 22, 31,
+   SQL_DOUBLE, gen_double},
+  {"DECIMAL", MYSQL_TYPE_NEWDECIMAL, NUM_FLAG, BINARY_CHARSET_NUMBER, 22, 4,
+   SQL_DECIMAL, gen_decimal},
+  {"DATE", MYSQL_TYPE_DATE, BINARY_FLAG, BINARY_CHARSET_NUMBER, 10, 0,
+   SQL_TYPE_DATE, gen_date},
+  {"TIME", MYSQL_TYPE_TIME, BINARY_FLAG, BINARY_CHARSET_NUMBER, 10, 0,
+   SQL_TYPE_TIME, gen_time},
+  {"DATETIME", MYSQL_TYPE_DATETIME, BINARY_FLAG, BINARY_CHARSET_NUMBER, 26, 6,
+   SQL_TYPE_TIMESTAMP, gen_datetime},
+  {"TIMESTAMP", MYSQL_TYPE_TIMESTAMP, BINARY_FLAG, BINARY_CHARSET_NUMBER, 19, 0,
+   SQL_TYPE_TIMESTAMP, gen_timestamp},
+  {"VARCHAR", MYSQL_TYPE_VAR_STRING, 0, UTF8_CHARSET_NUMBER, 192, 0,
+   SQL_VARCHAR, gen_varchar},
+  {"BLOB", MYSQL_TYPE_BLOB, BLOB_FLAG | BINARY_FLAG, BINARY_CHARSET_NUMBER,
+   65535, 0, SQL_LONGVARBINARY, gen_blob},
+  {"BIT", MYSQL_TYPE_BIT, UNSIGNED_FLAG, BINARY_CHARSET_NUMBER, 1, 0,
+   SQL_BIT, gen_bit}
+};
+
+
+static const BENCH_CTYPE ctypes[]=
+{
+  {"CHAR", SQL_C_CHAR, 0, NULL},
+  {"CHAR_LATIN1", SQL_C_CHAR, 0, "latin1"},
+  {"WCHAR", SQL_C_WCHAR, 0, NULL},
+  {"BINARY", SQL_C_BINARY, 0, NULL},
+  {"BIT", SQL_C_BIT, sizeof(SQLCHAR), NULL},
+  {"STINYINT", SQL_C_STINYINT, sizeof(SQLSCHAR), NULL},
+  {"UTINYINT", SQL_C_UTINYINT, sizeof(SQLCHAR), NULL},
+  {"SSHORT", SQL_C_SSHORT, sizeof(SQLSMALLINT), NULL},
+  {"USHORT", SQL_C_USHORT, sizeof(SQLUSMALLINT), NULL},
+  {"SLONG", SQL_C_SLONG, sizeof(SQLINTEGER), NULL},
+  {"ULONG", SQL_C_ULONG, sizeof(SQLUINTEGER), NULL},
+  {"SBIGINT", SQL_C_SBIGINT, sizeof(SQLBIGINT), NULL},
+  {"UBIGINT", SQL_C_UBIGINT, sizeof(SQLUBIGINT), NULL},
+  {"FLOAT", SQL_C_FLOAT, sizeof(SQLREAL), NULL},
+  {"DOUBLE", SQL_C_DOUBLE, sizeof(SQLDOUBLE), NULL},
+  {"NUMERIC", SQL_C_NUMERIC, sizeof(SQL_NUMERIC_STRUCT), NULL},
+  {"TYPE_DATE", SQL_C_TYPE_DATE, sizeof(SQL_DATE_STRUCT), NULL},
+  {"TYPE_TIME", SQL_C_TYPE_TIME, sizeof(SQL_TIME_STRUCT), NULL},
+  {"TYPE_TIMESTAMP", SQL_C_TYPE_TIMESTAMP, sizeof(SQL_TIMESTAMP_STRUCT), NULL}
+};
+
+
+static my_bool bench_data_init(BENCH *bench, const BENCH_COLUMN *column,
+                               BENCH_DATA *data)
+{
+  BENCH_RNG rng;
+  ulong i;
+
+  data->values= (char **)myodbc_malloc(sizeof(char *) * bench->values,
+                                       MYF(0));
+  data->lengths= (ulong *)myodbc_malloc(sizeof(ulong) * bench->values,
+                                        MYF(0));
+  data->arena= (char *)myodbc_malloc(BENCH_TEXT_SIZE * bench->values, MYF(0));
+  data->bytes= 0;
+
+  if (!data->values || !data->lengths || !data->arena)
+  {
+    return 1;
+  }
+
+  /* Each column has its own values, the same in every run */
+  rng.state= 0x9e3779b97f4a7c15ULL ^ (ulonglong)column->type;
+
+  for (i= 0; i < bench->values; ++i)
+  {
+    if (!rng_below(&rng, BENCH_NULL_RATE))
+    {
+      data->values[i]= NULL;
+      data->lengths[i]= 0;
+      continue;
+    }
+
+    data->values[i]= data->arena + BENCH_TEXT_SIZE * i;
+    data->lengths[i]= column->gen(&rng, data->values[i]);
+    data->bytes+= data->lengths[i];
+  }
+
+  return 0;
+}
+
+
+static void bench_data_free(BENCH_DATA *data)
+{
+  x_free(data->values);
+  x_free(data->lengths);
+  x_free(data->arena);
+}
+
+
+static my_bool bench_selected(BENCH *bench, const char *cell)
+{
+  return !bench->filter || strstr(cell, bench->filter) != NULL;
+}
+
+
+/* count is the number of values, or of chunks, converted in a round */
+static void bench_report(BENCH *bench, const char *cell, ulonglong best,
+                         ulong count, ulonglong bytes, ulong errors)
+{
+  double ns= (double)best / count;
+  double mbps= best ? (double)bytes * 1000.0 / (double)best : 0.0;
+  uint i;
+
+  printf("%-34s %10.1f %10.1f %8lu\n", cell, ns, mbps, errors);
+
+  if (bench->csv)
+  {
+    fprintf(bench->csv, "%s,%.2f,%.2f,%lu\n", cell, ns, mbps, errors);
+  }
+
+  for (i= 0; i < bench->baseline_count; ++i)
+  {
+    if (!strcmp(bench->baseline[i].cell, cell))
+    {
+      if (ns > bench->baseline[i].ns * bench->tolerance)
+      {
+        printf("%-34s regressed from %.1f ns\n", cell, bench->baseline[i].ns);
+        ++bench->regressions;
+      }
+      break;
+    }
+  }
+}
+
+
+static void bench_report_na(const char *cell)
+{
+  printf("%-34s %10s\n", cell, "n/a");
+}
+
+
+/**
+  Convert the values of a column to a C type, as SQLGetData() does.
+
+  @param[out] out      Converted values, by column-wise binding
+  @param[out] out_len  Their lengths or indicators, SQL_NULL_DATA for the
+                       values that could not be converted
+
+  @return FALSE if the driver does not support the conversion
+*/
+static my_bool bench_get(BENCH *bench, uint col, const BENCH_CTYPE *ctype,
+                         const BENCH_DATA *data, char *out, SQLLEN *out_len)
+{
+  STMT *stmt= bench->stmt;
+  const BENCH_COLUMN *column= &columns[col];
+  SQLLEN size= ctype->size ? ctype->size : BENCH_VAR_SIZE;
+  DESCREC *arrec= NULL;
+  ulonglong best= ~(ulonglong)0, start;
+  ulong errors= 0, i;
+  uint round, rounds;
+  SQLRETURN rc;
+  my_bool report;
+  char cell[64];
+
+  /* Without its own cell selected, one round provides the values of the
+     put cell */
+  sprintf(cell, "get/%s/%s", column->name, ctype->name);
+  report= bench_selected(bench, cell);
+  rounds= report ? bench->rounds : 1;
+
+  /* The scale of SQL_C_NUMERIC comes from the ARD, as the applications
+     that want the fractional digits set it */
+  if (ctype->type == SQL_C_NUMERIC)
+  {
+    arrec= desc_get_rec(stmt->ard, col, TRUE);
+    arrec->concise_type= SQL_C_NUMERIC;
+    arrec->precision= 38;
+    arrec->scale= column->decimals;
+  }
+
+  /* Not every error sets a state, so one left by another cell is cleared */
+  stmt->error.sqlstate[0]= 0;
+
+  for (round= 0; round < rounds; ++round)
+  {
+    errors= 0;
+    start= latency_now();
+
+    for (i= 0; i < bench->values; ++i)
+    {
+      reset_getdata_position(stmt);
+      stmt->getdata.column= col;
+
+      rc= sql_get_data(stmt, ctype->type, col, out + size * i, size,
+                       out_len + i, data->values[i], data->lengths[i], arrec);
+
+      if (!SQL_SUCCEEDED(rc))
+      {
+        if (!strcmp(stmt->error.sqlstate, "07006"))
+        {
+          if (report)
+          {
+            bench_report_na(cell);
+          }
+          return FALSE;
+        }
+        out_len[i]= SQL_NULL_DATA;
+        ++errors;
+      }
+    }
+
+    best= myodbc_min(best, latency_now() - start);
+  }
+
+  if (report)
+  {
+    bench_report(bench, cell, best, bench->values, data->bytes, errors);
+  }
+  return TRUE;
+}
+
+
+/**
+  Write values of a C type as parameters of the SQL type of a column, as
+  SQLExecute() does when it builds the statement text.
+*/
+static void bench_put(BENCH *bench, uint col, const BENCH_CTYPE *ctype,
+                      char *in, SQLLEN *in_len)
+{
+  STMT *stmt= bench->stmt;
+  NET *net= &stmt->dbc->mysql.net;
+  const BENCH_COLUMN *column= &columns[col];
+  DESCREC *aprec= desc_get_rec(stmt->apd, 0, TRUE);
+  DESCREC *iprec= desc_get_rec(stmt->ipd, 0, TRUE);
+  ulonglong best= ~(ulonglong)0, bytes= 0, start;
+  ulong errors= 0, i;
+  uint round;
+  SQLRETURN rc;
+  char cell[64], *to;
+
+  sprintf(cell, "put/%s/%s", column->name, ctype->name);
+  if (!bench_selected(bench, cell))
+  {
+    return;
+  }
+
+  aprec->concise_type= ctype->type;
+  aprec->type= get_type_from_concise_type(ctype->type);
+  aprec->octet_length= ctype->size ? ctype->size : BENCH_VAR_SIZE;
+  aprec->data_ptr= in;
+  aprec->octet_length_ptr= aprec->indicator_ptr= in_len;
+
+  iprec->concise_type= column->sql_type;
+  iprec->type= get_type_from_concise_type(column->sql_type);
+  iprec->precision= (SQLSMALLINT)myodbc_min(column->length, 38);
+  iprec->scale= column->decimals;
+  stmt->error.sqlstate[0]= 0;
+
+  for (round= 0; round < bench->rounds; ++round)
+  {
+    errors= 0;
+    start= latency_now();
+
+    for (i= 0; i < bench->values; ++i)
+    {
+      /* Every value is written at the start of the statement buffer */
+      to= (char *)net->buff;
+      rc= insert_param(stmt, (uchar *)&to, stmt->apd, aprec, iprec, i);
+
+      if (!SQL_SUCCEEDED(rc))
+      {
+        if (!strcmp(stmt->error.sqlstate, "07006"))
+        {
+          bench_report_na(cell);
+          return;
+        }
+        ++errors;
+      }
+      else if (!round)
+      {
+        bytes+= (ulonglong)(to - (char *)net->buff);
+      }
+    }
+
+    best= myodbc_min(best, latency_now() - start);
+  }
+
+  bench_report(bench, cell, best, bench->values, bytes, errors);
+}
+
+
+/**
+  The conversion kernels on their own, on the values of the columns they
+  are used for.
+*/
+static void bench_kernels(BENCH *bench, uint col, const BENCH_DATA *data)
+{
+  const BENCH_COLUMN *column= &columns[col];
+  my_bool dont_use_set_locale= bench->stmt->dbc->ds->dont_use_set_locale;
+  SQL_NUMERIC_STRUCT *nums= NULL;
+  SQL_TIMESTAMP_STRUCT ts;
+  ulonglong best, start;
+  ulong errors, i;
+  uint round;
+  char cell[64], text[BENCH_NUM_TEXT];
+  SQLCHAR *begin;
+  int status;
+
+  if (column->type == MYSQL_TYPE_DATETIME)
+  {
+    sprintf(cell, "fn/%s/str_to_ts", column->name);
+    if (bench_selected(bench, cell))
+    {
+      best= ~(ulonglong)0;
+      for (round= 0; round < bench->rounds; ++round)
+      {
+        errors= 0;
+        start= latency_now();
+        for (i= 0; i < bench->values; ++i)
+        {
+          if (data->values[i] &&
+              str_to_ts(&ts, data->values[i], (int)data->lengths[i], 0,
+                        dont_use_set_locale))
+          {
+            ++errors;
+          }
+        }
+        best= myodbc_min(best, latency_now() - start);
+      }
+      bench_report(bench, cell, best, bench->values, data->bytes, errors);
+    }
+  }
+
+  if (column->type != MYSQL_TYPE_NEWDECIMAL)
+  {
+    return;
+  }
+
+  nums= (SQL_NUMERIC_STRUCT *)myodbc_malloc(sizeof(SQL_NUMERIC_STRUCT) *
+                                            bench->values, MYF(MY_ZEROFILL));
+  if (!nums)
+  {
+    return;
+  }
+
+  sprintf(cell, "fn/%s/sqlnum_from_str", column->name);
+  if (bench_selected(bench, cell))
+  {
+    best= ~(ulonglong)0;
+    for (round= 0; round < bench->rounds; ++round)
+    {
+      errors= 0;
+      start= latency_now();
+      for (i= 0; i < bench->values; ++i)
+      {
+        if (data->values[i])
+        {
+          nums[i].precision= 38;
+          nums[i].scale= column->decimals;
+          status= 0;
+          sqlnum_from_str(data->values[i], nums + i, &status);
+          errors+= status != 0;
+        }
+      }
+      best= myodbc_min(best, latency_now() - start);
+    }
+    bench_report(bench, cell, best, bench->values, data->bytes, errors);
+  }
+
+  sprintf(cell, "fn/%s/sqlnum_to_str", column->name);
+  if (bench_selected(bench, cell))
+  {
+    /* Filled here too, for when the cell above is not run */
+    for (i= 0; i < bench->values; ++i)
+    {
+      nums[i].precision= 38;
+      nums[i].scale= column->decimals;
+      if (data->values[i])
+      {
+        sqlnum_from_str(data->values[i], nums + i, &status);
+      }
+    }
+
+    best= ~(ulonglong)0;
+    for (round= 0; round < bench->rounds; ++round)
+    {
+      errors= 0;
+      start= latency_now();
+      for (i= 0; i < bench->values; ++i)
+      {
+        status= 0;
+        sqlnum_to_str(nums + i, (SQLCHAR *)text + sizeof(text) - 1, &begin,
+                      38, (SQLSCHAR)column->decimals, &status);
+        errors+= status != 0;
+      }
+      best= myodbc_min(best, latency_now() - start);
+    }
+    bench_report(bench, cell, best, bench->values, data->bytes, errors);
+  }
+
+  x_free(nums);
+}
+
+
+/**
+  Read a large value of a column in chunks, as SQLGetData() does when it is
+  called until SQL_NO_DATA with a small buffer.
+*/
+static void bench_chunked(BENCH *bench, uint col, const BENCH_CTYPE *ctype)
+{
+  STMT *stmt= bench->stmt;
+  const BENCH_COLUMN *column= &columns[col];
+  ulonglong best= ~(ulonglong)0, start;
+  ulong length= 0, calls= 0, errors= 0;
+  uint round;
+  BENCH_RNG rng;
+  SQLRETURN rc;
+  SQLLEN len;
+  char cell[64], *value, *out;
+
+  sprintf(cell, "chunk/%s/%s", column->name, ctype->name);
+  if (ctype->size || (column->type != MYSQL_TYPE_VAR_STRING &&
+                      column->type != MYSQL_TYPE_BLOB) ||
+      !bench_selected(bench, cell))
+  {
+    return;
+  }
+
+  value= (char *)myodbc_malloc(BENCH_CHUNK_VALUE + BENCH_TEXT_SIZE, MYF(0));
+  out= (char *)myodbc_malloc(bench->chunk, MYF(0));
+  if (!value || !out)
+  {
+    x_free(value);
+    x_free(out);
+    return;
+  }
+
+  /* The values of the column one after the other */
+  rng.state= 0x9e3779b97f4a7c15ULL ^ (ulonglong)column->type;
+  while (length < BENCH_CHUNK_VALUE)
+  {
+    length+= column->gen(&rng, value + length);
+  }
+
+  stmt->error.sqlstate[0]= 0;
+
+  for (round= 0; round < bench->rounds; ++round)
+  {
+    calls= errors= 0;
+    start= latency_now();
+
+    reset_getdata_position(stmt);
+    stmt->getdata.column= col;
+
+    do
+    {
+      rc= sql_get_data(stmt, ctype->type, col, out, (SQLLEN)bench->chunk,
+                       &len, value, length, NULL);
+      ++calls;
+    } while (SQL_SUCCEEDED(rc));
+
+    best= myodbc_min(best, latency_now() - start);
+
+    if (rc != SQL_NO_DATA_FOUND)
+    {
+      if (!strcmp(stmt->error.sqlstate, "07006"))
+      {
+        bench_report_na(cell);
+        x_free(value);
+        x_free(out);
+        return;
+      }
+      ++errors;
+    }
+  }
+
+  bench_report(bench, cell, best, calls, length, errors);
+
+  x_free(value);
+  x_free(out);
+}
+
+
+/**
+  Set the ANSI character set of the connection for a C type.
+
+  @return TRUE if the character set is not available
+*/
+static my_bool bench_charset(BENCH *bench, const BENCH_CTYPE *ctype)
+{
+  DBC *dbc= (DBC *)bench->hdbc;
+  CHARSET_INFO *cs= utf8_charset_info;
+
+  if (ctype->charset &&
+      !(cs= get_charset_by_csname(ctype->charset, MYF(MY_CS_PRIMARY),
+                                  MYF(0))))
+  {
+    return TRUE;
+  }
+
+  dbc->ansi_charset_info= cs;
+  return FALSE;
+}
+
+
+/**
+  Allocate the handles, with a statement that has a result set of all the
+  columns and no connection behind it.
+*/
+static my_bool bench_init(BENCH *bench)
+{
+  SQLHSTMT hstmt;
+  DBC *dbc;
+  uint i;
+
+  if (!SQL_SUCCEEDED(my_SQLAllocEnv(&bench->henv)) ||
+      !SQL_SUCCEEDED(SQLSetEnvAttr(bench->henv, SQL_ATTR_ODBC_VERSION,
+                                   (SQLPOINTER)SQL_OV_ODBC3, 0)) ||
+      !SQL_SUCCEEDED(my_SQLAllocConnect(bench->henv, &bench->hdbc)))
+  {
+    return 1;
+  }
+
+  /* What connect would have set up, without a server */
+  dbc= (DBC *)bench->hdbc;
+  if (!mysql_init(&dbc->mysql) || !(dbc->ds= ds_new()))
+  {
+    return 1;
+  }
+  dbc->mysql.net.max_packet_size= BENCH_PACKET_SIZE;
+  dbc->ds->no_ssps= 1;
+  dbc->cxn_charset_info= dbc->ansi_charset_info= utf8_charset_info;
+
+  if (!SQL_SUCCEEDED(my_SQLAllocStmt(bench->hdbc, &hstmt)))
+  {
+    return 1;
+  }
+  bench->stmt= (STMT *)hstmt;
+
+  bench->fields= (MYSQL_FIELD *)myodbc_malloc(sizeof(MYSQL_FIELD) *
+                                              array_elements(columns),
+                                              MYF(MY_ZEROFILL));
+  if (!bench->fields)
+  {
+    return 1;
+  }
+
+  for (i= 0; i < array_elements(columns); ++i)
+  {
+    MYSQL_FIELD *field= bench->fields + i;
+
+    field->name= field->org_name= (char *)columns[i].name;
+    field->name_length= field->org_name_length= strlen(columns[i].name);
+    field->table= field->org_table= (char *)"bench";
+    field->table_length= field->org_table_length= 5;
+    field->db= field->catalog= field->def= (char *)"";
+    field->type= columns[i].type;
+    field->flags= columns[i].flags;
+    field->charsetnr= columns[i].charsetnr;
+    field->length= field->max_length= columns[i].length;
+    field->decimals= columns[i].decimals;
+  }
+
+  memset(&bench->result, 0, sizeof(bench->result));
+  bench->result.fields= bench->fields;
+  bench->result.field_count= array_elements(columns);
+  bench->stmt->result= &bench->result;
+  fix_result_types(bench->stmt);
+
+  return 0;
+}
+
+
+static void bench_free(BENCH *bench)
+{
+  DBC *dbc= (DBC *)bench->hdbc;
+
+  if (bench->stmt)
+  {
+    bench->stmt->result= NULL;
+    my_SQLFreeStmt((SQLHSTMT)bench->stmt, SQL_DROP);
+  }
+  if (dbc)
+  {
+    mysql_close(&dbc->mysql);
+    my_SQLFreeConnect(bench->hdbc);
+  }
+  if (bench->henv)
+  {
+    my_SQLFreeEnv(bench->henv);
+  }
+  x_free(bench->fields);
+  x_free(bench->baseline);
+}
+
+
+static my_bool bench_load_baseline(BENCH *bench, const char *path)
+{
+  FILE *file= fopen(path, "r");
+  char line[256];
+
+  if (!file)
+  {
+    return 1;
+  }
+
+  bench->baseline= (BENCH_RESULT *)myodbc_malloc(sizeof(BENCH_RESULT) *
+                                                 BENCH_MAX_CELLS, MYF(0));
+  if (!bench->baseline)
+  {
+    fclose(file);
+    return 1;
+  }
+
+  while (bench->baseline_count < BENCH_MAX_CELLS &&
+         fgets(line, sizeof(line), file))
+  {
+    BENCH_RESULT *entry= bench->baseline + bench->baseline_count;
+
+    if (sscanf(line, "%63[^,],%lf", entry->cell, &entry->ns) == 2)
+    {
+      ++bench->baseline_count;
+    }
+  }
+
+  fclose(file);
+  return 0;
+}
+
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [-n values] [-r rounds] [-f pattern] "
+          "[-c chunk] [-o file.csv] [-b baseline.csv] [-t tolerance]\n",
+          name);
+}
+
+
+int main(int argc, char **argv)
+{
+  BENCH bench;
+  BENCH_DATA data;
+  const char *baseline= NULL;
+  char *out= NULL;
+  SQLLEN *out_len= NULL;
+  int arg, status= 0;
+  uint col, ct;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.values= BENCH_VALUES;
+  bench.rounds= BENCH_ROUNDS;
+  bench.chunk= BENCH_CHUNK;
+  bench.tolerance= BENCH_TOLERANCE;
+
+  for (arg= 1; arg < argc; ++arg)
+  {
+    const char *value= arg + 1 < argc ? argv[arg + 1] : NULL;
+
+    if (!value || argv[arg][0] != '-' || !argv[arg][1] || argv[arg][2])
+    {
+      usage(argv[0]);
+      return 2;
+    }
+
+    switch (argv[arg][1])
+    {
+    case 'n': bench.values= strtoul(value, NULL, 10); break;
+    case 'r': bench.rounds= (uint)strtoul(value, NULL, 10); break;
+    case 'f': bench.filter= value; break;
+    case 'c': bench.chunk= strtoul(value, NULL, 10); break;
+    case 'b': baseline= value; break;
+    case 't': bench.tolerance= atof(value); break;
+    case 'o':
+      if (!(bench.csv= fopen(value, "w")))
+      {
+        fprintf(stderr, "Cannot write %s\n", value);
+        return 2;
+      }
+      break;
+    default:
+      usage(argv[0]);
+      return 2;
+    }
+    ++arg;
+  }
+
+  if (!bench.values || !bench.rounds || !bench.chunk)
+  {
+    usage(argv[0]);
+    return 2;
+  }
+
+  if (baseline && bench_load_baseline(&bench, baseline))
+  {
+    fprintf(stderr, "Cannot read %s\n", baseline);
+    return 2;
+  }
+
+  setlocale(LC_NUMERIC, "C");
+
+  if (bench_init(&bench) ||
+      !(out= (char *)myodbc_malloc(BENCH_VAR_SIZE * bench.values, MYF(0))) ||
+      !(out_len= (SQLLEN *)myodbc_malloc(sizeof(SQLLEN) * bench.values,
+                                         MYF(0))))
+  {
+    fprintf(stderr, "Cannot set up the driver handles\n");
+    bench_free(&bench);
+    x_free(out);
+    return 2;
+  }
+
+  printf("%-34s %10s %10s %8s\n", "cell", "ns/value", "MB/s", "errors");
+  if (bench.csv)
+  {
+    fprintf(bench.csv, "cell,ns_per_value,mb_per_s,errors\n");
+  }
+
+  for (col= 0; col < array_elements(columns); ++col)
+  {
+    if (bench_data_init(&bench, &columns[col], &data))
+    {
+      fprintf(stderr, "Out of memory\n");
+      bench_data_free(&data);
+      status= 2;
+      break;
+    }
+
+    for (ct= 0; ct < array_elements(ctypes); ++ct)
+    {
+      char get_cell[64], put_cell[64];
+
+      sprintf(get_cell, "get/%s/%s", columns[col].name, ctypes[ct].name);
+      sprintf(put_cell, "put/%s/%s", columns[col].name, ctypes[ct].name);
+
+      if (bench_charset(&bench, &ctypes[ct]))
+      {
+        continue;
+      }
+
+      /* The parameters are the values read back, so that both directions
+         see the same distribution */
+      if ((bench_selected(&bench, get_cell) ||
+           bench_selected(&bench, put_cell)) &&
+          bench_get(&bench, col, &ctypes[ct], &data, out, out_len))
+      {
+        bench_put(&bench, col, &ctypes[ct], out, out_len);
+      }
+
+      bench_chunked(&bench, col, &ctypes[ct]);
+    }
+
+    bench_kernels(&bench, col, &data);
+    bench_data_free(&data);
+  }
+
+  if (bench.regressions)
+  {
+    printf("%u cells regressed by more than %.0f%%\n", bench.regressions,
+           (bench.tolerance - 1.0) * 100.0);
+    status= 1;
+  }
+
+  if (bench.csv)
+  {
+    fclose(bench.csv);
+  }
+  x_free(out);
+  x_free(out_len);
+  bench_free(&bench);
+
+  return status;
+}
@@ -0,0 +1,234 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  dsn_bench.c
+  @brief Offline benchmark of the lookup of a data source in odbc.ini.
+
+  Connecting through a DSN starts with ds_lookup(), which reads the
+  attributes of the data source from odbc.ini, and the rest of the
+  connect needs a server. A data source with the usual attributes is
+  written to a temporary file pointed to by ODBCINI, then looked up again
+  and again, as each SQLConnect() does: once with the cache of data
+  sources dropped before each lookup, which reads the file as the driver
+  did before the cache, and once with the cache kept.
+
+  The best round is reported, as microseconds per lookup.
+
+  Usage: mdbodbc-bench-dsn [-n lookups] [-r rounds]
+*/
+
+#include "driver.h"
+#include <unistd.h>
+
+#define BENCH_LOOKUPS  1000
+#define BENCH_ROUNDS   5
+
+static SQLWCHAR W_BENCH_DSN[]= {'m','d','b','o','d','b','c','_','b','e','n',
+                                'c','h',0};
+
+static const char *bench_ini=
+  "[mdbodbc_bench]\n"
+  "Driver=MongoDB ODBC ANSI Driver\n"
+  "Description=Benchmark of the data source lookup\n"
+  "SERVER=localhost\n"
+  "PORT=3307\n"
+  "UID=bench\n"
+  "PWD=bench\n"
+  "DATABASE=bench\n"
+  "CHARSET=utf8\n"
+  "SSLMODE=PREFERRED\n"
+  "NO_SSPS=1\n"
+  "MULTI_STATEMENTS=1\n"
+  "FOUND_ROWS=1\n"
+  "AUTO_RECONNECT=0\n"
+  "NO_PROMPT=1\n"
+  "OPTION=0\n";
+
+
+typedef struct
+{
+  /* options */
+  ulong         lookups;
+  uint          rounds;
+
+  /* fixture */
+  char          path[64];
+} BENCH;
+
+
+/**
+  Write the data source to a temporary odbc.ini and point ODBCINI to it.
+*/
+static my_bool bench_init(BENCH *bench)
+{
+  int fd;
+  size_t len= strlen(bench_ini);
+
+  strcpy(bench->path, "/tmp/mdbodbc-bench-dsn-XXXXXX");
+  if ((fd= mkstemp(bench->path)) < 0)
+  {
+    bench->path[0]= '\0';
+    return 1;
+  }
+
+  if (write(fd, bench_ini, len) != (ssize_t)len)
+  {
+    close(fd);
+    return 1;
+  }
+  close(fd);
+
+  return setenv("ODBCINI", bench->path, 1) != 0;
+}
+
+
+static void bench_free(BENCH *bench)
+{
+  if (bench->path[0])
+  {
+    unlink(bench->path);
+  }
+  ds_cache_flush();
+}
+
+
+/**
+  Look the data source up for each round, with or without the cache.
+
+  @return The number of lookups that failed
+*/
+static ulong bench_run(BENCH *bench, my_bool cached)
+{
+  ulonglong best= ~(ulonglong)0, start;
+  ulong done, errors= 0;
+  uint round;
+  DataSource *ds;
+
+  /* Fill the cache, and check the data source is found at all */
+  ds_cache_flush();
+  if (!(ds= ds_new()))
+  {
+    return 1;
+  }
+  if (ds_set_strattr(&ds->name, W_BENCH_DSN) || ds_lookup(ds) ||
+      !ds->database)
+  {
+    ++errors;
+  }
+  ds_delete(ds);
+
+  for (round= 0; round < bench->rounds; ++round)
+  {
+    start= latency_now();
+
+    for (done= 0; done < bench->lookups; ++done)
+    {
+      if (!cached)
+      {
+        ds_cache_flush();
+      }
+
+      if (!(ds= ds_new()))
+      {
+        ++errors;
+        continue;
+      }
+      if (ds_set_strattr(&ds->name, W_BENCH_DSN) || ds_lookup(ds))
+      {
+        ++errors;
+      }
+      ds_delete(ds);
+    }
+
+    best= myodbc_min(best, latency_now() - start);
+  }
+
+  printf("%-24s %10.1f %8lu\n", cached ? "lookup/cached" : "lookup/uncached",
+         (double)best / done / 1000, errors);
+
+  return errors;
+}
+
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [-n lookups] [-r rounds]\n", name);
+}
+
+
+int main(int argc, char **argv)
+{
+  BENCH bench;
+  ulong errors;
+  int arg;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.lookups= BENCH_LOOKUPS;
+  bench.rounds= BENCH_ROUNDS;
+
+  for (arg= 1; arg < argc; ++arg)
+  {
+    const char *value= arg + 1 < argc ? argv[arg + 1] : NULL;
+
+    if (!value || argv[arg][0] != '-' || !argv[arg][1] || argv[arg][2])
+    {
+      usage(argv[0]);
+      return 2;
+    }
+
+    switch (argv[arg][1])
+    {
+    case 'n': bench.lookups= strtoul(value, NULL, 10); break;
+    case 'r': bench.rounds= (uint)strtoul(value, NULL, 10); break;
+    default:
+      usage(argv[0]);
+      return 2;
+    }
+    ++arg;
+  }
+
+  if (!bench.lookups || !bench.rounds)
+  {
+    usage(argv[0]);
+    return 2;
+  }
+
+  if (bench_init(&bench))
+  {
+    fprintf(stderr, "Cannot write the data source to %s\n", bench.path);
+    bench_free(&bench);
+    return 2;
+  }
+
+  printf("%-24s %10s %8s\n", "cell", "us/lookup", "errors");
+
+  /* odbc.ini read for each lookup, then the cached attributes */
+  errors= bench_run(&bench, FALSE);
+  errors+= bench_run(&bench, TRUE);
+
+  bench_free(&bench);
+
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  stmt_bench.c
+  @brief Offline benchmark of the allocation of statement handles.
+
+  Statements are allocated with my_SQLAllocStmt() and dropped with
+  my_SQLFreeStmt(SQL_DROP), as an application opening a statement per
+  query does, on a connection set up without any server. This is done
+  with STMT_POOL set to 0, where each handle and its descriptors are
+  allocated and freed, and with STMT_POOL set to the number of statements
+  alive at once, where dropped handles are parked and taken again.
+
+  Each round allocates that many statements and drops them, again and
+  again. The best round is reported, as nanoseconds per statement
+  allocated and dropped.
+
+  Usage: mdbodbc-bench-stmt [-n statements] [-r rounds] [-l live]
+*/
+
+#include "driver.h"
+
+#define BENCH_STATEMENTS  100000
+#define BENCH_ROUNDS      5
+#define BENCH_LIVE        4       /* statements alive at once */
+
+
+typedef struct
+{
+  /* options */
+  ulong         statements;
+  uint          rounds;
+  uint          live;
+
+  /* fixture */
+  SQLHENV       henv;
+  SQLHDBC       hdbc;
+  SQLHSTMT     *hstmts;
+} BENCH;
+
+
+/**
+  Allocate the handles of a connection, without a server.
+*/
+static my_bool bench_init(BENCH *bench)
+{
+  DBC *dbc;
+
+  if (!SQL_SUCCEEDED(my_SQLAllocEnv(&bench->henv)) ||
+      !SQL_SUCCEEDED(SQLSetEnvAttr(bench->henv, SQL_ATTR_ODBC_VERSION,
+                                   (SQLPOINTER)SQL_OV_ODBC3, 0)) ||
+      !SQL_SUCCEEDED(my_SQLAllocConnect(bench->henv, &bench->hdbc)))
+  {
+    return 1;
+  }
+
+  /* What connect would have set up, without a server */
+  dbc= (DBC *)bench->hdbc;
+  if (!mysql_init(&dbc->mysql) || !(dbc->ds= ds_new()))
+  {
+    return 1;
+  }
+
+  bench->hstmts= (SQLHSTMT *)myodbc_malloc(sizeof(SQLHSTMT) * bench->live,
+                                           MYF(MY_ZEROFILL));
+  return bench->hstmts == NULL;
+}
+
+
+static void bench_free(BENCH *bench)
+{
+  DBC *dbc= (DBC *)bench->hdbc;
+
+  if (dbc)
+  {
+    stmt_pool_flush(dbc);
+    mysql_close(&dbc->mysql);
+    my_SQLFreeConnect(bench->hdbc);
+  }
+  if (bench->henv)
+  {
+    my_SQLFreeEnv(bench->henv);
+  }
+  x_free(bench->hstmts);
+}
+
+
+/**
+  Allocate and drop the statements of a round with a STMT_POOL limit.
+
+  @return The number of allocations that failed
+*/
+static ulong bench_run(BENCH *bench, uint pool)
+{
+  DBC *dbc= (DBC *)bench->hdbc;
+  ulonglong best= ~(ulonglong)0, start;
+  ulong done, errors= 0;
+  uint round, i;
+  char cell[64];
+
+  dbc->ds->stmt_pool= pool;
+
+  for (round= 0; round < bench->rounds; ++round)
+  {
+    /* The pool is filled by the first round and kept for the others */
+    start= latency_now();
+
+    for (done= 0; done < bench->statements; done+= bench->live)
+    {
+      for (i= 0; i < bench->live; ++i)
+      {
+        if (!SQL_SUCCEEDED(my_SQLAllocStmt(bench->hdbc, bench->hstmts + i)))
+        {
+          bench->hstmts[i]= NULL;
+          ++errors;
+        }
+      }
+
+      for (i= 0; i < bench->live; ++i)
+      {
+        if (bench->hstmts[i])
+        {
+          my_SQLFreeStmt(bench->hstmts[i], SQL_DROP);
+        }
+      }
+    }
+
+    best= myodbc_min(best, latency_now() - start);
+  }
+
+  stmt_pool_flush(dbc);
+
+  sprintf(cell, "alloc/STMT_POOL=%u", pool);
+  printf("%-24s %10.1f %8lu\n", cell, (double)best / done, errors);
+
+  return errors;
+}
+
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [-n statements] [-r rounds] [-l live]\n",
+          name);
+}
+
+
+int main(int argc, char **argv)
+{
+  BENCH bench;
+  ulong errors;
+  int arg;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.statements= BENCH_STATEMENTS;
+  bench.rounds= BENCH_ROUNDS;
+  bench.live= BENCH_LIVE;
+
+  for (arg= 1; arg < argc; ++arg)
+  {
+    const char *value= arg + 1 < argc ? argv[arg + 1] : NULL;
+
+    if (!value || argv[arg][0] != '-' || !argv[arg][1] || argv[arg][2])
+    {
+      usage(argv[0]);
+      return 2;
+    }
+
+    switch (argv[arg][1])
+    {
+    case 'n': bench.statements= strtoul(value, NULL, 10); break;
+    case 'r': bench.rounds= (uint)strtoul(value, NULL, 10); break;
+    case 'l': bench.live= (uint)strtoul(value, NULL, 10); break;
+    default:
+      usage(argv[0]);
+      return 2;
+    }
+    ++arg;
+  }
+
+  if (!bench.statements || !bench.rounds || !bench.live)
+  {
+    usage(argv[0]);
+    return 2;
+  }
+
+  if (bench_init(&bench))
+  {
+    fprintf(stderr, "Cannot set up the driver handles\n");
+    bench_free(&bench);
+    return 2;
+  }
+
+  printf("%-24s %10s %8s\n", "cell", "ns/stmt", "errors");
+
+  /* Plain allocation, then the pool holding every statement alive */
+  errors= bench_run(&bench, 0);
+  errors+= bench_run(&bench, bench.live);
+
+  bench_free(&bench);
+
+  return errors ? 1 : 0;
+}
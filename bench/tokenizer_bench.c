@@ -0,0 +1,158 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  tokenizer_bench.c
+  @brief Offline benchmark of the tokenizer of the driver.
+
+  A large statement is generated, with the shapes the tokenizer has to care
+  about: quoted strings with escaped quotes and parameter markers in them,
+  comments of each style and a long list of values. It is then parsed with
+  parse(), as SQLPrepare() does, several rounds, and the best round is
+  reported as megabytes per second of the text of the statement. No server
+  is needed.
+
+  Usage: mdbodbc-bench-tokenizer [-s size] [-r rounds]
+*/
+
+#include "driver.h"
+
+#define BENCH_SIZE    (1024 * 1024)
+#define BENCH_ROUNDS  20
+
+
+/**
+  Build the statement, of at least size bytes. It has two parameter
+  markers, every other question mark being in a comment or a string.
+
+  @return The end of the statement
+*/
+static char *bench_query(char *query, size_t size)
+{
+  char *pos= query + sprintf(query, "SELECT /* ? */ CASE WHEN ? IN (");
+  int i;
+
+  for (i= 0; pos - query < (long)size; ++i)
+  {
+    pos+= sprintf(pos, i % 8 ? "%d, " : "\n  -1, '%d?', \"%d\\\"\", ",
+                  i, i);
+  }
+  pos+= sprintf(pos, "-2) THEN 'in ''list'' ?' ELSE \"no\" END, ? -- ?\n");
+
+  return pos;
+}
+
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [-s size] [-r rounds]\n", name);
+}
+
+
+int main(int argc, char **argv)
+{
+  MY_PARSED_QUERY pq;
+  size_t size= BENCH_SIZE;
+  uint rounds= BENCH_ROUNDS, round;
+  ulonglong best= ~(ulonglong)0, start;
+  char *query, *end;
+  int arg, status= 0;
+
+  for (arg= 1; arg < argc; ++arg)
+  {
+    const char *value= arg + 1 < argc ? argv[arg + 1] : NULL;
+
+    if (!value || argv[arg][0] != '-' || !argv[arg][1] || argv[arg][2])
+    {
+      usage(argv[0]);
+      return 2;
+    }
+
+    switch (argv[arg][1])
+    {
+    case 's': size= strtoul(value, NULL, 10); break;
+    case 'r': rounds= (uint)strtoul(value, NULL, 10); break;
+    default:
+      usage(argv[0]);
+      return 2;
+    }
+    ++arg;
+  }
+
+  if (!size || !rounds)
+  {
+    usage(argv[0]);
+    return 2;
+  }
+
+  myodbc_init();
+
+  /* Room for the last line of the list and for the end of the statement */
+  if (!(query= (char *)myodbc_malloc(size + 256, MYF(0))))
+  {
+    fprintf(stderr, "Out of memory\n");
+    myodbc_end();
+    return 2;
+  }
+  end= bench_query(query, size);
+  init_parsed_query(&pq);
+
+  for (round= 0; round < rounds; ++round)
+  {
+    /* The statement is not owned by the parsed query, so that it is not
+       freed when the query is reset */
+    pq.query= NULL;
+    reset_parsed_query(&pq, query, end, utf8_charset_info);
+
+    start= latency_now();
+    if (parse(&pq))
+    {
+      fprintf(stderr, "Cannot parse the statement\n");
+      status= 2;
+      break;
+    }
+    best= myodbc_min(best, latency_now() - start);
+  }
+
+  if (!status && PARAM_COUNT(&pq) != 2)
+  {
+    fprintf(stderr, "Found %u parameter markers instead of 2\n",
+            (uint)PARAM_COUNT(&pq));
+    status= 1;
+  }
+
+  if (!status)
+  {
+    printf("Parsed %u statements of %lu bytes, %u tokens: %.1f MB/s\n",
+           rounds, (ulong)(end - query), (uint)TOKEN_COUNT(&pq),
+           best ? (double)(end - query) * 1000.0 / (double)best : 0.0);
+  }
+
+  pq.query= NULL;
+  delete_parsed_query(&pq);
+  x_free(query);
+  myodbc_end();
+
+  return status;
+}
@@ -204,10 +204,12 @@ SQLColumns(SQLHSTMT hstmt, SQLCHAR *catalog, SQLSMALLINT catalog_len,
 {
   SQLRETURN rc;
   DBC *dbc;
+  ulonglong start;
 
   CHECK_HANDLE(hstmt);
 
   dbc= ((STMT *)hstmt)->dbc;
+  start= LATENCY_BEGIN(dbc->env);
 
   if (dbc->ansi_charset_info->number != dbc->cxn_charset_info->number)
   {
@@ -258,6 +260,7 @@ SQLColumns(SQLHSTMT hstmt, SQLCHAR *catalog, SQLSMALLINT catalog_len,
     x_free(column);
   }
 
+  LATENCY_END(dbc->env, LATENCY_COLUMNS, start);
   return rc;
 }
 
@@ -269,6 +272,7 @@ SQLConnect(SQLHDBC hdbc, SQLCHAR *dsn, SQLSMALLINT dsn_len_in,
 {
   uint errors;
   SQLRETURN rc;
+  ulonglong start= latency_now();
   SQLINTEGER dsn_len= dsn_len_in, user_len= user_len_in,
              auth_len= auth_len_in;
 
@@ -288,6 +292,8 @@ SQLConnect(SQLHDBC hdbc, SQLCHAR *dsn, SQLSMALLINT dsn_len_in,
   x_free(userw);
   x_free(authw);
 
+  /* Timed in any case, the connection may turn the statistics on */
+  LATENCY_END(((DBC *)hdbc)->env, LATENCY_CONNECT, start);
   return rc;
 }
 
@@ -362,6 +368,7 @@ SQLDriverConnect(SQLHDBC hdbc, SQLHWND hwnd, SQLCHAR *in, SQLSMALLINT in_len,
   SQLINTEGER inw_len;
   SQLWCHAR *inw;
   SQLSMALLINT outw_max, dummy_out;
+  ulonglong start= latency_now();
 
   CHECK_HANDLE(hdbc);
 
@@ -414,6 +421,8 @@ error:
   x_free(outw);
   x_free(inw);
 
+  /* Timed in any case, the connection may turn the statistics on */
+  LATENCY_END(((DBC *)hdbc)->env, LATENCY_DRIVER_CONNECT, start);
   return rc;
 }
 
@@ -452,13 +461,18 @@ SQLRETURN SQL_API
 SQLExecDirect(SQLHSTMT hstmt, SQLCHAR *str, SQLINTEGER str_len)
 {
   int error;
+  ENV *env;
+  ulonglong start;
   
   CHECK_HANDLE(hstmt);  
 
-  if ((error= SQLPrepareImpl(hstmt, str, str_len)))
-    return error;
-  error= my_SQLExecute((STMT *)hstmt);
+  env= ((STMT *)hstmt)->dbc->env;
+  start= LATENCY_BEGIN(env);
 
+  if (!(error= SQLPrepareImpl(hstmt, str, str_len)))
+    error= my_SQLExecute((STMT *)hstmt);
+
+  LATENCY_END(env, LATENCY_EXEC_DIRECT, start);
   return error;
 }
 
@@ -974,9 +988,19 @@ SQLNativeSql(SQLHDBC hdbc, SQLCHAR *in, SQLINTEGER in_len,
 SQLRETURN SQL_API
 SQLPrepare(SQLHSTMT hstmt, SQLCHAR *str, SQLINTEGER str_len)
 {
+  SQLRETURN rc;
+  ENV *env;
+  ulonglong start;
+
   CHECK_HANDLE(hstmt);
 
-  return SQLPrepareImpl(hstmt, str, str_len);
+  env= ((STMT *)hstmt)->dbc->env;
+  start= LATENCY_BEGIN(env);
+
+  rc= SQLPrepareImpl(hstmt, str, str_len);
+
+  LATENCY_END(env, LATENCY_PREPARE, start);
+  return rc;
 }
 
 
@@ -1488,10 +1512,12 @@ SQLTables(SQLHSTMT hstmt,
 {
   SQLRETURN rc;
   DBC *dbc;
+  ulonglong start;
 
   CHECK_HANDLE(hstmt);
 
   dbc= ((STMT *)hstmt)->dbc;
+  start= LATENCY_BEGIN(dbc->env);
 
   if (dbc->ansi_charset_info->number != dbc->cxn_charset_info->number)
   {
@@ -1551,6 +1577,7 @@ SQLTables(SQLHSTMT hstmt,
     x_free(type);
   }
 
+  LATENCY_END(dbc->env, LATENCY_TABLES, start);
   return rc;
 }
 
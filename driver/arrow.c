@@ -0,0 +1,752 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  arrow.c
+  @brief Columnar fetch of result sets as Apache Arrow record batches.
+
+  The rows are read with the same functions as SQLFetch(), but each value
+  goes straight into the buffers of its column instead of being converted
+  to the C type of an application buffer. The Arrow type of a column is
+  derived from its IRD record.
+
+  A TIME is a duration, which keeps the negative values and the ones of
+  24 hours and more that MySQL allows.
+*/
+
+#include "driver.h"
+#include "myodbc_arrow.h"
+
+enum arrow_kind
+{
+  ARROW_BOOL, ARROW_INT, ARROW_UINT, ARROW_FLOAT, ARROW_DOUBLE, ARROW_DATE,
+  ARROW_TIME, ARROW_TIMESTAMP, ARROW_STRING, ARROW_BINARY
+};
+
+typedef struct
+{
+  enum arrow_kind kind;
+  const char     *format;
+  uint            width;      /* bytes of a value, 0 for variable length */
+  CHARSET_INFO   *charset;    /* of a string to convert to utf8, or NULL */
+
+  uchar          *validity;
+  char           *data;
+  int32_t        *offsets;
+  size_t          data_used;
+  size_t          data_size;
+  int64_t         null_count;
+} ARROW_COLUMN;
+
+
+/**
+  Choose the Arrow type of a column from its IRD record. A string is
+  converted from the charset the server sent it in, which is the one of its
+  field and not always the one of the connection.
+*/
+static void arrow_column_type(DESCREC *irrec, ARROW_COLUMN *col)
+{
+  my_bool is_unsigned= irrec->is_unsigned == SQL_TRUE;
+  CHARSET_INFO *cs;
+
+  col->width= 0;
+
+  switch (irrec->concise_type)
+  {
+  case SQL_BIT:
+    col->kind= ARROW_BOOL;
+    col->format= "b";
+    return;
+  case SQL_TINYINT:
+    col->width= 1;
+    col->format= is_unsigned ? "C" : "c";
+    break;
+  case SQL_SMALLINT:
+    col->width= 2;
+    col->format= is_unsigned ? "S" : "s";
+    break;
+  case SQL_INTEGER:
+    col->width= 4;
+    col->format= is_unsigned ? "I" : "i";
+    break;
+  case SQL_BIGINT:
+    col->width= 8;
+    col->format= is_unsigned ? "L" : "l";
+    break;
+  case SQL_REAL:
+    col->kind= ARROW_FLOAT;
+    col->width= 4;
+    col->format= "f";
+    return;
+  case SQL_FLOAT:
+  case SQL_DOUBLE:
+    col->kind= ARROW_DOUBLE;
+    col->width= 8;
+    col->format= "g";
+    return;
+  case SQL_DATE:
+  case SQL_TYPE_DATE:
+    col->kind= ARROW_DATE;
+    col->width= 4;
+    col->format= "tdD";
+    return;
+  case SQL_TIME:
+  case SQL_TYPE_TIME:
+    col->kind= ARROW_TIME;
+    col->width= 8;
+    col->format= "tDu";
+    return;
+  case SQL_TIMESTAMP:
+  case SQL_TYPE_TIMESTAMP:
+    col->kind= ARROW_TIMESTAMP;
+    col->width= 8;
+    col->format= "tsu:";
+    return;
+  case SQL_BINARY:
+  case SQL_VARBINARY:
+  case SQL_LONGVARBINARY:
+    col->kind= ARROW_BINARY;
+    col->format= "z";
+    return;
+  default:
+    col->kind= ARROW_STRING;
+    col->format= "u";
+    cs= irrec->row.field ? get_charset(irrec->row.field->charsetnr, MYF(0))
+                         : NULL;
+    if (cs && cs->number != BINARY_CHARSET_NUMBER &&
+        myodbc_casecmp(cs->csname, "utf8", 4) &&
+        myodbc_strcasecmp(cs->csname, "ascii"))
+    {
+      col->charset= cs;
+    }
+    return;
+  }
+
+  col->kind= is_unsigned ? ARROW_UINT : ARROW_INT;
+}
+
+
+/**
+  Days since 1970-01-01 of a date of the proleptic Gregorian calendar.
+*/
+static int64_t arrow_days(int year, uint month, uint day)
+{
+  int64_t era, yoe, doy;
+
+  year-= month <= 2;
+  era= (year >= 0 ? year : year - 399) / 400;
+  yoe= year - era * 400;
+  doy= (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+
+  return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
+
+/**
+  Read a TIME value, [-]H+:MM:SS[.ffffff], as a number of microseconds.
+
+  @return TRUE if the value is not a valid time
+*/
+static my_bool arrow_time(const char *str, ulong length, int64_t *us)
+{
+  const char *end= str + length;
+  my_bool neg= FALSE;
+  int64_t hour= 0, minute, second, fraction= 0, scale= 100000;
+
+  if (str < end && *str == '-')
+  {
+    neg= TRUE;
+    ++str;
+  }
+
+  if (str == end || !isdigit(*str))
+  {
+    return TRUE;
+  }
+  while (str < end && isdigit(*str))
+  {
+    hour= hour * 10 + (*str++ - '0');
+    if (hour > 100000)
+    {
+      return TRUE;
+    }
+  }
+
+  if (end - str < 6 || str[0] != ':' || !isdigit(str[1]) ||
+      !isdigit(str[2]) || str[3] != ':' || !isdigit(str[4]) ||
+      !isdigit(str[5]))
+  {
+    return TRUE;
+  }
+  minute= (str[1] - '0') * 10 + (str[2] - '0');
+  second= (str[4] - '0') * 10 + (str[5] - '0');
+  str+= 6;
+
+  if (minute > 59 || second > 59)
+  {
+    return TRUE;
+  }
+
+  if (str < end && *str == '.')
+  {
+    for (++str; str < end && isdigit(*str); ++str, scale/= 10)
+    {
+      fraction+= (*str - '0') * scale;
+    }
+  }
+
+  if (str != end)
+  {
+    return TRUE;
+  }
+
+  *us= ((hour * 60 + minute) * 60 + second) * 1000000 + fraction;
+  if (neg)
+  {
+    *us= -*us;
+  }
+  return FALSE;
+}
+
+
+static my_bool arrow_reserve(ARROW_COLUMN *col, size_t size)
+{
+  char *data;
+  size_t new_size;
+
+  if (col->data_used + size <= col->data_size)
+  {
+    return FALSE;
+  }
+
+  /* Offsets are 32-bit */
+  if (col->data_used + size > INT_MAX32)
+  {
+    return TRUE;
+  }
+
+  new_size= myodbc_min(myodbc_max(col->data_size * 2, col->data_used + size),
+                       INT_MAX32);
+  if (!(data= (char *)myodbc_realloc(col->data, new_size,
+                                     MYF(MY_ALLOW_ZERO_PTR))))
+  {
+    return TRUE;
+  }
+
+  col->data= data;
+  col->data_size= new_size;
+  return FALSE;
+}
+
+
+/**
+  Add a value at the end of a column.
+
+  @return TRUE if out of memory
+*/
+static my_bool arrow_add_value(STMT *stmt, ARROW_COLUMN *col, uint column,
+                               char *value, ulong length, uint row)
+{
+  char as_string[50];
+  my_bool valid= !is_null(stmt, column, value);
+
+  if (valid)
+  {
+    switch (col->kind)
+    {
+    case ARROW_BOOL:
+      {
+        my_bool bit;
+
+        /* BIT values come as raw bytes */
+        if (desc_get_rec(stmt->ird, column, FALSE)->row.field->type ==
+            MYSQL_TYPE_BIT)
+        {
+          ulong i;
+          for (i= 0; i < length && !value[i]; ++i);
+          bit= i < length;
+        }
+        else
+        {
+          bit= get_int64(stmt, column, value, length) != 0;
+        }
+
+        if (bit)
+        {
+          ((uchar *)col->data)[row / 8]|= (uchar)(1 << (row % 8));
+        }
+      }
+      break;
+
+    case ARROW_INT:
+    case ARROW_UINT:
+      {
+        ulonglong v= col->kind == ARROW_UINT && !ssps_used(stmt) ?
+                     strtoull(value, NULL, 10) :
+                     (ulonglong)get_int64(stmt, column, value, length);
+        char *to= col->data + (size_t)row * col->width;
+
+        switch (col->width)
+        {
+        case 1: *(int8_t *)to= (int8_t)v;   break;
+        case 2: *(int16_t *)to= (int16_t)v; break;
+        case 4: *(int32_t *)to= (int32_t)v; break;
+        default: *(int64_t *)to= (int64_t)v;
+        }
+      }
+      break;
+
+    case ARROW_FLOAT:
+      ((float *)col->data)[row]= (float)get_double(stmt, column, value, length);
+      break;
+
+    case ARROW_DOUBLE:
+      ((double *)col->data)[row]= (double)get_double(stmt, column, value,
+                                                     length);
+      break;
+
+    case ARROW_DATE:
+    case ARROW_TIMESTAMP:
+      {
+        SQL_TIMESTAMP_STRUCT ts;
+
+        if ((valid= !get_timestamp(stmt, column, value, length, &ts,
+                                   as_string)))
+        {
+          int64_t days= arrow_days(ts.year, ts.month, ts.day);
+
+          if (col->kind == ARROW_DATE)
+          {
+            ((int32_t *)col->data)[row]= (int32_t)days;
+          }
+          else
+          {
+            ((int64_t *)col->data)[row]=
+              ((days * 24 + ts.hour) * 60 + ts.minute) * 60000000LL +
+              ts.second * 1000000LL + ts.fraction / 1000;
+          }
+        }
+      }
+      break;
+
+    case ARROW_TIME:
+      value= get_string(stmt, column, value, &length, as_string);
+      valid= !arrow_time(value, length, (int64_t *)col->data + row);
+      break;
+
+    case ARROW_STRING:
+    case ARROW_BINARY:
+      value= get_string(stmt, column, value, &length, as_string);
+
+      if (col->charset)
+      {
+        uint32 used_bytes, used_chars;
+        uint errors= 0;
+
+        if (arrow_reserve(col, (size_t)length * utf8_charset_info->mbmaxlen))
+        {
+          return TRUE;
+        }
+        col->data_used+= copy_and_convert(col->data + col->data_used,
+                                          (uint32)(col->data_size -
+                                                   col->data_used),
+                                          utf8_charset_info, value, length,
+                                          col->charset,
+                                          &used_bytes, &used_chars, &errors);
+      }
+      else
+      {
+        if (arrow_reserve(col, length))
+        {
+          return TRUE;
+        }
+        memcpy(col->data + col->data_used, value, length);
+        col->data_used+= length;
+      }
+      break;
+    }
+  }
+
+  if (col->offsets)
+  {
+    col->offsets[row + 1]= (int32_t)col->data_used;
+  }
+
+  if (valid)
+  {
+    col->validity[row / 8]|= (uchar)(1 << (row % 8));
+  }
+  else
+  {
+    ++col->null_count;
+  }
+
+  return FALSE;
+}
+
+
+static void arrow_release_child_array(struct ArrowArray *array)
+{
+  int64_t i;
+
+  for (i= 0; i < array->n_buffers; ++i)
+  {
+    x_free((void *)array->buffers[i]);
+  }
+  x_free(array->private_data);
+  array->release= NULL;
+}
+
+
+static void arrow_release_array(struct ArrowArray *array)
+{
+  int64_t i;
+
+  for (i= 0; i < array->n_children; ++i)
+  {
+    if (array->children[i]->release)
+    {
+      array->children[i]->release(array->children[i]);
+    }
+  }
+  x_free(array->private_data);
+  array->release= NULL;
+}
+
+
+static void arrow_release_child_schema(struct ArrowSchema *schema)
+{
+  x_free(schema->private_data);
+  schema->release= NULL;
+}
+
+
+static void arrow_release_schema(struct ArrowSchema *schema)
+{
+  int64_t i;
+
+  for (i= 0; i < schema->n_children; ++i)
+  {
+    if (schema->children[i]->release)
+    {
+      schema->children[i]->release(schema->children[i]);
+    }
+  }
+  x_free(schema->private_data);
+  schema->release= NULL;
+}
+
+
+static void arrow_free_columns(ARROW_COLUMN *cols, uint count)
+{
+  uint i;
+
+  for (i= 0; i < count; ++i)
+  {
+    x_free(cols[i].validity);
+    x_free(cols[i].data);
+    x_free(cols[i].offsets);
+  }
+  x_free(cols);
+}
+
+
+/**
+  Move the buffers of the columns into the Arrow structures.
+
+  @return TRUE if out of memory, with the columns left to the caller
+*/
+static my_bool arrow_export(STMT *stmt, ARROW_COLUMN *cols, uint count,
+                            int64_t rows, struct ArrowSchema *schema,
+                            struct ArrowArray *array)
+{
+  struct ArrowArray *arrays;
+  struct ArrowSchema *schemas;
+  const void **buffers;
+  char *name;
+  uint i;
+
+  arrays= (struct ArrowArray *)myodbc_malloc(count *
+                                             (sizeof(struct ArrowArray) +
+                                              sizeof(struct ArrowArray *)) +
+                                             sizeof(void *),
+                                             MYF(MY_ZEROFILL));
+  schemas= (struct ArrowSchema *)myodbc_malloc(count *
+                                               (sizeof(struct ArrowSchema) +
+                                                sizeof(struct ArrowSchema *)),
+                                               MYF(MY_ZEROFILL));
+  if (!arrays || !schemas)
+  {
+    x_free(arrays);
+    x_free(schemas);
+    return TRUE;
+  }
+
+  memset(schema, 0, sizeof(*schema));
+  schema->format= "+s";
+  schema->name= "";
+  schema->n_children= count;
+  schema->children= (struct ArrowSchema **)(schemas + count);
+  schema->release= arrow_release_schema;
+  schema->private_data= schemas;
+
+  memset(array, 0, sizeof(*array));
+  array->length= rows;
+  array->n_buffers= 1;
+  array->n_children= count;
+  array->children= (struct ArrowArray **)(arrays + count);
+  array->buffers= (const void **)(array->children + count);
+  array->release= arrow_release_array;
+  array->private_data= arrays;
+
+  for (i= 0; i < count; ++i)
+  {
+    DESCREC *irrec= desc_get_rec(stmt->ird, i, FALSE);
+
+    schema->children[i]= &schemas[i];
+    name= myodbc_strdup(irrec->name ? (char *)irrec->name : "", MYF(0));
+    buffers= (const void **)myodbc_malloc(3 * sizeof(void *),
+                                          MYF(MY_ZEROFILL));
+    if (!name || !buffers)
+    {
+      x_free(name);
+      x_free(buffers);
+      break;
+    }
+
+    schemas[i].format= cols[i].format;
+    schemas[i].name= name;
+    schemas[i].flags= irrec->nullable != SQL_NO_NULLS ? ARROW_FLAG_NULLABLE
+                                                      : 0;
+    schemas[i].release= arrow_release_child_schema;
+    schemas[i].private_data= name;
+
+    array->children[i]= &arrays[i];
+    arrays[i].length= rows;
+    arrays[i].null_count= cols[i].null_count;
+    arrays[i].buffers= buffers;
+    arrays[i].release= arrow_release_child_array;
+    arrays[i].private_data= buffers;
+
+    if (!cols[i].null_count)
+    {
+      x_free(cols[i].validity);
+    }
+    buffers[0]= cols[i].null_count ? cols[i].validity : NULL;
+
+    if (cols[i].offsets)
+    {
+      arrays[i].n_buffers= 3;
+      buffers[1]= cols[i].offsets;
+      buffers[2]= cols[i].data;
+    }
+    else
+    {
+      arrays[i].n_buffers= 2;
+      buffers[1]= cols[i].data;
+    }
+    cols[i].validity= NULL;
+    cols[i].offsets= NULL;
+    cols[i].data= NULL;
+  }
+
+  if (i < count)
+  {
+    /* The moved buffers go with the children already set up */
+    schema->n_children= array->n_children= i;
+    schema->release(schema);
+    array->release(array);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+
+/**
+  Fetch the next rows of the result of a statement as an Arrow batch.
+*/
+SQLRETURN arrow_fetch(STMT *stmt, struct ArrowSchema *schema,
+                      struct ArrowArray *array)
+{
+  SQLULEN batch= stmt->stmt_options.arrow_batch_size ?
+                 stmt->stmt_options.arrow_batch_size :
+                 MYODBC_ARROW_DEFAULT_BATCH_SIZE;
+  ARROW_COLUMN *cols;
+  MYSQL_ROW values= NULL;
+  uint count, i;
+  SQLULEN rows;
+  long cur_row;
+
+  if (!schema || !array)
+  {
+    return set_error(stmt, MYERR_S1009, NULL, 0);
+  }
+
+  if (!stmt->result)
+  {
+    return set_stmt_error(stmt, "24000", "Fetch without a SELECT", 0);
+  }
+
+  if (stmt->result_array || stmt->fix_fields ||
+      stmt->out_params_state != OPS_UNKNOWN || scroller_exists(stmt) ||
+      if_dynamic_cursor(stmt))
+  {
+    return set_error(stmt, MYERR_S1C00,
+                     "Arrow fetch is not supported for this result set", 0);
+  }
+
+  count= stmt->result->field_count;
+  cur_row= stmt->current_row < 0 ? 0 :
+           stmt->current_row + stmt->rows_found_in_set;
+
+  if (!if_forward_cache(stmt))
+  {
+    if ((my_ulonglong)cur_row >= num_rows(stmt))
+    {
+      stmt->rows_found_in_set= 0;
+      return SQL_NO_DATA_FOUND;
+    }
+    batch= myodbc_min(batch, (SQLULEN)(num_rows(stmt) - cur_row));
+    data_seek(stmt, cur_row);
+  }
+
+  cols= (ARROW_COLUMN *)myodbc_malloc(sizeof(ARROW_COLUMN) * count,
+                                      MYF(MY_ZEROFILL));
+  if (!cols)
+  {
+    return set_error(stmt, MYERR_S1001, NULL, 4001);
+  }
+
+  for (i= 0; i < count; ++i)
+  {
+    ARROW_COLUMN *col= &cols[i];
+    size_t size;
+
+    arrow_column_type(desc_get_rec(stmt->ird, i, FALSE), col);
+
+    if (col->kind == ARROW_BOOL)
+    {
+      size= (batch + 7) / 8;
+    }
+    else if (col->width)
+    {
+      size= (size_t)batch * col->width;
+    }
+    else
+    {
+      size= 0;
+      col->offsets= (int32_t *)myodbc_malloc(sizeof(int32_t) * (batch + 1),
+                                             MYF(MY_ZEROFILL));
+    }
+
+    col->validity= (uchar *)myodbc_malloc((batch + 7) / 8, MYF(MY_ZEROFILL));
+    if (size)
+    {
+      col->data= (char *)myodbc_malloc(size, MYF(MY_ZEROFILL));
+      col->data_size= size;
+    }
+
+    if (!col->validity || (size && !col->data) ||
+        (!col->width && col->kind != ARROW_BOOL && !col->offsets))
+    {
+      arrow_free_columns(cols, count);
+      return set_error(stmt, MYERR_S1001, NULL, 4001);
+    }
+  }
+
+  if (!stmt->dbc->ds->dont_use_set_locale)
+  {
+    setlocale(LC_NUMERIC, "C");
+  }
+
+  for (rows= 0; rows < batch && (values= fetch_row(stmt)); ++rows)
+  {
+    ulong *lengths= fetch_lengths(stmt);
+
+    for (i= 0; i < count; ++i)
+    {
+      if (arrow_add_value(stmt, &cols[i], i, values[i],
+                          lengths ? lengths[i] : 0, (uint)rows))
+      {
+        break;
+      }
+    }
+    if (i < count)
+    {
+      break;
+    }
+  }
+
+  if (!stmt->dbc->ds->dont_use_set_locale)
+  {
+    setlocale(LC_NUMERIC, default_locale);
+  }
+
+  reset_getdata_position(stmt);
+  stmt->current_values= NULL;
+  stmt->current_row= cur_row;
+  stmt->rows_found_in_set= (uint)rows;
+
+  if (stmt->ird->rows_processed_ptr)
+  {
+    *stmt->ird->rows_processed_ptr= rows;
+  }
+
+  if (rows < batch && values)
+  {
+    arrow_free_columns(cols, count);
+    return set_error(stmt, MYERR_S1001, NULL, 4001);
+  }
+
+  if (!rows)
+  {
+    arrow_free_columns(cols, count);
+    return SQL_NO_DATA_FOUND;
+  }
+
+  if (arrow_export(stmt, cols, count, (int64_t)rows, schema, array))
+  {
+    arrow_free_columns(cols, count);
+    return set_error(stmt, MYERR_S1001, NULL, 4001);
+  }
+
+  arrow_free_columns(cols, count);
+  return SQL_SUCCESS;
+}
+
+
+/**
+  Exported entry point of the columnar fetch.
+*/
+SQLRETURN SQL_API MYODBCFetchArrow(SQLHSTMT hstmt, struct ArrowSchema *schema,
+                                   struct ArrowArray *array)
+{
+  STMT *stmt= (STMT *)hstmt;
+
+  CHECK_HANDLE(hstmt);
+  CLEAR_STMT_ERROR(stmt);
+
+  return arrow_fetch(stmt, schema, array);
+}
@@ -0,0 +1,315 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  catalog_fanout.c
+  @brief Per-table catalog queries spread over auxiliary connections.
+
+  With CATALOG_THREADS set, the catalog functions that have to send one
+  query per table open up to that many extra connections to the same data
+  source, and run the queries on them from the environment worker pool.
+  The connections are kept with the DBC until it is disconnected.
+*/
+
+#include "driver.h"
+
+struct st_catalog_fanout
+{
+  DBC  *conns[CATALOG_FANOUT_MAX];
+  uint  count;
+};
+
+
+typedef struct
+{
+  DBC                *aux;
+  const char         *catalog;
+  catalog_fanout_func func;
+  void               *arg;
+  MYSQL_RES         **results;
+  uint                first;      /* first index of the task */
+  uint                step;       /* distance between indexes of the task */
+  uint                count;      /* number of indexes of all the tasks */
+
+  /* error of the first query that failed */
+  my_bool             failed;
+  char                sqlstate[6];
+  char                message[SQL_MAX_MESSAGE_LENGTH + 1];
+  uint                native_error;
+} FANOUT_TASK;
+
+
+/**
+  Open an auxiliary connection with the data source of a connection.
+
+  @return The connection, or NULL if it could not be established
+*/
+static DBC *fanout_connect(DBC *dbc)
+{
+  SQLHDBC hdbc;
+  DBC *aux;
+  DataSource *ds;
+  SQLWCHAR *attrs;
+  size_t attrs_len= ds_to_kvpair_len(dbc->ds) + 1;
+
+  if (!SQL_SUCCEEDED(my_SQLAllocConnect((SQLHENV)dbc->env, &hdbc)))
+  {
+    return NULL;
+  }
+  aux= (DBC *)hdbc;
+  aux->unicode= dbc->unicode;
+
+  /* The copy of the data source goes through its connection string */
+  attrs= (SQLWCHAR *)myodbc_malloc(attrs_len * sizeof(SQLWCHAR), MYF(0));
+  ds= ds_new();
+
+  if (!attrs || !ds || ds_to_kvpair(dbc->ds, attrs, attrs_len, ';') < 0 ||
+      ds_from_kvpair(ds, attrs, ';'))
+  {
+    x_free(attrs);
+    if (ds)
+    {
+      ds_delete(ds);
+    }
+    my_SQLFreeConnect(hdbc);
+    return NULL;
+  }
+  x_free(attrs);
+
+  /* Auxiliary connections never fan out themselves */
+  ds->catalog_threads= 0;
+
+  if (!SQL_SUCCEEDED(myodbc_do_connect(aux, ds)))
+  {
+    if (!aux->ds)
+    {
+      ds_delete(ds);
+    }
+    my_SQLFreeConnect(hdbc);
+    return NULL;
+  }
+
+  return aux;
+}
+
+
+/**
+  Get the auxiliary connections of a connection, opening the missing ones.
+  A later call may want more connections than the first one, up to
+  CATALOG_FANOUT_MAX.
+
+  @return Number of auxiliary connections available
+*/
+static uint fanout_open(DBC *dbc, uint wanted)
+{
+  struct st_catalog_fanout *fanout= dbc->fanout;
+
+  if (!fanout)
+  {
+    fanout= (struct st_catalog_fanout *)
+      myodbc_malloc(sizeof(struct st_catalog_fanout), MYF(MY_ZEROFILL));
+    if (!fanout)
+    {
+      return 0;
+    }
+    dbc->fanout= fanout;
+  }
+
+  wanted= myodbc_min(wanted, CATALOG_FANOUT_MAX);
+
+  /* A failure leaves the work to the connections already opened */
+  while (fanout->count < wanted)
+  {
+    DBC *aux= fanout_connect(dbc);
+
+    if (!aux)
+    {
+      break;
+    }
+    fanout->conns[fanout->count++]= aux;
+  }
+
+  return fanout->count;
+}
+
+
+/**
+  Close the auxiliary connections of a connection.
+*/
+void catalog_fanout_close(DBC *dbc)
+{
+  uint i;
+
+  if (!dbc->fanout)
+  {
+    return;
+  }
+
+  for (i= 0; i < dbc->fanout->count; ++i)
+  {
+    SQLDisconnect((SQLHDBC)dbc->fanout->conns[i]);
+    my_SQLFreeConnect((SQLHDBC)dbc->fanout->conns[i]);
+  }
+
+  x_free(dbc->fanout);
+  dbc->fanout= NULL;
+}
+
+
+static void fanout_task_error(FANOUT_TASK *task, MYSQL *mysql)
+{
+  task->failed= TRUE;
+  strmake(task->sqlstate, mysql_sqlstate(mysql), sizeof(task->sqlstate) - 1);
+  strmake(task->message, mysql_error(mysql), sizeof(task->message) - 1);
+  task->native_error= mysql_errno(mysql);
+}
+
+
+static void fanout_task(void *arg)
+{
+  FANOUT_TASK *task= (FANOUT_TASK *)arg;
+  MYSQL *mysql= &task->aux->mysql;
+  uint index;
+
+  if (task->catalog && mysql_select_db(mysql, task->catalog))
+  {
+    fanout_task_error(task, mysql);
+    return;
+  }
+
+  for (index= task->first; index < task->count; index+= task->step)
+  {
+    task->results[index]= task->func(mysql, task->arg, index);
+
+    if (!task->results[index] && mysql_errno(mysql))
+    {
+      fanout_task_error(task, mysql);
+      return;
+    }
+  }
+}
+
+
+/**
+  Run per-table catalog queries on the auxiliary connections.
+
+  @param[in]  stmt     Statement of the catalog function
+  @param[in]  catalog  Catalog the queries are about, NULL for the current
+                       catalog of the connection
+  @param[in]  count    Number of queries
+  @param[in]  func     Function sending the query of an index and
+                       returning its result, or NULL with the error set in
+                       the connection
+  @param[in]  arg      Argument passed to func
+  @param[out] results  Results of the queries, by index
+
+  @return SQL_SUCCESS, SQL_ERROR with the error in the statement and no
+          result kept if a query failed, or SQL_NO_DATA if no auxiliary
+          connection could be used, so that the caller runs the queries
+          itself.
+*/
+SQLRETURN catalog_fanout_run(STMT *stmt, const char *catalog, uint count,
+                             catalog_fanout_func func, void *arg,
+                             MYSQL_RES **results)
+{
+  DBC *dbc= stmt->dbc;
+  uint threads= myodbc_min(dbc->ds->catalog_threads, CATALOG_FANOUT_MAX);
+  FANOUT_TASK *tasks;
+  SQLRETURN rc= SQL_SUCCESS;
+  uint conns, i;
+
+  if (threads < 2 || count < 2)
+  {
+    return SQL_NO_DATA;
+  }
+
+  /* The auxiliary connections follow the catalog of the application */
+  if (!catalog)
+  {
+    if (reget_current_catalog(dbc))
+    {
+      return handle_connection_error(stmt);
+    }
+    catalog= dbc->database;
+  }
+
+  conns= fanout_open(dbc, myodbc_min(threads, count));
+  if (!conns)
+  {
+    return SQL_NO_DATA;
+  }
+
+  tasks= (FANOUT_TASK *)myodbc_malloc(sizeof(FANOUT_TASK) * conns,
+                                      MYF(MY_ZEROFILL));
+  if (!tasks)
+  {
+    set_mem_error(&dbc->mysql);
+    return handle_connection_error(stmt);
+  }
+
+  memset(results, 0, sizeof(MYSQL_RES *) * count);
+
+  for (i= 0; i < conns; ++i)
+  {
+    tasks[i].aux= dbc->fanout->conns[i];
+    tasks[i].catalog= catalog;
+    tasks[i].func= func;
+    tasks[i].arg= arg;
+    tasks[i].results= results;
+    tasks[i].first= i;
+    tasks[i].step= conns;
+    tasks[i].count= count;
+  }
+
+  workers_run(env_get_workers(dbc->env, conns - 1), fanout_task, tasks,
+              sizeof(FANOUT_TASK), conns);
+
+  for (i= 0; i < conns; ++i)
+  {
+    if (tasks[i].failed)
+    {
+      rc= set_stmt_error(stmt, tasks[i].sqlstate, tasks[i].message,
+                         tasks[i].native_error);
+      break;
+    }
+  }
+
+  if (rc != SQL_SUCCESS)
+  {
+    for (i= 0; i < count; ++i)
+    {
+      if (results[i])
+      {
+        mysql_free_result(results[i]);
+        results[i]= NULL;
+      }
+    }
+
+    /* The connections may be lost, they are opened again next time */
+    catalog_fanout_close(dbc);
+  }
+
+  x_free(tasks);
+  return rc;
+}
@@ -239,6 +239,575 @@ server_list_dbcolumns(STMT *stmt,
 }
 
 
+/**
+  Fill a row of the SQLColumns result from the description of a column.
+
+  @param[in]  stmt       Statement, its alloc_root keeps the values
+  @param[out] row        Row to fill
+  @param[in]  field      Description of the column
+  @param[in]  def        Default value of the column, NULL if none
+  @param[in]  db         Catalog of the table
+  @param[in]  position   Position of the column in the result for the table
+  @param[in]  is_access  Whether the application is MS Access
+*/
+static void fill_columns_row(STMT *stmt, MYSQL_ROW row, MYSQL_FIELD *field,
+                             const char *def, char *db, int position,
+                             BOOL is_access)
+{
+  SQLSMALLINT type;
+  char buff[255]; /* @todo justify the size of this buffer */
+  MEM_ROOT *alloc= &stmt->alloc_root;
+
+  row[0]= db;                     /* TABLE_CAT */
+  row[1]= NULL;                   /* TABLE_SCHEM */
+  row[2]= strdup_root(alloc, field->table); /* TABLE_NAME */
+  row[3]= strdup_root(alloc, field->name);  /* COLUMN_NAME */
+
+  type= get_sql_data_type(stmt, field, buff);
+
+  row[5]= strdup_root(alloc, buff); /* TYPE_NAME */
+
+  sprintf(buff, "%d", type);
+  row[4]= strdup_root(alloc, buff); /* DATA_TYPE */
+
+  if (type == SQL_TYPE_DATE || type == SQL_TYPE_TIME ||
+      type == SQL_TYPE_TIMESTAMP)
+  {
+    row[14]= row[4];    /* SQL_DATETIME_SUB */
+    sprintf(buff, "%d", SQL_DATETIME);
+    row[13]= strdup_root(alloc, buff); /* SQL_DATA_TYPE */
+  }
+  else
+  {
+    row[13]= row[4];    /* SQL_DATA_TYPE */
+    row[14]= NULL;      /* SQL_DATETIME_SUB */
+  }
+
+  /* COLUMN_SIZE */
+  fill_column_size_buff(buff, stmt, field);
+  row[6]= strdup_root(alloc, buff);
+
+  /* BUFFER_LENGTH */
+  sprintf(buff, "%ld", get_transfer_octet_length(stmt, field));
+  row[7]= strdup_root(alloc, buff);
+
+  if (is_char_sql_type(type) || is_wchar_sql_type(type) ||
+      is_binary_sql_type(type))
+  {
+    row[15]= strdup_root(alloc, buff); /* CHAR_OCTET_LENGTH */
+  }
+  else
+  {
+    row[15]= NULL;                     /* CHAR_OCTET_LENGTH */
+  }
+
+  {
+    SQLSMALLINT digits= get_decimal_digits(stmt, field);
+    if (digits != SQL_NO_TOTAL)
+    {
+      sprintf(buff, "%d", digits);
+      row[8]= strdup_root(alloc, buff);  /* DECIMAL_DIGITS */
+      row[9]= "10";                      /* NUM_PREC_RADIX */
+    }
+    else
+    {
+      row[8]= row[9]= NullS;             /* DECIMAL_DIGITS, NUM_PREC_RADIX */
+    }
+  }
+
+  /*
+    If a field is a TIMESTAMP, NULL can be stored to it (although it gets turned into
+    something else).
+
+    The same logic applies to fields with AUTO_INCREMENT_FLAG set.
+  */
+  if ((field->flags & NOT_NULL_FLAG) && !(field->type == MYSQL_TYPE_TIMESTAMP) &&
+      !(field->flags & AUTO_INCREMENT_FLAG))
+  {
+    /* Bug#31067. Access seems to try to put NULL value when not null field
+       is cleared. And that contradicts with its knowledge of that the field
+       is not nullable, and it yields an error. Here is a little trick for
+       such case - we don't tell Access the whole truth we know, and
+       return for such field SQL_NULLABLE_UNKNOWN instead*/
+    if (is_access)
+    {
+      sprintf(buff, "%d", SQL_NULLABLE_UNKNOWN);
+      row[10]= strdup_root(alloc, buff); /* NULLABLE */
+      row[17]= strdup_root(alloc, "NO");/* IS_NULLABLE */
+    }
+    else
+    {
+      sprintf(buff, "%d", SQL_NO_NULLS);
+      row[10]= strdup_root(alloc, buff); /* NULLABLE */
+      row[17]= strdup_root(alloc, "NO"); /* IS_NULLABLE */
+    }
+  }
+  else
+  {
+    sprintf(buff, "%d", SQL_NULLABLE);
+    row[10]= strdup_root(alloc, buff); /* NULLABLE */
+    row[17]= strdup_root(alloc, "YES");/* IS_NULLABLE */
+  }
+
+  row[11]= ""; /* REMARKS */
+
+  /*
+    The default value of the column. The value in this column should be
+    interpreted as a string if it is enclosed in quotation marks.
+
+    if NULL was specified as the default value, then this column is the
+    word NULL, not enclosed in quotation marks. If the default value
+    cannot be represented without truncation, then this column contains
+    TRUNCATED, with no enclosing single quotation marks. If no default
+    value was specified, then this column is NULL.
+
+    The value of COLUMN_DEF can be used in generating a new column
+    definition, except when it contains the value TRUNCATED
+  */
+  if (!def)
+    row[12]= NullS; /* COLUMN_DEF */
+  else
+  {
+    if (field->type == MYSQL_TYPE_TIMESTAMP &&
+        !strcmp(def,"0000-00-00 00:00:00"))
+    {
+      row[12]= NullS; /* COLUMN_DEF */
+    }
+    else
+    {
+      char *column_def= alloc_root(alloc, strlen(def) + 3);
+      if (is_numeric_mysql_type(field))
+      {
+        sprintf(column_def, "%s", def);
+      }
+      else
+      {
+        sprintf(column_def, "'%s'", def);
+      }
+      row[12]= column_def; /* COLUMN_DEF */
+    }
+  }
+
+  sprintf(buff, "%d", position);
+  row[16]= strdup_root(alloc, buff); /* ORDINAL_POSITION */
+}
+
+
+/**
+  Free the prefetched catalog results not used, and their array.
+*/
+static void free_catalog_results(MYSQL_RES **results, uint count)
+{
+  uint i;
+
+  if (!results)
+    return;
+
+  for (i= 0; i < count; ++i)
+  {
+    if (results[i])
+      mysql_free_result(results[i]);
+  }
+
+  x_free(results);
+}
+
+
+/* Tables of a catalog function whose queries are fanned out */
+typedef struct
+{
+  char          **names;
+  unsigned long  *lengths;
+  const char     *column;   /* pattern of column names, for SQLColumns */
+} FANOUT_TABLES;
+
+
+static MYSQL_RES *fanout_list_fields(MYSQL *mysql, void *arg, uint index)
+{
+  FANOUT_TABLES *tables= (FANOUT_TABLES *)arg;
+
+  return mysql_list_fields(mysql, tables->names[index], tables->column);
+}
+
+
+static MYSQL_RES *fanout_show_create_table(MYSQL *mysql, void *arg,
+                                           uint index)
+{
+  FANOUT_TABLES *tables= (FANOUT_TABLES *)arg;
+  char buff[36 + 2*NAME_LEN + 1], *to;
+
+  to= myodbc_stpmov(buff, "SHOW CREATE TABLE `");
+  to+= myodbc_escape_string(mysql, to, (ulong)(sizeof(buff) - (to - buff)),
+                            tables->names[index],
+                            (ulong)tables->lengths[index], 1);
+  to= myodbc_stpmov(to, "`");
+
+  if (mysql_real_query(mysql, buff, (unsigned long)(to - buff)))
+  {
+    return NULL;
+  }
+
+  return mysql_store_result(mysql);
+}
+
+
+/**
+  Run a query per table of a list of tables on the auxiliary connections
+  of the statement's connection (CATALOG_THREADS).
+
+  @param[in]  stmt         Statement
+  @param[in]  tables       Tables, in the first column; the result is
+                           rewound for the caller
+  @param[in]  catalog      Catalog of the tables, NULL for the current one
+  @param[in]  catalog_len  Length of catalog
+  @param[in]  func         Query of a table
+  @param[in]  column       Pattern of column names, for func
+  @param[out] results      Results of the queries, in the order of tables,
+                           to be freed with x_free() once the results are
+                           taken
+
+  @return SQL_SUCCESS, SQL_ERROR, or SQL_NO_DATA if the caller has to run
+          the queries itself
+*/
+static SQLRETURN fanout_tables(STMT *stmt, MYSQL_RES *tables,
+                               SQLCHAR *catalog, SQLSMALLINT catalog_len,
+                               catalog_fanout_func func, const char *column,
+                               MYSQL_RES ***results)
+{
+  uint count= (uint)mysql_num_rows(tables), i;
+  char catalog_buff[NAME_LEN + 1];
+  FANOUT_TABLES arg;
+  MYSQL_ROW row;
+  SQLRETURN rc;
+
+  *results= NULL;
+
+  if (stmt->dbc->ds->catalog_threads < 2 || count < 2)
+  {
+    return SQL_NO_DATA;
+  }
+
+  arg.names= (char **)myodbc_malloc(sizeof(char *) * count, MYF(0));
+  arg.lengths= (unsigned long *)myodbc_malloc(sizeof(unsigned long) * count,
+                                              MYF(0));
+  arg.column= column;
+  *results= (MYSQL_RES **)myodbc_malloc(sizeof(MYSQL_RES *) * count, MYF(0));
+
+  if (!arg.names || !arg.lengths || !*results)
+  {
+    x_free(arg.names);
+    x_free(arg.lengths);
+    x_free(*results);
+    *results= NULL;
+    set_mem_error(&stmt->dbc->mysql);
+    return handle_connection_error(stmt);
+  }
+
+  for (i= 0; i < count && (row= mysql_fetch_row(tables)); ++i)
+  {
+    arg.names[i]= row[0];
+    arg.lengths[i]= mysql_fetch_lengths(tables)[0];
+  }
+
+  if (catalog_len)
+  {
+    strmake(catalog_buff, (char *)catalog,
+            myodbc_min((uint)catalog_len, NAME_LEN));
+  }
+
+  rc= catalog_fanout_run(stmt, catalog_len ? catalog_buff : NULL, i, func,
+                         &arg, *results);
+
+  x_free(arg.names);
+  x_free(arg.lengths);
+
+  if (rc != SQL_SUCCESS)
+  {
+    x_free(*results);
+    *results= NULL;
+  }
+
+  mysql_data_seek(tables, 0);
+  return rc;
+}
+
+
+/**
+  Run several catalog queries in one round trip, as a multi-statement,
+  and store their results.
+
+  Multiple statements are enabled for the time of the call if the
+  connection does not allow them already.
+
+  The server stops at the first query that fails, the results of the
+  queries before it are stored all the same.
+
+  @param[in]  stmt     Statement
+  @param[in]  query    Queries separated by ';'
+  @param[out] results  Results of the queries
+  @param[in]  count    Number of queries
+  @param[out] stored   Number of results stored, to be freed by the caller
+
+  @return SQL_SUCCESS if each query returned a result, SQL_ERROR with the
+          error set in the statement otherwise
+*/
+static SQLRETURN catalog_batch_run(STMT *stmt, DYNAMIC_STRING *query,
+                                   MYSQL_RES **results, uint count,
+                                   uint *stored)
+{
+  DBC *dbc= stmt->dbc;
+  MYSQL *mysql= &dbc->mysql;
+  my_bool multi_off= !dbc->ds->allow_multiple_statements;
+  SQLRETURN rc= SQL_SUCCESS;
+  uint i= 0;
+
+  *stored= 0;
+  myodbc_mutex_lock(&dbc->lock);
+
+  if (multi_off &&
+      mysql_set_server_option(mysql, MYSQL_OPTION_MULTI_STATEMENTS_ON))
+  {
+    rc= handle_connection_error(stmt);
+    myodbc_mutex_unlock(&dbc->lock);
+    return rc;
+  }
+
+  MYLOG_QUERY(stmt, query->str);
+
+  if (!mysql_real_query(mysql, query->str, query->length))
+  {
+    do
+    {
+      MYSQL_RES *res= mysql_store_result(mysql);
+
+      if (res && i < count)
+      {
+        results[i++]= res;
+      }
+      else if (res)
+      {
+        mysql_free_result(res);
+      }
+    } while (!mysql_next_result(mysql));
+  }
+
+  if (i < count)
+  {
+    rc= handle_connection_error(stmt);
+    if (rc == SQL_SUCCESS)
+    {
+      rc= set_stmt_error(stmt, "HY000", "Missing result in catalog batch", 0);
+    }
+  }
+  *stored= i;
+
+  if (multi_off)
+  {
+    mysql_set_server_option(mysql, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+  }
+
+  myodbc_mutex_unlock(&dbc->lock);
+  return rc;
+}
+
+
+/**
+  Append to a batch the queries getting the columns of a table: the
+  description of the columns as in a result, and their default values.
+
+  @param[in]  mysql        Connection
+  @param[out] query        Batch of queries
+  @param[in]  catalog      Catalog of the table, NULL for the current one
+  @param[in]  catalog_len  Length of catalog
+  @param[in]  table        Name of the table
+  @param[in]  table_len    Length of table
+  @param[in]  column       Pattern of column names to match
+  @param[in]  column_len   Length of column pattern
+
+  @return TRUE if out of memory
+*/
+static my_bool columns_batch_query(MYSQL *mysql, DYNAMIC_STRING *query,
+                                   SQLCHAR *catalog, SQLSMALLINT catalog_len,
+                                   const char *table, ulong table_len,
+                                   SQLCHAR *column, SQLSMALLINT column_len)
+{
+  char name[NAME_LEN * 4 + 8], buff[NAME_LEN * 6 + 80], *to;
+
+  to= name;
+  if (catalog_len)
+  {
+    to= myodbc_stpmov(to, "`");
+    to+= myodbc_escape_string(mysql, to, (ulong)(sizeof(name) - (to - name)),
+                              (char *)catalog, catalog_len, 1);
+    to= myodbc_stpmov(to, "`.");
+  }
+  to= myodbc_stpmov(to, "`");
+  to+= myodbc_escape_string(mysql, to, (ulong)(sizeof(name) - (to - name)),
+                            table, table_len, 1);
+  to= myodbc_stpmov(to, "`");
+
+  to= myodbc_stpmov(buff, query->length ? ";" : "");
+  to= strxmov(to, "SELECT * FROM ", name, " LIMIT 0;SHOW COLUMNS FROM ", name,
+              NullS);
+
+  /* An empty pattern matches all columns, like in mysql_list_fields() */
+  if (column_len)
+  {
+    to= myodbc_stpmov(to, " LIKE '");
+    to+= mysql_real_escape_string(mysql, to, (char *)column, column_len);
+    to= myodbc_stpmov(to, "'");
+  }
+
+  return dynstr_append_mem(query, buff, (ulong)(to - buff));
+}
+
+
+/**
+  Get the columns of the tables found by columns_no_i_s() with one round
+  trip per CATALOG_BATCH tables, instead of one mysql_list_fields() per
+  table.
+
+  Each table gets a "SELECT * ... LIMIT 0", for the same description of
+  the columns as mysql_list_fields(), and a SHOW COLUMNS that matches the
+  column pattern and gives the default values.
+
+  @param[in]  stmt       Statement
+  @param[in]  tables     Tables to get the columns of
+  @param[in]  szCatalog  Catalog of the tables
+  @param[in]  cbCatalog  Length of catalog
+  @param[in]  szColumn   Pattern of column names to match
+  @param[in]  cbColumn   Length of column pattern
+  @param[in]  db         TABLE_CAT value
+  @param[in]  is_access  Whether the application is MS Access
+  @param[in,out] rows    Number of rows of the result
+*/
+static SQLRETURN
+columns_no_i_s_batch(STMT *stmt, MYSQL_RES *tables,
+                     SQLCHAR *szCatalog, SQLSMALLINT cbCatalog,
+                     SQLCHAR *szColumn, SQLSMALLINT cbColumn,
+                     char *db, BOOL is_access, unsigned long *rows)
+{
+  uint batch= stmt->dbc->ds->catalog_batch, count, stored, i;
+  MYSQL_RES **results;
+  MYSQL_ROW table_row;
+  DYNAMIC_STRING query;
+  SQLRETURN rc= SQL_SUCCESS;
+  unsigned long next_row= *rows;
+
+  results= (MYSQL_RES **)myodbc_malloc(sizeof(MYSQL_RES *) * 2 * batch,
+                                       MYF(0));
+  if (!results || init_dynamic_string(&query, "", 1024, 1024))
+  {
+    x_free(results);
+    set_mem_error(&stmt->dbc->mysql);
+    return handle_connection_error(stmt);
+  }
+
+  do
+  {
+    query.length= 0;
+
+    for (count= 0; count < batch && (table_row= mysql_fetch_row(tables));
+         ++count)
+    {
+      unsigned long *lengths= mysql_fetch_lengths(tables);
+
+      if (columns_batch_query(&stmt->dbc->mysql, &query, szCatalog, cbCatalog,
+                              table_row[0], lengths[0], szColumn, cbColumn))
+      {
+        set_mem_error(&stmt->dbc->mysql);
+        rc= handle_connection_error(stmt);
+        goto end;
+      }
+    }
+
+    if (!count)
+    {
+      break;
+    }
+
+    if ((rc= catalog_batch_run(stmt, &query, results, count * 2,
+                               &stored)) != SQL_SUCCESS)
+    {
+      while (stored)
+      {
+        mysql_free_result(results[--stored]);
+      }
+      goto end;
+    }
+
+    for (i= 0; i < count; ++i)
+    {
+      MYSQL_RES *fields= results[2 * i], *columns= results[2 * i + 1];
+      MYSQL_ROW column;
+      uint field_count= mysql_num_fields(fields), next_field= 0;
+      int position= 0;
+
+      *rows+= (unsigned long)mysql_num_rows(columns);
+
+      stmt->result_array= (char **)myodbc_realloc((char *)stmt->result_array,
+                                                  sizeof(char *) *
+                                                  SQLCOLUMNS_FIELDS * *rows,
+                                                  MYF(MY_ALLOW_ZERO_PTR));
+
+      /* SHOW COLUMNS has the columns in the order of the table */
+      while (stmt->result_array && (column= mysql_fetch_row(columns)))
+      {
+        MYSQL_FIELD *field= NULL;
+        const char *def= column[4];
+        uint j;
+
+        for (j= next_field; j < field_count; ++j)
+        {
+          if (!myodbc_strcasecmp(mysql_fetch_field_direct(fields, j)->name,
+                                 column[0]))
+          {
+            field= mysql_fetch_field_direct(fields, j);
+            next_field= j + 1;
+            break;
+          }
+        }
+
+        if (!field)
+        {
+          continue;
+        }
+
+        /* mysql_list_fields() gives no default for CURRENT_TIMESTAMP */
+        if (def && field->type == MYSQL_TYPE_TIMESTAMP &&
+            !myodbc_casecmp(def, "CURRENT_TIMESTAMP", 17))
+        {
+          def= NULL;
+        }
+
+        fill_columns_row(stmt, stmt->result_array +
+                               SQLCOLUMNS_FIELDS * next_row++,
+                         field, def, db, ++position, is_access);
+      }
+
+      *rows= next_row;
+    }
+
+    for (i= 0; i < count * 2; ++i)
+    {
+      mysql_free_result(results[i]);
+    }
+
+    if (!stmt->result_array)
+    {
+      set_mem_error(&stmt->dbc->mysql);
+      rc= handle_connection_error(stmt);
+      goto end;
+    }
+  } while (count == batch);
+
+end:
+  dynstr_free(&query);
+  x_free(results);
+  return rc;
+}
+
+
 /**
   Get information about the columns in one or more tables.
 
@@ -264,8 +833,10 @@ columns_no_i_s(STMT * stmt, SQLCHAR *szCatalog, SQLSMALLINT cbCatalog,
   MEM_ROOT *alloc;
   MYSQL_ROW table_row;
   unsigned long rows= 0, next_row= 0, *lengths;
-  char *db= NULL;
+  char *db= NULL, column_buff[NAME_LEN + 1];
   BOOL is_access= FALSE;
+  MYSQL_RES **fanout_results= NULL;
+  uint table_count, table_index= 0;
 
   if (cbColumn > NAME_LEN || cbTable > NAME_LEN || cbCatalog > NAME_LEN)
   {
@@ -301,6 +872,31 @@ columns_no_i_s(STMT * stmt, SQLCHAR *szCatalog, SQLSMALLINT cbCatalog,
   if (!stmt->dbc->ds->no_catalog)
     db= strmake_root(alloc, (char *)szCatalog, cbCatalog);
 
+  /* The batches take all the tables, leaving none for the loop below */
+  if (stmt->dbc->ds->catalog_batch > 1)
+  {
+    SQLRETURN rc= columns_no_i_s_batch(stmt, res, szCatalog, cbCatalog,
+                                       szColumn, cbColumn, db, is_access,
+                                       &rows);
+    if (rc != SQL_SUCCESS)
+    {
+      return rc;
+    }
+  }
+  else
+  {
+    SQLRETURN rc;
+
+    strmake(column_buff, (char *)szColumn, cbColumn);
+    rc= fanout_tables(stmt, res, szCatalog, cbCatalog, fanout_list_fields,
+                      column_buff, &fanout_results);
+    if (rc != SQL_SUCCESS && rc != SQL_NO_DATA)
+    {
+      return rc;
+    }
+  }
+  table_count= (uint)mysql_num_rows(res);
+
   while ((table_row= mysql_fetch_row(res)))
   {
     MYSQL_FIELD *field;
@@ -309,13 +905,22 @@ columns_no_i_s(STMT * stmt, SQLCHAR *szCatalog, SQLSMALLINT cbCatalog,
 
     /* Get list of columns matching szColumn for each table. */
     lengths= mysql_fetch_lengths(res);
-    table_res= server_list_dbcolumns(stmt, szCatalog, cbCatalog,
-                                     (SQLCHAR *)table_row[0],
-                                     (SQLSMALLINT)lengths[0],
-                                     szColumn, cbColumn);
+    if (fanout_results)
+    {
+      table_res= fanout_results[table_index];
+      fanout_results[table_index++]= NULL;
+    }
+    else
+    {
+      table_res= server_list_dbcolumns(stmt, szCatalog, cbCatalog,
+                                       (SQLCHAR *)table_row[0],
+                                       (SQLSMALLINT)lengths[0],
+                                       szColumn, cbColumn);
+    }
 
     if (!table_res)
     {
+      free_catalog_results(fanout_results, table_count);
       return handle_connection_error(stmt);
     }
 
@@ -327,153 +932,23 @@ columns_no_i_s(STMT * stmt, SQLCHAR *szCatalog, SQLSMALLINT cbCatalog,
                                             MYF(MY_ALLOW_ZERO_PTR));
     if (!stmt->result_array)
     {
+      mysql_free_result(table_res);
+      free_catalog_results(fanout_results, table_count);
       set_mem_error(&stmt->dbc->mysql);
       return handle_connection_error(stmt);
     }
 
     while ((field= mysql_fetch_field(table_res)))
     {
-      SQLSMALLINT type;
-      char buff[255]; /* @todo justify the size of this buffer */
       MYSQL_ROW row= stmt->result_array + (SQLCOLUMNS_FIELDS * next_row++);
 
-      row[0]= db;                     /* TABLE_CAT */
-      row[1]= NULL;                   /* TABLE_SCHEM */
-      row[2]= strdup_root(alloc, field->table); /* TABLE_NAME */
-      row[3]= strdup_root(alloc, field->name);  /* COLUMN_NAME */
-
-      type= get_sql_data_type(stmt, field, buff);
-
-      row[5]= strdup_root(alloc, buff); /* TYPE_NAME */
-
-      sprintf(buff, "%d", type);
-      row[4]= strdup_root(alloc, buff); /* DATA_TYPE */
-
-      if (type == SQL_TYPE_DATE || type == SQL_TYPE_TIME ||
-          type == SQL_TYPE_TIMESTAMP)
-      {
-        row[14]= row[4];    /* SQL_DATETIME_SUB */
-        sprintf(buff, "%d", SQL_DATETIME);
-        row[13]= strdup_root(alloc, buff); /* SQL_DATA_TYPE */
-      }
-      else
-      {
-        row[13]= row[4];    /* SQL_DATA_TYPE */
-        row[14]= NULL;      /* SQL_DATETIME_SUB */
-      }
-
-      /* COLUMN_SIZE */
-      fill_column_size_buff(buff, stmt, field);
-      row[6]= strdup_root(alloc, buff);
-
-      /* BUFFER_LENGTH */
-      sprintf(buff, "%ld", get_transfer_octet_length(stmt, field));
-      row[7]= strdup_root(alloc, buff);
-
-      if (is_char_sql_type(type) || is_wchar_sql_type(type) ||
-          is_binary_sql_type(type))
-      {
-        row[15]= strdup_root(alloc, buff); /* CHAR_OCTET_LENGTH */
-      }
-      else
-      {
-        row[15]= NULL;                     /* CHAR_OCTET_LENGTH */
-      }
-
-      {
-        SQLSMALLINT digits= get_decimal_digits(stmt, field);
-        if (digits != SQL_NO_TOTAL)
-        {
-          sprintf(buff, "%d", digits);
-          row[8]= strdup_root(alloc, buff);  /* DECIMAL_DIGITS */
-          row[9]= "10";                      /* NUM_PREC_RADIX */
-        }
-        else
-        {
-          row[8]= row[9]= NullS;             /* DECIMAL_DIGITS, NUM_PREC_RADIX */
-        }
-      }
-
-      /*
-        If a field is a TIMESTAMP, NULL can be stored to it (although it gets turned into
-        something else).
-
-        The same logic applies to fields with AUTO_INCREMENT_FLAG set.
-      */
-      if ((field->flags & NOT_NULL_FLAG) && !(field->type == MYSQL_TYPE_TIMESTAMP) &&
-          !(field->flags & AUTO_INCREMENT_FLAG))
-      {
-        /* Bug#31067. Access seems to try to put NULL value when not null field
-           is cleared. And that contradicts with its knowledge of that the field
-           is not nullable, and it yields an error. Here is a little trick for
-           such case - we don't tell Access the whole truth we know, and
-           return for such field SQL_NULLABLE_UNKNOWN instead*/
-        if (is_access)
-        {
-          sprintf(buff, "%d", SQL_NULLABLE_UNKNOWN);
-          row[10]= strdup_root(alloc, buff); /* NULLABLE */
-          row[17]= strdup_root(alloc, "NO");/* IS_NULLABLE */
-        }
-        else
-        {
-          sprintf(buff, "%d", SQL_NO_NULLS);
-          row[10]= strdup_root(alloc, buff); /* NULLABLE */
-          row[17]= strdup_root(alloc, "NO"); /* IS_NULLABLE */
-        }
-      }
-      else
-      {
-        sprintf(buff, "%d", SQL_NULLABLE);
-        row[10]= strdup_root(alloc, buff); /* NULLABLE */
-        row[17]= strdup_root(alloc, "YES");/* IS_NULLABLE */
-      }
-
-      row[11]= ""; /* REMARKS */
-
-      /*
-        The default value of the column. The value in this column should be
-        interpreted as a string if it is enclosed in quotation marks.
-
-        if NULL was specified as the default value, then this column is the
-        word NULL, not enclosed in quotation marks. If the default value
-        cannot be represented without truncation, then this column contains
-        TRUNCATED, with no enclosing single quotation marks. If no default
-        value was specified, then this column is NULL.
-
-        The value of COLUMN_DEF can be used in generating a new column
-        definition, except when it contains the value TRUNCATED
-      */
-      if (!field->def)
-        row[12]= NullS; /* COLUMN_DEF */
-      else
-      {
-        if (field->type == MYSQL_TYPE_TIMESTAMP &&
-            !strcmp(field->def,"0000-00-00 00:00:00"))
-        {
-          row[12]= NullS; /* COLUMN_DEF */
-        }
-        else
-        {
-          char *def= alloc_root(alloc, strlen(field->def) + 3);
-          if (is_numeric_mysql_type(field))
-          {
-            sprintf(def, "%s", field->def);
-          }
-          else
-          {
-            sprintf(def, "'%s'", field->def);
-          }
-          row[12]= def; /* COLUMN_DEF */
-        }
-      }
-
-      sprintf(buff, "%d", ++count);
-      row[16]= strdup_root(alloc, buff); /* ORDINAL_POSITION */
+      fill_columns_row(stmt, row, field, field->def, db, ++count, is_access);
     }
 
     mysql_free_result(table_res);
   }
 
+  free_catalog_results(fanout_results, table_count);
   set_row_count(stmt, rows);
   myodbc_link_fields(stmt, SQLCOLUMNS_fields, SQLCOLUMNS_FIELDS);
 
@@ -812,36 +1287,37 @@ list_column_priv_no_i_s(SQLHSTMT hstmt,
 }
 
 
+/** @todo determine real size for buffer */
+#define TABLE_STATUS_QUERY_LEN (36 + 4*NAME_LEN + 1)
+
 /**
-Get the table status for a table or tables using SHOW TABLE STATUS.
-Lengths may not be SQL_NTS.
+Build the SHOW TABLE STATUS query of table_status_no_i_s().
 
-@param[in] stmt           Handle to statement
-@param[in] catalog        Catalog (database) of table, @c NULL for current
-@param[in] catalog_length Length of catalog name
-@param[in] table          Name of table
-@param[in] table_length   Length of table name
-@param[in] wildcard       Whether the table name is a wildcard
+@param[in]  mysql          Connection
+@param[out] buff           Buffer of TABLE_STATUS_QUERY_LEN bytes
+@param[in]  catalog        Catalog (database) of table, @c NULL for current
+@param[in]  catalog_length Length of catalog name
+@param[in]  table          Name of table
+@param[in]  table_length   Length of table name
+@param[in]  wildcard       Whether the table name is a wildcard
 
-@return Result of SHOW TABLE STATUS, or NULL if there is an error
-or empty result (check mysql_errno(&stmt->dbc->mysql) != 0)
+@return Length of the query, 0 if the query would match no table
 */
-MYSQL_RES *table_status_no_i_s(STMT        *stmt,
-                               SQLCHAR     *catalog,
-                               SQLSMALLINT  catalog_length,
-                               SQLCHAR     *table,
-                               SQLSMALLINT  table_length,
-                               my_bool      wildcard)
+static ulong table_status_query(MYSQL       *mysql,
+                                char        *buff,
+                                SQLCHAR     *catalog,
+                                SQLSMALLINT  catalog_length,
+                                SQLCHAR     *table,
+                                SQLSMALLINT  table_length,
+                                my_bool      wildcard)
 {
-	MYSQL *mysql= &stmt->dbc->mysql;
-	/** @todo determine real size for buffer */
-	char buff[36 + 4*NAME_LEN + 1], *to;
+	char *to;
 
 	to= myodbc_stpmov(buff, "SHOW TABLE STATUS ");
 	if (catalog && *catalog)
 	{
 		to= myodbc_stpmov(to, "FROM `");
-		to+= myodbc_escape_string(mysql, to, (ulong)(sizeof(buff) - (to - buff)),
+		to+= myodbc_escape_string(mysql, to, (ulong)(TABLE_STATUS_QUERY_LEN - (to - buff)),
 			(char *)catalog, catalog_length, 1);
 		to= myodbc_stpmov(to, "` ");
 	}
@@ -852,7 +1328,7 @@ MYSQL_RES *table_status_no_i_s(STMT        *stmt,
 	But it will never match anything, so bail out now.
 	*/
 	if (table && wildcard && !*table)
-		return NULL;
+		return 0;
 
 	if (table && *table)
 	{
@@ -860,16 +1336,50 @@ MYSQL_RES *table_status_no_i_s(STMT        *stmt,
 		if (wildcard)
 			to+= mysql_real_escape_string(mysql, to, (char *)table, table_length);
 		else
-			to+= myodbc_escape_string(mysql, to, (ulong)(sizeof(buff) - (to - buff)),
+			to+= myodbc_escape_string(mysql, to, (ulong)(TABLE_STATUS_QUERY_LEN - (to - buff)),
 			(char *)table, table_length, 0);
 		to= myodbc_stpmov(to, "'");
 	}
 
-  MYLOG_QUERY(stmt, buff);
+  assert(to - buff < TABLE_STATUS_QUERY_LEN);
 
-  assert(to - buff < sizeof(buff));
+  return (ulong)(to - buff);
+}
+
+
+/**
+Get the table status for a table or tables using SHOW TABLE STATUS.
+Lengths may not be SQL_NTS.
+
+@param[in] stmt           Handle to statement
+@param[in] catalog        Catalog (database) of table, @c NULL for current
+@param[in] catalog_length Length of catalog name
+@param[in] table          Name of table
+@param[in] table_length   Length of table name
+@param[in] wildcard       Whether the table name is a wildcard
 
-  if (exec_stmt_query(stmt, buff, (unsigned long)(to - buff), FALSE))
+@return Result of SHOW TABLE STATUS, or NULL if there is an error
+or empty result (check mysql_errno(&stmt->dbc->mysql) != 0)
+*/
+MYSQL_RES *table_status_no_i_s(STMT        *stmt,
+                               SQLCHAR     *catalog,
+                               SQLSMALLINT  catalog_length,
+                               SQLCHAR     *table,
+                               SQLSMALLINT  table_length,
+                               my_bool      wildcard)
+{
+	MYSQL *mysql= &stmt->dbc->mysql;
+	char buff[TABLE_STATUS_QUERY_LEN];
+	ulong length= table_status_query(mysql, buff, catalog, catalog_length,
+	                                 table, table_length, wildcard);
+
+	/* The pattern can match nothing */
+	if (!length)
+		return NULL;
+
+  MYLOG_QUERY(stmt, buff);
+
+  if (exec_stmt_query(stmt, buff, length, FALSE))
   {
     return NULL;
   }
@@ -1097,6 +1607,8 @@ SQLRETURN foreign_keys_no_i_s(SQLHSTMT hstmt,
   MY_FOREIGN_KEY_FIELD *fkRows= NULL;
   unsigned long *lengths;
   SQLRETURN rc= SQL_SUCCESS;
+  MYSQL_RES **fanout_results= NULL;
+  uint table_count= 0, table_index= 0;
 
   myodbc_init_dynamic_array(&records, sizeof(MY_FOREIGN_KEY_FIELD), 0, 0);
 
@@ -1116,16 +1628,33 @@ SQLRETURN foreign_keys_no_i_s(SQLHSTMT hstmt,
   free_internal_result_buffers(stmt);
   myodbc_mutex_unlock(&stmt->dbc->lock);
 
+  table_count= (uint)mysql_num_rows(local_res);
+  rc= fanout_tables(stmt, local_res, szFkCatalogName, cbFkCatalogName,
+                    fanout_show_create_table, NULL, &fanout_results);
+  if (rc == SQL_ERROR)
+  {
+    goto free_and_return;
+  }
+  rc= SQL_SUCCESS;
+
   while ((table_row = mysql_fetch_row(local_res)))
   {
     myodbc_mutex_lock(&stmt->dbc->lock);
     lengths = mysql_fetch_lengths(local_res);
     if (stmt->result)
       mysql_free_result(stmt->result);
-    stmt->result= server_show_create_table(stmt,
-                                           szFkCatalogName, cbFkCatalogName,
-                                           (SQLCHAR *)table_row[0], 
-                                           (SQLSMALLINT)lengths[0]);
+    if (fanout_results)
+    {
+      stmt->result= fanout_results[table_index];
+      fanout_results[table_index++]= NULL;
+    }
+    else
+    {
+      stmt->result= server_show_create_table(stmt,
+                                             szFkCatalogName, cbFkCatalogName,
+                                             (SQLCHAR *)table_row[0], 
+                                             (SQLSMALLINT)lengths[0]);
+    }
 
     if (!stmt->result)
     {
@@ -1432,6 +1961,7 @@ SQLRETURN foreign_keys_no_i_s(SQLHSTMT hstmt,
   }
   delete_dynamic(&records);
   mysql_free_result(local_res);
+  free_catalog_results(fanout_results, table_count);
 
   /* Copy only the elements that contain fk names */
   stmt->result_array= (MYSQL_ROW)myodbc_memdup((char *)tempdata,
@@ -1458,6 +1988,7 @@ empty_set:
   x_free((char *)tempdata);
   delete_dynamic(&records);
   mysql_free_result(local_res);
+  free_catalog_results(fanout_results, table_count);
   free_internal_result_buffers(stmt);
   if (stmt->result)
     mysql_free_result(stmt->result);
@@ -1474,6 +2005,7 @@ unlock_and_free:
 free_and_return:
   x_free((char *)tempdata);
   delete_dynamic(&records);
+  free_catalog_results(fanout_results, table_count);
 
   free_internal_result_buffers(stmt);
   if (stmt->result)
@@ -2407,6 +2939,115 @@ MYSQL_FIELD SQLTABLES_fields[]=
 
 const uint SQLTABLES_FIELDS= array_elements(SQLTABLES_values);
 
+/**
+  Get the SHOW TABLE STATUS of all the catalogs of a SHOW DATABASES result,
+  with one round trip per CATALOG_BATCH catalogs instead of one per
+  catalog.
+
+  @param[in]  stmt       Statement
+  @param[in]  catalogs   Result of SHOW DATABASES, rewound on return
+  @param[in]  table      Pattern of table names to match
+  @param[in]  table_len  Length of table pattern
+  @param[out] results    Result of SHOW TABLE STATUS for each catalog, to
+                         be freed with free_catalog_results()
+
+  A catalog whose result is NULL is left to the serial path of
+  tables_no_i_s(): the ones skipped, and the ones of a batch from the query
+  that failed on. The serial path then gives the error of the catalog, or
+  ignores it as it does for a catalog dropped meanwhile.
+
+  @return SQL_SUCCESS, or SQL_ERROR if out of memory
+*/
+static SQLRETURN tables_no_i_s_batch(STMT *stmt, MYSQL_RES *catalogs,
+                                     SQLCHAR *table, SQLSMALLINT table_len,
+                                     MYSQL_RES ***results)
+{
+  uint batch= stmt->dbc->ds->catalog_batch;
+  uint total= (uint)mysql_num_rows(catalogs), index= 0, count, stored, i;
+  MYSQL_RES **batch_results;
+  uint *slots;
+  DYNAMIC_STRING query;
+  SQLRETURN rc= SQL_SUCCESS;
+  MYSQL_ROW row;
+
+  *results= (MYSQL_RES **)myodbc_malloc(sizeof(MYSQL_RES *) * (total + 1),
+                                        MYF(MY_ZEROFILL));
+  batch_results= (MYSQL_RES **)myodbc_malloc(sizeof(MYSQL_RES *) * batch,
+                                             MYF(0));
+  slots= (uint *)myodbc_malloc(sizeof(uint) * batch, MYF(0));
+
+  if (!*results || !batch_results || !slots ||
+      init_dynamic_string(&query, "", 1024, 1024))
+  {
+    x_free(*results);
+    x_free(batch_results);
+    x_free(slots);
+    set_mem_error(&stmt->dbc->mysql);
+    return handle_connection_error(stmt);
+  }
+
+  do
+  {
+    query.length= 0;
+
+    for (count= 0; count < batch && (row= mysql_fetch_row(catalogs));
+         ++index)
+    {
+      unsigned long *lengths= mysql_fetch_lengths(catalogs);
+      char buff[TABLE_STATUS_QUERY_LEN];
+      ulong length;
+
+      /* Skipped by tables_no_i_s() */
+      if (!myodbc_strcasecmp(row[0], "information_schema"))
+        continue;
+
+      length= table_status_query(&stmt->dbc->mysql, buff, (SQLCHAR *)row[0],
+                                 (SQLSMALLINT)lengths[0], table, table_len,
+                                 TRUE);
+      if (!length)
+        continue;
+
+      if ((query.length && dynstr_append_mem(&query, ";", 1)) ||
+          dynstr_append_mem(&query, buff, length))
+      {
+        set_mem_error(&stmt->dbc->mysql);
+        rc= handle_connection_error(stmt);
+        goto end;
+      }
+
+      slots[count++]= index;
+    }
+
+    stored= 0;
+    if (count &&
+        catalog_batch_run(stmt, &query, batch_results, count, &stored) !=
+        SQL_SUCCESS)
+    {
+      /* The catalogs from the failed query on are queried one by one */
+      CLEAR_STMT_ERROR(stmt);
+    }
+
+    for (i= 0; i < stored; ++i)
+    {
+      (*results)[slots[i]]= batch_results[i];
+    }
+  } while (count == batch);
+
+end:
+  if (rc != SQL_SUCCESS)
+  {
+    free_catalog_results(*results, total);
+    *results= NULL;
+  }
+
+  mysql_data_seek(catalogs, 0);
+  dynstr_free(&query);
+  x_free(batch_results);
+  x_free(slots);
+  return rc;
+}
+
+
 SQLRETURN
 tables_no_i_s(SQLHSTMT hstmt,
               SQLCHAR *catalog, SQLSMALLINT catalog_len,
@@ -2424,6 +3065,8 @@ tables_no_i_s(SQLHSTMT hstmt,
     unsigned long count= 0;
     my_bool is_info_schema= 0;
     SQLRETURN rc = SQL_SUCCESS;
+    MYSQL_RES **catalog_results= NULL;
+    uint catalog_count= 0, catalog_index= 0;
 
     /* 
       empty (but non-NULL) schema and table returns catalog list 
@@ -2528,6 +3171,16 @@ tables_no_i_s(SQLHSTMT hstmt,
     /* User Tables with type as 'TABLE' or 'VIEW' */
     if (user_tables || views)
     {
+      /* Get the tables of all catalogs in batches, when asked to */
+      if (catalog_res && stmt->dbc->ds->catalog_batch > 1)
+      {
+        catalog_count= (uint)mysql_num_rows(catalog_res);
+        rc= tables_no_i_s_batch(stmt, catalog_res, table, table_len,
+                                &catalog_results);
+        if (rc != SQL_SUCCESS)
+          goto free_and_return;
+      }
+
        /*
         If database result set (catalog_res) was produced loop  
         through all database to fetch table list inside database
@@ -2556,6 +3209,8 @@ tables_no_i_s(SQLHSTMT hstmt,
             mysql_table_status_show to get result for SQL_ALL_CATALOGS 
             (%) and catalog selection is handled in this function
           */
+          uint index= catalog_index++;
+
           if(myodbc_strcasecmp(catalog_row[0], "information_schema") == 0)
           {
             myodbc_mutex_unlock(&stmt->dbc->lock);
@@ -2567,9 +3222,19 @@ tables_no_i_s(SQLHSTMT hstmt,
           if (stmt->result)
             mysql_free_result(stmt->result);
 
-          stmt->result= table_status(stmt, catalog_row[0], (SQLSMALLINT)lengths[0],
-                                     table, (SQLSMALLINT)table_len, TRUE,
-                                     user_tables, views);
+          if (catalog_results && catalog_results[index])
+          {
+            /* Already run by tables_no_i_s_batch() */
+            stmt->result= catalog_results[index];
+            catalog_results[index]= NULL;
+          }
+          else
+          {
+            stmt->result= table_status(stmt, catalog_row[0],
+                                       (SQLSMALLINT)lengths[0],
+                                       table, (SQLSMALLINT)table_len, TRUE,
+                                       user_tables, views);
+          }
         }
 
         if (!stmt->result && mysql_errno(&stmt->dbc->mysql))
@@ -2700,6 +3365,7 @@ tables_no_i_s(SQLHSTMT hstmt,
 
     if (catalog_res)
       mysql_free_result(catalog_res);
+    free_catalog_results(catalog_results, catalog_count);
 
     myodbc_link_fields(stmt, SQLTABLES_fields, SQLTABLES_FIELDS);
     return SQL_SUCCESS;
@@ -2707,6 +3373,7 @@ tables_no_i_s(SQLHSTMT hstmt,
 empty_set:
   if (catalog_res)
     mysql_free_result(catalog_res);
+  free_catalog_results(catalog_results, catalog_count);
 
   return create_empty_fake_resultset(stmt, SQLTABLES_values,
                                      sizeof(SQLTABLES_values),
@@ -2715,5 +3382,6 @@ empty_set:
 free_and_return:
   if (catalog_res)
     mysql_free_result(catalog_res);
+  free_catalog_results(catalog_results, catalog_count);
   return rc;
 }
@@ -30,6 +30,8 @@
 #include "driver.h"
 #include "installer.h"
 #include "stringutil.h"
+#include "myodbc_latency.h"
+#include <errmsg.h>
 
 #ifndef CLIENT_NO_SCHEMA
 # define CLIENT_NO_SCHEMA      16
@@ -68,9 +70,52 @@ unsigned long get_client_flags(DataSource *ds)
 }
 
 
+/**
+  Check a COMPRESSION_ALGORITHM value: a comma separated list of "zlib",
+  "zstd" and "uncompressed", or nothing. Client libraries before 8.0.18
+  only know zlib. An empty item, such as after a trailing comma, is not
+  valid.
+
+  @return TRUE if the value is valid
+*/
+static my_bool is_valid_compression(const char *algorithms)
+{
+  if (!*algorithms)
+  {
+    return TRUE;
+  }
+
+  for (;;)
+  {
+    const char *end= strchr(algorithms, ',');
+    size_t len= end ? (size_t)(end - algorithms) : strlen(algorithms);
+
+    if (!(len == 4 && !myodbc_casecmp(algorithms, "zlib", 4)) &&
+#if MYSQL_VERSION_ID >= 80018
+        !(len == 4 && !myodbc_casecmp(algorithms, "zstd", 4)) &&
+#endif
+        !(len == 12 && !myodbc_casecmp(algorithms, "uncompressed", 12)))
+    {
+      return FALSE;
+    }
+
+    if (!end)
+    {
+      return TRUE;
+    }
+    algorithms= end + 1;
+  }
+}
+
+
 /**
  If it was specified, set the character set for the connection.
 
+ The handshake already asked for the character set the connection is
+ initialized with, so SET NAMES is only sent when another one is wanted.
+ character_set_results is set by the caller, along with the rest of the
+ session state.
+
  @param[in]  dbc      Database connection
  @param[in]  charset  Character set name
 */
@@ -97,23 +142,17 @@ SQLRETURN myodbc_set_initial_character_set(DBC *dbc, const char *charset)
     charset= "utf8";
   }
 
-  if (charset && charset[0])
+  if (!charset || !charset[0])
   {
-    if (mysql_set_character_set(&dbc->mysql, charset))
-    {
-      set_dbc_error(dbc, "HY000", mysql_error(&dbc->mysql),
-                    mysql_errno(&dbc->mysql));
-      return SQL_ERROR;
-    }
+    charset= dbc->ansi_charset_info->csname;
   }
-  else
+
+  if (myodbc_strcasecmp(mysql_character_set_name(&dbc->mysql), charset) &&
+      mysql_set_character_set(&dbc->mysql, charset))
   {
-    if (mysql_set_character_set(&dbc->mysql, dbc->ansi_charset_info->csname))
-    {
-      set_dbc_error(dbc, "HY000", mysql_error(&dbc->mysql),
-                    mysql_errno(&dbc->mysql));
-      return SQL_ERROR;
-    }
+    set_dbc_error(dbc, "HY000", mysql_error(&dbc->mysql),
+                  mysql_errno(&dbc->mysql));
+    return SQL_ERROR;
   }
 
   {
@@ -125,17 +164,233 @@ SQLRETURN myodbc_set_initial_character_set(DBC *dbc, const char *charset)
   if (!dbc->unicode)
     dbc->ansi_charset_info= dbc->cxn_charset_info;
 
+  return SQL_SUCCESS;
+}
+
+
+/**
+  Tell whether a connect error means the host could not be reached, as
+  opposed to an error that any host of the list would report.
+*/
+static my_bool is_host_unreachable(uint errcode)
+{
+  switch (errcode)
+  {
+  case CR_CONNECTION_ERROR:
+  case CR_CONN_HOST_ERROR:
+  case CR_UNKNOWN_HOST:
+  case CR_SERVER_GONE_ERROR:
+  case CR_SERVER_LOST:
+  case CR_SSL_CONNECTION_ERROR:
+    return TRUE;
+  }
+
+  return is_connection_lost(errcode);
+}
+
+
+/**
+  Connect to the server of the data source.
+
+  The server can be a comma separated list of hosts. They are tried in the
+  order given by the LOAD_BALANCE strategy until one accepts the
+  connection, hosts that could not be reached are avoided for a while
+  (HOST_BACKOFF) by all the connections of the environment.
+
+  @param[in]  dbc    Connection handle
+  @param[in]  ds     Data source
+  @param[in]  flags  Client flags
+
+  @return Same as mysql_real_connect()
+*/
+static MYSQL *connect_to_server(DBC *dbc, DataSource *ds, unsigned long flags)
+{
+  MYSQL *mysql= &dbc->mysql, *connected= NULL;
+  char *server= ds_get_utf8attr(ds->server, &ds->server8);
+  MYODBC_HOST hosts[HOSTS_MAX];
+  uint order[HOSTS_MAX], count, i;
+  char *buffer;
+
+  ds_get_utf8attr(ds->uid,      &ds->uid8);
+  ds_get_utf8attr(ds->pwd,      &ds->pwd8);
+  ds_get_utf8attr(ds->database, &ds->database8);
+
+  if (!server || !strchr(server, ',') ||
+      !(buffer= myodbc_malloc(strlen(server) + 1, MYF(0))))
+  {
+    tls_sessions_apply(dbc, ds, server, ds->port);
+    connected= mysql_real_connect(mysql, server, ds->uid8, ds->pwd8,
+                                  ds->database8, ds->port,
+                                  ds_get_utf8attr(ds->socket, &ds->socket8),
+                                  flags);
+    if (connected)
+    {
+      tls_sessions_save(dbc, ds, server, ds->port);
+    }
+    return connected;
+  }
+
+  count= hosts_parse(server, ds->port, hosts, HOSTS_MAX, buffer);
+  hosts_order(dbc->env, hosts, count,
+              hosts_strategy(ds_get_utf8attr(ds->load_balance,
+                                             &ds->load_balance8)),
+              order);
+
+  for (i= 0; i < count && !connected; ++i)
+  {
+    MYODBC_HOST *host= &hosts[order[i]];
+    ulonglong start= my_getsystime();
+
+    tls_sessions_apply(dbc, ds, host->host, host->port);
+
+    /* Options have to survive a failed attempt for the next host */
+    connected= mysql_real_connect(mysql, host->host, ds->uid8, ds->pwd8,
+                                  ds->database8, host->port, NULL,
+                                  flags | CLIENT_REMEMBER_OPTIONS);
+
+    if (!connected && !is_host_unreachable(mysql_errno(mysql)))
+    {
+      /* Other hosts would refuse the connection just as well */
+      break;
+    }
+
+    if (connected)
+    {
+      tls_sessions_save(dbc, ds, host->host, host->port);
+    }
+
+    hosts_report(dbc->env, host, connected != NULL,
+                 (double)(my_getsystime() - start) / 10000.0,
+                 ds->host_backoff);
+  }
+
+  x_free(buffer);
+
+  return connected;
+}
+
+
+/**
+  Bring the session of a new connection to the state the driver and the
+  application expect.
+
+  The settings go in a single SET statement, so that they cost one round
+  trip instead of one each. The transaction isolation level has its own
+  statement syntax: it joins the same request when the connection accepts
+  multiple statements, and is sent after it otherwise.
+
+  @param[in]  dbc  Database connection
+  @param[in]  ds   Data source information
+
+  @return SQL_SUCCESS, SQL_SUCCESS_WITH_INFO if an option of the connection
+          had to be changed, or SQL_ERROR
+*/
+static SQLRETURN set_session_state(DBC *dbc, DataSource *ds)
+{
+  MYSQL *mysql= &dbc->mysql;
+  SQLRETURN rc= SQL_SUCCESS;
+  char query[160], isolation[64];
+  char *pos;
+  int status;
+
+  isolation[0]= '\0';
+
   /*
     We always set character_set_results to NULL so we can do our own
     conversion to the ANSI character set or Unicode.
   */
-  if (is_minimum_version(dbc->mysql.server_version, "4.1.1")
-      && odbc_stmt(dbc, "SET character_set_results = NULL", SQL_NTS, TRUE) != SQL_SUCCESS)
+  pos= myodbc_stpmov(query, "SET character_set_results = NULL");
+
+  /*
+    The MySQL server has a workaround for old versions of Microsoft Access
+    (and possibly other products) that is no longer necessary, but is
+    unfortunately enabled by default. We have to turn it off, or it causes
+    other problems.
+  */
+  if (!ds->auto_increment_null_search)
+  {
+    pos= myodbc_stpmov(pos, ", SQL_AUTO_IS_NULL = 0");
+  }
+
+  /* Make sure autocommit is set as configured. */
+  if (dbc->commit_flag == CHECK_AUTOCOMMIT_OFF)
+  {
+    if (!trans_supported(dbc) || ds->disable_transactions)
+    {
+      rc= SQL_SUCCESS_WITH_INFO;
+      dbc->commit_flag= CHECK_AUTOCOMMIT_ON;
+      set_conn_error(dbc, MYERR_01S02,
+                     "Transactions are not enabled, option value "
+                     "SQL_AUTOCOMMIT_OFF changed to SQL_AUTOCOMMIT_ON", 0);
+    }
+    else if (autocommit_on(dbc))
+    {
+      pos= myodbc_stpmov(pos, ", autocommit = 0");
+    }
+  }
+  else if ((dbc->commit_flag == CHECK_AUTOCOMMIT_ON) &&
+           trans_supported(dbc) && !autocommit_on(dbc))
+  {
+    pos= myodbc_stpmov(pos, ", autocommit = 1");
+  }
+
+  /* Set transaction isolation as configured. */
+  if (dbc->txn_isolation != DEFAULT_TXN_ISOLATION)
+  {
+    const char *level;
+
+    if (dbc->txn_isolation & SQL_TXN_SERIALIZABLE)
+      level= "SERIALIZABLE";
+    else if (dbc->txn_isolation & SQL_TXN_REPEATABLE_READ)
+      level= "REPEATABLE READ";
+    else if (dbc->txn_isolation & SQL_TXN_READ_COMMITTED)
+      level= "READ COMMITTED";
+    else
+      level= "READ UNCOMMITTED";
+
+    if (trans_supported(dbc))
+    {
+      sprintf(isolation, "SET SESSION TRANSACTION ISOLATION LEVEL %s", level);
+    }
+    else
+    {
+      dbc->txn_isolation= SQL_TXN_READ_UNCOMMITTED;
+      rc= SQL_SUCCESS_WITH_INFO;
+      set_conn_error(dbc, MYERR_01S02,
+                     "Transactions are not enabled, so transaction isolation "
+                     "was ignored.", 0);
+    }
+  }
+
+  if (isolation[0] && (mysql->client_flag & CLIENT_MULTI_STATEMENTS))
+  {
+    pos= strxmov(pos, "; ", isolation, NullS);
+    isolation[0]= '\0';
+  }
+
+  /* None of the statements has a result set, only their status is read */
+  if (mysql_real_query(mysql, query, (unsigned long)(pos - query)))
+  {
+    status= 1;
+  }
+  else
+  {
+    while ((status= mysql_next_result(mysql)) == 0);
+  }
+
+  if (status > 0)
+  {
+    return set_conn_error(dbc, MYERR_S1000, mysql_error(mysql),
+                          mysql_errno(mysql));
+  }
+
+  if (isolation[0] &&
+      odbc_stmt(dbc, isolation, SQL_NTS, TRUE) != SQL_SUCCESS)
   {
     return SQL_ERROR;
   }
 
-  return SQL_SUCCESS;
+  return rc;
 }
 
 
@@ -172,10 +427,48 @@ SQLRETURN myodbc_do_connect(DBC *dbc, DataSource *ds)
     ds->default_bigint_bind_str= 1;
 #endif
 
+  if (hosts_strategy(ds_get_utf8attr(ds->load_balance,
+                                     &ds->load_balance8)) < 0)
+  {
+    return set_dbc_error(dbc, "HY000", "Invalid LOAD_BALANCE value", 0);
+  }
+
+  if (ds_get_utf8attr(ds->compression_algorithm,
+                      &ds->compression_algorithm8) &&
+      !is_valid_compression((char *)ds->compression_algorithm8))
+  {
+    return set_dbc_error(dbc, "HY000", "Invalid COMPRESSION_ALGORITHM value",
+                         0);
+  }
+
+  if (ds->compression_level > 22)
+  {
+    return set_dbc_error(dbc, "HY000", "Invalid COMPRESSION_LEVEL value", 0);
+  }
+
   mysql_init(mysql);
 
   flags= get_client_flags(ds);
 
+  /* COMPRESSION_ALGORITHM takes precedence over COMPRESSED_PROTO */
+  if (ds->compression_algorithm8 && ds->compression_algorithm8[0])
+  {
+#if MYSQL_VERSION_ID >= 80018
+    flags&= ~CLIENT_COMPRESS;
+    mysql_options(mysql, MYSQL_OPT_COMPRESSION_ALGORITHMS,
+                  ds->compression_algorithm8);
+    if (ds->compression_level)
+      mysql_options(mysql, MYSQL_OPT_ZSTD_COMPRESSION_LEVEL,
+                    &ds->compression_level);
+#else
+    /* The list is in order of preference */
+    if (!myodbc_casecmp((char *)ds->compression_algorithm8, "zlib", 4))
+      flags|= CLIENT_COMPRESS;
+    else
+      flags&= ~CLIENT_COMPRESS;
+#endif
+  }
+
   /* Set other connection options */
 
   if (ds->allow_big_results || ds->safe)
@@ -354,14 +647,7 @@ SQLRETURN myodbc_do_connect(DBC *dbc, DataSource *ds)
   }
 #endif
 
-  if (!mysql_real_connect(mysql,
-                          ds_get_utf8attr(ds->server,   &ds->server8),
-                          ds_get_utf8attr(ds->uid,      &ds->uid8),
-                          ds_get_utf8attr(ds->pwd,      &ds->pwd8),
-                          ds_get_utf8attr(ds->database, &ds->database8),
-                          ds->port,
-                          ds_get_utf8attr(ds->socket,   &ds->socket8),
-                          flags))
+  if (!connect_to_server(dbc, ds, flags))
   {
     unsigned int native_error= mysql_errno(mysql);
 
@@ -409,14 +695,8 @@ SQLRETURN myodbc_do_connect(DBC *dbc, DataSource *ds)
     goto error;
   }
 
-  /*
-    The MySQL server has a workaround for old versions of Microsoft Access
-    (and possibly other products) that is no longer necessary, but is
-    unfortunately enabled by default. We have to turn it off, or it causes
-    other problems.
-  */
-  if (!ds->auto_increment_null_search &&
-      odbc_stmt(dbc, "SET SQL_AUTO_IS_NULL = 0", SQL_NTS, TRUE) != SQL_SUCCESS)
+  rc= set_session_state(dbc, ds);
+  if (!SQL_SUCCEEDED(rc))
   {
     /** @todo set error reason */
     goto error;
@@ -439,6 +719,14 @@ SQLRETURN myodbc_do_connect(DBC *dbc, DataSource *ds)
   if (ds->save_queries && !dbc->query_log)
     dbc->query_log= init_query_log();
 
+  tls_sessions_report(dbc);
+
+  if (ds->latency_stats || ds->latency_dump)
+  {
+    latency_enable(dbc->env, MYODBC_LATENCY_ON,
+                   ds_get_utf8attr(ds->latency_dump, &ds->latency_dump8));
+  }
+
   /* Set the statement error prefix based on the server version. */
   strxmov(dbc->st_error_prefix, MYODBC_ERROR_PREFIX, "[mysqld-",
           mysql->server_version, "]", NullS);
@@ -449,67 +737,6 @@ SQLRETURN myodbc_do_connect(DBC *dbc, DataSource *ds)
     mysql_options(mysql, MYSQL_OPT_RECONNECT, (char *)&on);
   }
 
-  /* Make sure autocommit is set as configured. */
-  if (dbc->commit_flag == CHECK_AUTOCOMMIT_OFF)
-  {
-    if (!trans_supported(dbc) || ds->disable_transactions)
-    {
-      rc= SQL_SUCCESS_WITH_INFO;
-      dbc->commit_flag= CHECK_AUTOCOMMIT_ON;
-      set_conn_error(dbc, MYERR_01S02,
-                     "Transactions are not enabled, option value "
-                     "SQL_AUTOCOMMIT_OFF changed to SQL_AUTOCOMMIT_ON", 0);
-    }
-    else if (autocommit_on(dbc) && mysql_autocommit(mysql, FALSE))
-    {
-      /** @todo set error */
-      goto error;
-    }
-  }
-  else if ((dbc->commit_flag == CHECK_AUTOCOMMIT_ON) &&
-           trans_supported(dbc) && !autocommit_on(dbc))
-  {
-    if (mysql_autocommit(mysql, TRUE))
-    {
-      /** @todo set error */
-      goto error;
-    }
-  }
-
-  /* Set transaction isolation as configured. */
-  if (dbc->txn_isolation != DEFAULT_TXN_ISOLATION)
-  {
-    char buff[80];
-    const char *level;
-
-    if (dbc->txn_isolation & SQL_TXN_SERIALIZABLE)
-      level= "SERIALIZABLE";
-    else if (dbc->txn_isolation & SQL_TXN_REPEATABLE_READ)
-      level= "REPEATABLE READ";
-    else if (dbc->txn_isolation & SQL_TXN_READ_COMMITTED)
-      level= "READ COMMITTED";
-    else
-      level= "READ UNCOMMITTED";
-
-    if (trans_supported(dbc))
-    {
-      sprintf(buff, "SET SESSION TRANSACTION ISOLATION LEVEL %s", level);
-      if (odbc_stmt(dbc, buff, SQL_NTS, TRUE) != SQL_SUCCESS)
-      {
-        /** @todo set error reason */
-        goto error;
-      }
-    }
-    else
-    {
-      dbc->txn_isolation= SQL_TXN_READ_UNCOMMITTED;
-      rc= SQL_SUCCESS_WITH_INFO;
-      set_conn_error(dbc, MYERR_01S02,
-                     "Transactions are not enabled, so transaction isolation "
-                     "was ignored.", 0);
-    }
-  }
-
 #if MYSQL_VERSION_ID >= 50709
   mysql_get_option(mysql, MYSQL_OPT_NET_BUFFER_LENGTH, &dbc->net_buffer_len);
 #else
@@ -960,6 +1187,9 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC hdbc)
   CHECK_HANDLE(hdbc);
 
   free_connection_stmts(dbc);
+  stmt_pool_flush(dbc);
+  query_template_flush(dbc);
+  catalog_fanout_close(dbc);
   
   mysql_close(&dbc->mysql);
 
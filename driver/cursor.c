@@ -213,7 +213,7 @@ static my_bool have_field_in_result(const char *name, MYSQL_RES *result)
 
   @return  Whether a usable unique keys exists
 */
-static my_bool check_if_usable_unique_key_exists(STMT *stmt)
+my_bool check_if_usable_unique_key_exists(STMT *stmt)
 {
   char buff[NAME_LEN * 2 + 18], /* Possibly escaped name, plus text for query */
        *pos, *table;
@@ -1665,6 +1665,10 @@ SQLRETURN SQL_API my_SQLSetPos(SQLHSTMT hstmt, SQLSETPOSIROW irow,
     if ( fLock != SQL_LOCK_NO_CHANGE )
         return set_error(stmt,MYERR_S1C00,NULL,0);
 
+    /* The rows of a keyset cursor can be read again, but not changed */
+    if ( stmt->keyset && fOption != SQL_POSITION && fOption != SQL_REFRESH )
+        return set_error(stmt,MYERR_S1C00,NULL,0);
+
     switch ( fOption )
     {
         case SQL_POSITION:
@@ -1899,6 +1903,9 @@ SQLRETURN SQL_API SQLBulkOperations(SQLHSTMT  Handle, SQLSMALLINT Operation)
   if ( !result )
       return set_error(stmt,MYERR_S1010,NULL,0);
 
+  if (stmt->keyset)
+      return set_error(stmt,MYERR_S1C00,NULL,0);
+
   stmt->stmt_options.bookmark_insert= FALSE;
 
   switch (Operation)
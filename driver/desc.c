@@ -93,6 +93,31 @@ DESC *desc_alloc(STMT *stmt, SQLSMALLINT alloc_type,
 }
 
 
+/*
+  Reset an implicit descriptor to the state desc_alloc() leaves it in,
+  keeping the memory of its arrays, for a statement handle being reused.
+*/
+void desc_reset(DESC *desc)
+{
+  if (IS_APD(desc))
+    desc_free_paramdata(desc);
+  desc_free_wstrs(desc);
+
+  desc->records.elements= 0;
+  desc->bookmark.elements= 0;
+  memset(&desc->error, 0, sizeof(desc->error));
+
+  desc->array_size= 1;
+  desc->array_status_ptr= NULL;
+  desc->bind_offset_ptr= NULL;
+  desc->bind_type= SQL_BIND_BY_COLUMN;
+  desc->count= 0;
+  desc->bookmark_count= 0;
+  desc->rows_processed_ptr= NULL;
+  desc->hot_count= 0;
+}
+
+
 /*
   Free a descriptor.
 */
@@ -101,12 +126,156 @@ void desc_free(DESC *desc)
   assert(desc);
   if (IS_APD(desc))
     desc_free_paramdata(desc);
+  desc_free_wstrs(desc);
+  x_free(desc->hot);
   delete_dynamic(&desc->records);
   delete_dynamic(&desc->bookmark);
   x_free(desc);
 }
 
 
+/*
+  Copy the hot fields of the records to the contiguous array of the
+  descriptor (desc->hot), for the loops over the columns or parameters
+  of each row.
+
+  The copy is not updated when the records change, so it has to be
+  refreshed at the start of each fetch or execution, and only used until
+  the function returns to the application.
+
+  @param[in]  desc   Descriptor
+  @param[in]  count  Number of entries wanted, the ones beyond the records
+                     of the descriptor have a NULL rec
+
+  @return TRUE if out of memory
+*/
+my_bool desc_hot_refresh(DESC *desc, SQLLEN count)
+{
+  SQLLEN i;
+
+  if (count > desc->hot_alloced)
+  {
+    DESC_HOT *hot= (DESC_HOT *)myodbc_realloc(desc->hot,
+                                              count * sizeof(DESC_HOT),
+                                              MYF(MY_ALLOW_ZERO_PTR));
+    if (!hot)
+    {
+      return TRUE;
+    }
+    desc->hot= hot;
+    desc->hot_alloced= count;
+  }
+
+  for (i= 0; i < count; ++i)
+  {
+    DESC_HOT *hot= desc->hot + i;
+    DESCREC *rec= i < desc->count ? desc_get_rec(desc, (int)i, FALSE) : NULL;
+
+    if (rec)
+    {
+      hot->data_ptr= rec->data_ptr;
+      hot->octet_length_ptr= rec->octet_length_ptr;
+      hot->indicator_ptr= rec->indicator_ptr;
+      hot->octet_length= rec->octet_length;
+      hot->concise_type= rec->concise_type;
+    }
+    else
+    {
+      memset(hot, 0, sizeof(DESC_HOT));
+    }
+    hot->rec= rec;
+  }
+
+  desc->hot_count= count;
+  return FALSE;
+}
+
+
+/*
+  Free the strings converted by desc_get_wstr(). Must be called whenever
+  the strings of the records change, i.e. for each new result.
+*/
+void desc_free_wstrs(DESC *desc)
+{
+  SQLLEN i;
+
+  for (i= 0; i < desc->wstrs_count * DESC_WSTR_SLOTS; ++i)
+  {
+    x_free(desc->wstrs[i].value);
+  }
+
+  x_free(desc->wstrs);
+  desc->wstrs= NULL;
+  desc->wstrs_count= 0;
+}
+
+
+/*
+  Get a string of a record converted to SQLWCHAR.
+
+  Conversions are kept with the descriptor, so that applications asking
+  for the names of the columns over and over don't pay for the
+  conversion and its allocation each time. The string must belong to the
+  record (or be a constant) and not change until desc_free_wstrs().
+
+  @param[in]  desc          Descriptor (IRD)
+  @param[in]  recnum        Record number, from 0
+  @param[in]  value         String to convert
+  @param[in]  charset_info  Character set of value
+  @param[out] len           Length of the converted string in characters,
+                            -1 if the conversion failed
+
+  @return The converted string, owned by the descriptor
+*/
+SQLWCHAR *desc_get_wstr(DESC *desc, uint recnum, SQLCHAR *value,
+                        CHARSET_INFO *charset_info, SQLINTEGER *len)
+{
+  DESC_WSTR *slot, *slots;
+  uint errors= 0, i;
+
+  if (recnum >= (uint)desc->wstrs_count)
+  {
+    SQLLEN count= myodbc_max(desc->count, (SQLLEN)recnum + 1);
+    DESC_WSTR *wstrs= (DESC_WSTR *)myodbc_realloc(desc->wstrs,
+                                       count * DESC_WSTR_SLOTS *
+                                       sizeof(DESC_WSTR),
+                                       MYF(MY_ALLOW_ZERO_PTR));
+    if (!wstrs)
+    {
+      *len= -1;
+      return NULL;
+    }
+
+    memset(wstrs + desc->wstrs_count * DESC_WSTR_SLOTS, 0,
+           (count - desc->wstrs_count) * DESC_WSTR_SLOTS * sizeof(DESC_WSTR));
+    desc->wstrs= wstrs;
+    desc->wstrs_count= count;
+  }
+
+  slots= desc->wstrs + recnum * DESC_WSTR_SLOTS;
+
+  for (i= 0; i < DESC_WSTR_SLOTS && slots[i].source; ++i)
+  {
+    if (slots[i].source == value)
+    {
+      *len= slots[i].len;
+      return slots[i].value;
+    }
+  }
+
+  /* All slots taken, replace the last one */
+  slot= slots + myodbc_min(i, DESC_WSTR_SLOTS - 1);
+  x_free(slot->value);
+
+  *len= SQL_NTS;
+  slot->value= sqlchar_as_sqlwchar(charset_info, value, len, &errors);
+  slot->len= *len;
+  slot->source= (*len == -1) ? NULL : value;
+
+  return slot->value;
+}
+
+
 /*
   Free any memory allocated for SQLPutData(). This is only useful
   for APDs.
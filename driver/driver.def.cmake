@@ -115,6 +115,7 @@ SQLStatistics@WIDECHARCALL@
 SQLTables@WIDECHARCALL@
 SQLTablePrivileges@WIDECHARCALL@
 SQLTransact
+MYODBCFetchArrow
 ;
 DllMain
 LoadByOrdinal
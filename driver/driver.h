@@ -212,6 +212,15 @@ typedef struct {
   size_t offset; /* offset of field in struct */
 } desc_field;
 
+/* SQLWCHAR copy of a string of an IRD record, see desc_get_wstr() */
+typedef struct {
+  const SQLCHAR *source; /* string the copy was converted from */
+  SQLWCHAR      *value;
+  SQLINTEGER     len;
+} DESC_WSTR;
+
+#define DESC_WSTR_SLOTS 8
+
 /* descriptor */
 struct tagSTMT;
 struct tagDBC;
@@ -244,6 +253,16 @@ typedef struct {
   MYERROR         error;
   struct tagSTMT *stmt;
 
+  /* IRD only: strings of the records converted for the W functions,
+     DESC_WSTR_SLOTS for each record */
+  DESC_WSTR      *wstrs;
+  SQLLEN          wstrs_count;
+
+  /* hot fields of the records, see desc_hot_refresh() */
+  struct st_desc_hot *hot;
+  SQLLEN          hot_count;
+  SQLLEN          hot_alloced;
+
   /* SQL_DESC_ALLOC_USER-specific */
   struct {
     /*
@@ -324,6 +343,22 @@ typedef struct {
   } row;
 } DESCREC;
 
+/*
+  Copy of the fields of a record used for each cell of the fetch and bind
+  loops, kept contiguous so that wide rows touch one cache line per
+  column instead of several.
+*/
+typedef struct st_desc_hot {
+  SQLPOINTER  data_ptr;
+  SQLLEN     *octet_length_ptr;
+  SQLLEN     *indicator_ptr;
+  SQLLEN      octet_length;
+  DESCREC    *rec;          /* the full record, NULL if it does not exist */
+  SQLSMALLINT concise_type;
+} DESC_HOT;
+
+#define HOT_IS_BOUND(h) ((h)->data_ptr || (h)->octet_length_ptr)
+
 
 /* Statement attributes */
 
@@ -338,6 +373,7 @@ typedef struct stmt_options
   SQLUINTEGER     bookmarks;
   void            *bookmark_ptr;
   my_bool         bookmark_insert;
+  SQLULEN         arrow_batch_size;
 } STMT_OPTIONS;
 
 
@@ -351,6 +387,12 @@ typedef struct	tagENV
 #ifdef THREAD
   myodbc_mutex_t lock;
 #endif
+  struct st_myodbc_workers *workers; /* created on first parallel fetch */
+  struct st_myodbc_hosts *hosts; /* health of the hosts of server lists */
+  struct st_myodbc_tls_sessions *tls_sessions; /* for TLS resumption */
+  struct st_myodbc_result_cache *result_cache; /* results of read-only queries */
+  struct st_myodbc_latency *latency; /* latency histograms of the entry points */
+  my_bool      latency_on;
 } ENV;
 
 
@@ -387,6 +429,13 @@ typedef struct tagDBC
   SQLULEN       sql_select_limit;   /* value of the sql_select_limit currently set for a session
                                        (SQLULEN)(-1) if wasn't set */
   int           need_to_wakeup;      /* Connection have been put to the pool */
+  struct st_catalog_fanout *fanout; /* auxiliary connections of catalog functions */
+  LIST          *stmt_pool;         /* dropped statements kept for reuse */
+  uint          stmt_pool_count;
+  LIST          *templates;         /* parsed queries, most recent first */
+  uint          template_count;
+  char          *latency_dump;      /* last dump read as an attribute */
+  char          *hosts_dump;        /* last host table read as an attribute */
 } DBC;
 
 
@@ -506,6 +555,9 @@ typedef struct tagSTMT
   MY_LIMIT_SCROLLER scroller;
 
   enum OUT_PARAM_STATE out_params_state;
+
+  struct st_read_ahead *read_ahead; /* rows read by a background thread */
+  struct st_keyset *keyset;         /* keys of a keyset-driven cursor */
 } STMT;
 
 
@@ -40,6 +40,7 @@
 SQLRETURN do_query(STMT *stmt,char *query, SQLULEN query_length)
 {
     int error= SQL_ERROR, native_error= 0;
+    my_bool keyset= FALSE;
 
     if (!query)
     {
@@ -66,6 +67,14 @@ SQLRETURN do_query(STMT *stmt,char *query, SQLULEN query_length)
 
     MYLOG_QUERY(stmt, "using do_query");
     MYLOG_QUERY(stmt, query);
+
+    if (stmt->dbc->ds->result_cache_ttl &&
+        result_cache_get(stmt, query, query_length))
+    {
+      error= SQL_SUCCESS;
+      goto skip_unlock_exit;
+    }
+
     myodbc_mutex_lock(&stmt->dbc->lock);
 
     if ( check_if_server_is_alive( stmt->dbc ) )
@@ -153,7 +162,10 @@ SQLRETURN do_query(STMT *stmt,char *query, SQLULEN query_length)
       goto exit;
     }
 
-    if (!get_result_metadata(stmt, FALSE))
+    /* A keyset cursor reads the rows only for their keys */
+    keyset= keyset_candidate(stmt);
+
+    if (!get_result_metadata(stmt, keyset))
     {
       /* Query was supposed to return result, but result is NULL*/
       if (returned_result(stmt))
@@ -198,6 +210,12 @@ SQLRETURN do_query(STMT *stmt,char *query, SQLULEN query_length)
       /* Caching row counts for queries returning resultset as well */
       //update_affected_rows(stmt);
       fix_result_types(stmt);
+
+      /* The keys are read before the connection is given to another stmt */
+      if (keyset && keyset_read(stmt) != SQL_SUCCESS)
+      {
+        goto exit;
+      }
     }
 
     error= SQL_SUCCESS;
@@ -205,6 +223,14 @@ SQLRETURN do_query(STMT *stmt,char *query, SQLULEN query_length)
 exit:
     myodbc_mutex_unlock(&stmt->dbc->lock);
 
+    /* Checking the key of the table takes the lock again, for SHOW KEYS */
+    if (keyset && error == SQL_SUCCESS && stmt->result)
+    {
+      error= keyset_verify(stmt, query, query_length);
+    }
+
+    result_cache_update(stmt, query, query_length, error);
+
 skip_unlock_exit:
     if (query != GET_QUERY(&stmt->query))
     {
@@ -225,6 +251,16 @@ skip_unlock_exit:
 }
 
 
+/*
+  Refresh the hot fields of the parameter descriptors for insert_params().
+*/
+static my_bool refresh_param_hot(STMT *stmt)
+{
+  return desc_hot_refresh(stmt->apd, stmt->param_count) ||
+         desc_hot_refresh(stmt->ipd, stmt->param_count);
+}
+
+
 /*
   @type    : myodbc3 internal
   @purpose : insert sql params at parameter positions
@@ -232,7 +268,9 @@ skip_unlock_exit:
   @param[in]      row         Parameters row
   @param[in,out]  finalquery  if NULL, final query is not copied
   @param[in,out]  length      Length of the query. Pointed value is used as initial offset
-  @comment : it allocates and modifies finalquery (when finalquery!=NULL),
+  @comment : the hot fields of the APD and IPD must have been refreshed for
+             the execution with refresh_param_hot().
+             it allocates and modifies finalquery (when finalquery!=NULL),
              so passing stmt->query->query can lead to memory leak.
 */
 
@@ -240,6 +278,8 @@ SQLRETURN insert_params(STMT *stmt, SQLULEN row, char **finalquery,
                         SQLULEN *finalquery_length)
 {
   char *query= GET_QUERY(&stmt->query), *to;
+  /* The literal segments of the query lie between the parameter markers */
+  uint *param_pos= (uint *)stmt->query.param_pos.buffer;
   uint i,length, had_info= 0;
   NET *net;
   SQLRETURN rc= SQL_SUCCESS;
@@ -259,10 +299,13 @@ SQLRETURN insert_params(STMT *stmt, SQLULEN row, char **finalquery,
     goto memerror;
   }
 
+  assert(stmt->apd->hot_count >= stmt->param_count &&
+         stmt->ipd->hot_count >= stmt->param_count);
+
   for ( i= 0; i < stmt->param_count; ++i )
   {
-    DESCREC *aprec= desc_get_rec(stmt->apd, i, FALSE);
-    DESCREC *iprec= desc_get_rec(stmt->ipd, i, FALSE);
+    DESCREC *aprec= stmt->apd->hot[i].rec;
+    DESCREC *iprec= stmt->ipd->hot[i].rec;
     char *pos;
     MYSQL_BIND * bind;
 
@@ -285,7 +328,7 @@ SQLRETURN insert_params(STMT *stmt, SQLULEN row, char **finalquery,
     }
     else
     {
-      pos= get_param_pos(&stmt->query, i);
+      pos= GET_QUERY(&stmt->query) + param_pos[i];
       length= (uint) (pos-query);
 
       if ( !(to= add_to_buffer(net,to,query,length)) )
@@ -1216,7 +1259,7 @@ SQLRETURN insert_param(STMT *stmt, uchar *place4param, DESC* apd,
           goto memerror;
         }
 
-        to+= mysql_real_escape_string(&dbc->mysql, to, data, length);
+        to+= myodbc_escape_value(&dbc->mysql, to, data, length);
         to= add_to_buffer(net, to, "'", 1);
       }
     }
@@ -1256,6 +1299,10 @@ SQLRETURN do_my_pos_cursor( STMT *pStmt, STMT *pStmtCursor )
       return set_stmt_error( pStmt, "HY000", "ER_INVALID_CURSOR_NAME", 0 );
   }
 
+  /* The rows of a keyset cursor can be read again, but not changed */
+  if ( pStmtCursor->keyset )
+      return set_error( pStmt, MYERR_S1C00, NULL, 0 );
+
   while ( isspace( *pszQuery ) )
       ++pszQuery;
 
@@ -1293,9 +1340,19 @@ SQLRETURN do_my_pos_cursor( STMT *pStmt, STMT *pStmtCursor )
 
 SQLRETURN SQL_API SQLExecute(SQLHSTMT hstmt)
 {
+  SQLRETURN rc;
+  ENV *env;
+  ulonglong start;
+
   CHECK_HANDLE(hstmt);
 
-  return my_SQLExecute((STMT *)hstmt);
+  env= ((STMT *)hstmt)->dbc->env;
+  start= LATENCY_BEGIN(env);
+
+  rc= my_SQLExecute((STMT *)hstmt);
+
+  LATENCY_END(env, LATENCY_EXECUTE, start);
+  return rc;
 }
 
 
@@ -1400,6 +1457,11 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
     *pStmt->ipd->rows_processed_ptr= 0;
   }
 
+  if (refresh_param_hot(pStmt))
+  {
+    return set_error(pStmt, MYERR_S1001, NULL, 4001);
+  }
+
   /* Locking if we have params array for "SELECT" statemnt */
   /* if param_count is zero, the rest probably are artifacts(not reset
      attributes) from a previously executed statement. besides this lock
@@ -1704,6 +1766,11 @@ static SQLRETURN execute_dae(STMT *stmt)
   {
   case DAE_NORMAL:
     query= GET_QUERY(&stmt->query);
+    if (refresh_param_hot(stmt))
+    {
+      rc= set_error(stmt, MYERR_S1001, NULL, 4001);
+      break;
+    }
     if (!SQL_SUCCEEDED(rc= insert_params(stmt, 0, &query, 0)))
       break;
     rc= do_query(stmt, query, 0);
@@ -119,6 +119,11 @@ SQLRETURN SQL_API SQLAllocEnv(SQLHENV *phenv)
 SQLRETURN SQL_API my_SQLFreeEnv(SQLHENV henv)
 {
     ENV *env= (ENV *) henv;
+    workers_destroy(env->workers);
+    hosts_free(env);
+    tls_sessions_free(env);
+    result_cache_free(env);
+    latency_free(env);
     myodbc_mutex_destroy(&env->lock);
 #ifndef _UNIX_
     GlobalUnlock(GlobalHandle((HGLOBAL) henv));
@@ -340,6 +345,8 @@ SQLRETURN SQL_API my_SQLFreeConnect(SQLHDBC hdbc)
     dbc->env->connections= list_delete(dbc->env->connections,&dbc->list);
     myodbc_mutex_unlock(&dbc->env->lock);
     x_free(dbc->database);
+    x_free(dbc->latency_dump);
+    x_free(dbc->hosts_dump);
     if (dbc->ds)
     {
       ds_delete(dbc->ds);
@@ -457,6 +464,147 @@ void delete_param_bind(DYNAMIC_ARRAY *param_bind)
 }
 
 
+/*
+  Free a statement handle and the descriptors and buffers it owns.
+*/
+static void stmt_free_handle(STMT *stmt)
+{
+  desc_free(stmt->imp_apd);
+  desc_free(stmt->imp_ard);
+  desc_free(stmt->ipd);
+  desc_free(stmt->ird);
+
+  x_free(stmt->cursor.name);
+
+  delete_parsed_query(&stmt->query);
+  delete_parsed_query(&stmt->orig_query);
+  delete_param_bind(stmt->param_bind);
+
+#ifndef _UNIX_
+  GlobalUnlock(GlobalHandle ((HGLOBAL) stmt));
+  GlobalFree(GlobalHandle((HGLOBAL) stmt));
+#else
+  x_free(stmt);
+#endif /* _UNIX_*/
+}
+
+
+/*
+  Take a statement from the pool of dropped statements of a connection.
+
+  @return The statement, linked to the connection, or NULL if the pool
+          is empty
+*/
+static STMT *stmt_pool_get(DBC *dbc)
+{
+  STMT *stmt= NULL;
+
+  myodbc_mutex_lock(&dbc->lock);
+  if (dbc->stmt_pool)
+  {
+    stmt= (STMT *)dbc->stmt_pool->data;
+    dbc->stmt_pool= list_delete(dbc->stmt_pool, &stmt->list);
+    --dbc->stmt_pool_count;
+    dbc->statements= list_add(dbc->statements, &stmt->list);
+  }
+  myodbc_mutex_unlock(&dbc->lock);
+
+  if (stmt)
+  {
+    stmt->stmt_options= dbc->stmt_options;
+    stmt->state= ST_UNKNOWN;
+    stmt->dummy_state= ST_DUMMY_UNKNOWN;
+    myodbc_stpmov(stmt->error.sqlstate, "00000");
+  }
+
+  return stmt;
+}
+
+
+/*
+  Park a dropped statement in the pool of its connection, up to the
+  STMT_POOL limit, keeping its descriptors and the memory of its arrays.
+
+  The statement must have been unlinked from the connection, with its
+  results and parameters freed.
+
+  @return TRUE if the statement was parked, FALSE if it has to be freed
+*/
+static my_bool stmt_pool_put(STMT *stmt)
+{
+  DBC *dbc= stmt->dbc;
+  uint limit= dbc->ds ? dbc->ds->stmt_pool : 0;
+  DESC *ard= stmt->imp_ard, *ird= stmt->ird, *apd= stmt->imp_apd,
+       *ipd= stmt->ipd;
+  MY_PARSED_QUERY query= stmt->query, orig_query= stmt->orig_query;
+  DYNAMIC_ARRAY *param_bind= stmt->param_bind;
+
+  if (!limit || stmt->ssps || dbc->stmt_pool_count >= limit)
+  {
+    return FALSE;
+  }
+
+  desc_reset(ard);
+  desc_reset(ird);
+  desc_reset(apd);
+  desc_reset(ipd);
+
+  free_root(&stmt->alloc_root, MYF(0));
+  x_free(stmt->cursor.name);
+  memset(stmt, 0, sizeof(STMT));
+
+  stmt->dbc= dbc;
+  stmt->list.data= stmt;
+  stmt->ard= stmt->imp_ard= ard;
+  stmt->apd= stmt->imp_apd= apd;
+  stmt->ird= ird;
+  stmt->ipd= ipd;
+  stmt->query= query;
+  stmt->orig_query= orig_query;
+  stmt->param_bind= param_bind;
+
+  myodbc_mutex_lock(&dbc->lock);
+  if (dbc->stmt_pool_count < limit)
+  {
+    dbc->stmt_pool= list_add(dbc->stmt_pool, &stmt->list);
+    ++dbc->stmt_pool_count;
+    stmt= NULL;
+  }
+  myodbc_mutex_unlock(&dbc->lock);
+
+  /* Another thread filled the pool in the meantime */
+  if (stmt)
+  {
+    stmt_free_handle(stmt);
+  }
+
+  return TRUE;
+}
+
+
+/*
+  Free the statements parked in the pool of a connection.
+*/
+void stmt_pool_flush(DBC *dbc)
+{
+  LIST *pool;
+
+  myodbc_mutex_lock(&dbc->lock);
+  pool= dbc->stmt_pool;
+  dbc->stmt_pool= NULL;
+  dbc->stmt_pool_count= 0;
+  myodbc_mutex_unlock(&dbc->lock);
+
+  while (pool)
+  {
+    STMT *stmt= (STMT *)pool->data;
+
+    pool= pool->next;
+    stmt_free_handle(stmt);
+  }
+}
+
+
 /*
   @type    : myodbc3 internal
   @purpose : allocates the statement handle
@@ -473,6 +621,11 @@ SQLRETURN SQL_API my_SQLAllocStmt(SQLHDBC hdbc,SQLHSTMT *phstmt)
     Keeping the check here to stay on the safe side */
   WAKEUP_CONN_IF_NEEDED(dbc);
 
+  if ((*phstmt= (SQLHSTMT)stmt_pool_get(dbc)))
+  {
+    return SQL_SUCCESS;
+  }
+
 #ifndef _UNIX_
   hstmt= GlobalAlloc(GMEM_MOVEABLE | GMEM_ZEROINIT, sizeof(STMT));
   if (!hstmt || (*phstmt= (SQLHSTMT)GlobalLock(hstmt)) == SQL_NULL_HSTMT)
@@ -667,6 +820,7 @@ SQLRETURN SQL_API my_SQLFreeStmtExtended(SQLHSTMT hstmt,SQLUSMALLINT fOption,
     stmt->cursor_row= -1;
     stmt->dae_type= 0;
     stmt->ird->count= 0;
+    desc_free_wstrs(stmt->ird);
 
     if (fOption == MYSQL_RESET_BUFFERS)
     {
@@ -732,30 +886,20 @@ SQLRETURN SQL_API my_SQLFreeStmtExtended(SQLHSTMT hstmt,SQLUSMALLINT fOption,
     /* explicitly allocated descriptors are affected up until this point */
     desc_remove_stmt(stmt->apd, stmt);
     desc_remove_stmt(stmt->ard, stmt);
-    desc_free(stmt->imp_apd);
-    desc_free(stmt->imp_ard);
-    desc_free(stmt->ipd);
-    desc_free(stmt->ird);
-
-    x_free(stmt->cursor.name);
-
-    delete_parsed_query(&stmt->query);
-    delete_parsed_query(&stmt->orig_query);
-    delete_param_bind(stmt->param_bind);
 
     myodbc_mutex_lock(&stmt->dbc->lock);
     stmt->dbc->statements= list_delete(stmt->dbc->statements,&stmt->list);
     myodbc_mutex_unlock(&stmt->dbc->lock);
-#ifndef _UNIX_
-    GlobalUnlock(GlobalHandle ((HGLOBAL) hstmt));
-    GlobalFree(GlobalHandle((HGLOBAL) hstmt));
-#else
-    x_free(hstmt);
-#endif /* _UNIX_*/
+
+    if (!clearAllResults || !stmt_pool_put(stmt))
+    {
+      stmt_free_handle(stmt);
+    }
     return SQL_SUCCESS;
 }
 
 
+
 /*
   Explicitly allocate a descriptor.
 */
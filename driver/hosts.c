@@ -0,0 +1,426 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  hosts.c
+  @brief Server lists: parsing, choice of the host to connect to and
+         health of the hosts.
+
+  The SERVER attribute can be a comma separated list of hosts, each with
+  an optional port ("host1:3307,host2,[::1]:3307"). The connect time and
+  the failures of each host are kept in the environment, so that all the
+  connections of the environment share them.
+*/
+
+#include "driver.h"
+
+/* Smoothing factor of the connect time average */
+#define HOSTS_RTT_WEIGHT 0.25
+
+/* Cap of the backoff of a failing host, as a power of 2 of the base delay */
+#define HOSTS_MAX_BACKOFF_SHIFT 6
+
+/* Default base delay, in seconds, before a failing host is tried again */
+#define HOSTS_DEFAULT_BACKOFF 5
+
+typedef struct
+{
+  char          name[HOSTNAME_LENGTH + 8]; /* "host:port" */
+  double        rtt;          /* smoothed connect time in ms, 0 if unknown */
+  uint          failures;     /* consecutive failures */
+  time_t        retry_after;  /* the host is avoided until then */
+} MYODBC_HOST_STAT;
+
+struct st_myodbc_hosts
+{
+  MYODBC_HOST_STAT *stats;
+  uint              count;
+  uint              alloced;
+  uint              next;     /* round robin position */
+};
+
+
+/**
+  Split a server list into hosts and ports.
+
+  @param[in]  list          Comma separated list of hosts
+  @param[in]  default_port  Port of the hosts without one
+  @param[out] hosts         Hosts found, strings point into buffer
+  @param[in]  max_hosts     Size of hosts
+  @param[out] buffer        Buffer for the host names, at least as big as
+                            list
+
+  @return Number of hosts found
+*/
+uint hosts_parse(const char *list, uint default_port, MYODBC_HOST *hosts,
+                 uint max_hosts, char *buffer)
+{
+  uint count= 0;
+
+  while (list && *list && count < max_hosts)
+  {
+    const char *end= strchr(list, ','), *colon= NULL, *host_end;
+    char *host= buffer;
+
+    if (!end)
+    {
+      end= list + strlen(list);
+    }
+
+    while (list < end && isspace(*list))
+    {
+      ++list;
+    }
+
+    /* IPv6 addresses are in brackets when followed by a port */
+    if (*list == '[')
+    {
+      ++list;
+      host_end= list;
+      while (host_end < end && *host_end != ']')
+      {
+        ++host_end;
+      }
+      if (host_end < end && host_end[1] == ':')
+      {
+        colon= host_end + 1;
+      }
+    }
+    else
+    {
+      const char *pos;
+
+      for (pos= list; pos < end; ++pos)
+      {
+        if (*pos == ':')
+        {
+          /* More than one colon is an IPv6 address without port */
+          colon= colon ? NULL : pos;
+          if (!colon)
+            break;
+        }
+      }
+      host_end= colon ? colon : end;
+    }
+
+    while (host_end > list && isspace(host_end[-1]))
+    {
+      --host_end;
+    }
+
+    if (host_end > list)
+    {
+      memcpy(host, list, host_end - list);
+      host[host_end - list]= '\0';
+      buffer+= host_end - list + 1;
+
+      hosts[count].host= host;
+      hosts[count].port= colon ? (uint)atoi(colon + 1) : 0;
+      if (!hosts[count].port)
+      {
+        hosts[count].port= default_port;
+      }
+      ++count;
+    }
+
+    list= *end ? end + 1 : end;
+  }
+
+  return count;
+}
+
+
+/**
+  Find the statistics of a host, adding them if needed.
+
+  Must be called with the environment lock held.
+*/
+static MYODBC_HOST_STAT *hosts_stat(ENV *env, const MYODBC_HOST *host)
+{
+  struct st_myodbc_hosts *hosts= env->hosts;
+  char name[HOSTNAME_LENGTH + 8];
+  uint i;
+
+  myodbc_snprintf(name, sizeof(name), "%s:%u", host->host, host->port);
+
+  if (!hosts)
+  {
+    hosts= (struct st_myodbc_hosts *)
+      myodbc_malloc(sizeof(struct st_myodbc_hosts), MYF(MY_ZEROFILL));
+    if (!hosts)
+    {
+      return NULL;
+    }
+    env->hosts= hosts;
+  }
+
+  for (i= 0; i < hosts->count; ++i)
+  {
+    if (!strcmp(hosts->stats[i].name, name))
+    {
+      return &hosts->stats[i];
+    }
+  }
+
+  if (hosts->count == hosts->alloced)
+  {
+    uint alloced= hosts->alloced ? hosts->alloced * 2 : 8;
+    MYODBC_HOST_STAT *stats= (MYODBC_HOST_STAT *)
+      myodbc_realloc(hosts->stats, alloced * sizeof(MYODBC_HOST_STAT),
+                     MYF(MY_ALLOW_ZERO_PTR));
+    if (!stats)
+    {
+      return NULL;
+    }
+    hosts->stats= stats;
+    hosts->alloced= alloced;
+  }
+
+  memset(&hosts->stats[hosts->count], 0, sizeof(MYODBC_HOST_STAT));
+  strmov(hosts->stats[hosts->count].name, name);
+
+  return &hosts->stats[hosts->count++];
+}
+
+
+/**
+  Get the load balancing strategy from its name.
+*/
+int hosts_strategy(const char *name)
+{
+  if (!name || !*name || !myodbc_strcasecmp(name, "failover"))
+    return HOSTS_FAILOVER;
+  if (!myodbc_strcasecmp(name, "round_robin"))
+    return HOSTS_ROUND_ROBIN;
+  if (!myodbc_strcasecmp(name, "random"))
+    return HOSTS_RANDOM;
+  if (!myodbc_strcasecmp(name, "latency"))
+    return HOSTS_LATENCY;
+
+  return -1;
+}
+
+
+/**
+  Decide in which order the hosts of a list are tried.
+
+  Hosts that failed recently are tried last, in the order of the end of
+  their backoff, so that a connection is still attempted when all the
+  hosts are down.
+
+  @param[in]  env       Environment sharing the host statistics
+  @param[in]  hosts     Hosts of the list
+  @param[in]  count     Number of hosts
+  @param[in]  strategy  HOSTS_FAILOVER, HOSTS_ROUND_ROBIN, HOSTS_RANDOM
+                        or HOSTS_LATENCY
+  @param[out] order     Indexes of the hosts, in the order to try them
+*/
+void hosts_order(ENV *env, const MYODBC_HOST *hosts, uint count,
+                 int strategy, uint *order)
+{
+  MYODBC_HOST_STAT *stats[HOSTS_MAX];
+  int index[HOSTS_MAX];
+  time_t now= time(NULL);
+  uint healthy= 0, down= count, i, j;
+
+  myodbc_mutex_lock(&env->lock);
+
+  /* Adding a host may move the statistics of the others */
+  for (i= 0; i < count; ++i)
+  {
+    MYODBC_HOST_STAT *stat= hosts_stat(env, &hosts[i]);
+
+    index[i]= stat ? (int)(stat - env->hosts->stats) : -1;
+  }
+
+  for (i= 0; i < count; ++i)
+  {
+    stats[i]= index[i] < 0 ? NULL : &env->hosts->stats[index[i]];
+
+    /* healthy hosts from the start, the others from the end */
+    if (!stats[i] || stats[i]->retry_after <= now)
+      order[healthy++]= i;
+    else
+      order[--down]= i;
+  }
+
+  switch (strategy)
+  {
+  case HOSTS_ROUND_ROBIN:
+    if (healthy > 1 && env->hosts)
+    {
+      uint first= env->hosts->next++ % healthy, rotated[HOSTS_MAX];
+
+      for (i= 0; i < healthy; ++i)
+        rotated[i]= order[(first + i) % healthy];
+      memcpy(order, rotated, healthy * sizeof(uint));
+    }
+    break;
+
+  case HOSTS_RANDOM:
+    for (i= healthy; i > 1; --i)
+    {
+      uint tmp;
+
+      j= (uint)rand() % i;
+      tmp= order[i - 1];
+      order[i - 1]= order[j];
+      order[j]= tmp;
+    }
+    break;
+
+  case HOSTS_LATENCY:
+    /* Hosts never measured come first, so that they get measured */
+    for (i= 1; i < healthy; ++i)
+    {
+      uint cur= order[i];
+      double rtt= stats[cur] ? stats[cur]->rtt : 0;
+
+      for (j= i; j > 0; --j)
+      {
+        uint prev= order[j - 1];
+
+        if ((stats[prev] ? stats[prev]->rtt : 0) <= rtt)
+          break;
+        order[j]= prev;
+      }
+      order[j]= cur;
+    }
+    break;
+
+  default:
+    break;
+  }
+
+  /* Failed hosts by the end of their backoff */
+  for (i= down + 1; i < count; ++i)
+  {
+    uint cur= order[i];
+
+    for (j= i; j > down && stats[order[j - 1]]->retry_after >
+                           stats[cur]->retry_after; --j)
+    {
+      order[j]= order[j - 1];
+    }
+    order[j]= cur;
+  }
+
+  myodbc_mutex_unlock(&env->lock);
+}
+
+
+/**
+  Record the outcome of a connection attempt to a host.
+
+  @param[in]  env       Environment sharing the host statistics
+  @param[in]  host      Host the attempt was made to
+  @param[in]  ok        Whether the connection succeeded
+  @param[in]  ms        Time taken by the attempt, in milliseconds
+  @param[in]  backoff   Base backoff delay in seconds, 0 for the default
+*/
+void hosts_report(ENV *env, const MYODBC_HOST *host, my_bool ok, double ms,
+                  uint backoff)
+{
+  MYODBC_HOST_STAT *stat;
+
+  myodbc_mutex_lock(&env->lock);
+
+  if ((stat= hosts_stat(env, host)))
+  {
+    if (ok)
+    {
+      stat->rtt= stat->rtt ? stat->rtt + HOSTS_RTT_WEIGHT * (ms - stat->rtt)
+                           : ms;
+      stat->failures= 0;
+      stat->retry_after= 0;
+    }
+    else
+    {
+      uint shift= myodbc_min(stat->failures, HOSTS_MAX_BACKOFF_SHIFT);
+
+      ++stat->failures;
+      stat->retry_after= time(NULL) +
+        (time_t)(backoff ? backoff : HOSTS_DEFAULT_BACKOFF) * (1 << shift);
+    }
+  }
+
+  myodbc_mutex_unlock(&env->lock);
+}
+
+
+/**
+  Write the statistics of the hosts of the environment as a table, one
+  line per host: name, consecutive failures, seconds left before the host
+  is tried again in order and smoothed connect time in milliseconds.
+
+  @param[in]  env   Environment sharing the host statistics
+  @param[out] out   String the table is appended to
+
+  @return TRUE if out of memory
+*/
+my_bool hosts_dump(ENV *env, DYNAMIC_STRING *out)
+{
+  char line[HOSTNAME_LENGTH + 64];
+  time_t now= time(NULL);
+  my_bool rc= FALSE;
+  uint i;
+
+  myodbc_snprintf(line, sizeof(line), "%-24s %8s %10s %10s\n", "host",
+                  "failures", "backoff_s", "rtt_ms");
+  if (dynstr_append(out, line))
+  {
+    return TRUE;
+  }
+
+  myodbc_mutex_lock(&env->lock);
+
+  for (i= 0; env->hosts && i < env->hosts->count && !rc; ++i)
+  {
+    const MYODBC_HOST_STAT *stat= &env->hosts->stats[i];
+
+    myodbc_snprintf(line, sizeof(line), "%-24s %8u %10ld %10.3f\n",
+                    stat->name, stat->failures,
+                    (long)myodbc_max(stat->retry_after - now, 0),
+                    stat->rtt);
+    rc= dynstr_append(out, line);
+  }
+
+  myodbc_mutex_unlock(&env->lock);
+
+  return rc;
+}
+
+
+/**
+  Free the host statistics of the environment.
+*/
+void hosts_free(ENV *env)
+{
+  if (env->hosts)
+  {
+    x_free(env->hosts->stats);
+    x_free(env->hosts);
+    env->hosts= NULL;
+  }
+}
@@ -381,8 +381,23 @@ MySQLGetInfo(SQLHDBC hdbc, SQLUSMALLINT fInfoType,
     MYINFO_SET_STR("N");
 
   case SQL_KEYSET_CURSOR_ATTRIBUTES1:
+    if (dbc->ds && !dbc->ds->force_use_of_forward_only_cursors &&
+        dbc->ds->keyset_cursor)
+      MYINFO_SET_ULONG(SQL_CA1_NEXT | SQL_CA1_ABSOLUTE | SQL_CA1_RELATIVE |
+                       SQL_CA1_LOCK_NO_CHANGE | SQL_CA1_POS_POSITION |
+                       SQL_CA1_POS_REFRESH);
+    else
+      MYINFO_SET_ULONG(0);
+
   case SQL_KEYSET_CURSOR_ATTRIBUTES2:
-    MYINFO_SET_ULONG(0);
+    if (dbc->ds && !dbc->ds->force_use_of_forward_only_cursors &&
+        dbc->ds->keyset_cursor)
+      MYINFO_SET_ULONG(SQL_CA2_READ_ONLY_CONCURRENCY |
+                       SQL_CA2_SENSITIVITY_DELETIONS |
+                       SQL_CA2_SENSITIVITY_UPDATES | SQL_CA2_MAX_ROWS_SELECT |
+                       SQL_CA2_CRC_EXACT);
+    else
+      MYINFO_SET_ULONG(0);
 
   case SQL_KEYWORDS:
     /*
@@ -687,6 +702,8 @@ MySQLGetInfo(SQLHDBC hdbc, SQLUSMALLINT fInfoType,
     MYINFO_SET_ULONG(SQL_SO_FORWARD_ONLY |
                      (dbc->ds && dbc->ds->force_use_of_forward_only_cursors ?
                       0 : SQL_SO_STATIC |
+                     (dbc->ds && dbc->ds->keyset_cursor ?
+                      SQL_SO_KEYSET_DRIVEN : 0) |
                      (dbc->ds && dbc->ds->dynamic_cursor ? SQL_SO_DYNAMIC : 0)));
 
   case SQL_SEARCH_PATTERN_ESCAPE:
@@ -0,0 +1,707 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  keyset.c
+  @brief Keyset-driven cursors keeping only the keys of the rows.
+
+  With KEYSET_CURSOR set, a statement with the SQL_CURSOR_KEYSET_DRIVEN
+  cursor type that selects columns of a single table, the primary key
+  included, reads its result row by row and keeps only the literals of the
+  keys. Each rowset is then read again from the table with one query per
+  KEYSET_LOOKUP_BATCH keys, WHERE key IN (...), so that a fetch shows the
+  current values of the rows and the rows deleted since the execution.
+
+  The memory used by the cursor is bounded by the size of the keys, not
+  by the size of the rows. When the key fields of the result do not make
+  a whole primary key of the table, the query is run again and the cursor
+  behaves like a static one.
+*/
+
+#include "driver.h"
+
+/* Number of keys looked up by one query */
+#define KEYSET_LOOKUP_BATCH 256
+
+typedef struct
+{
+  char   *data;
+  size_t  used;
+  size_t  size;
+} KEYSET_BUFFER;
+
+struct st_keyset
+{
+  DBC            *dbc;
+  uint            fields;
+  uint            key_count;
+  uint            key_fields[MY_MAX_PK_PARTS]; /* indexes in the result */
+  /* charset of the key field, NULL for a number */
+  const char     *key_charsets[MY_MAX_PK_PARTS];
+
+  /* literals of the keys, the key of row i ends where the one of i+1 starts */
+  KEYSET_BUFFER   keys;
+  size_t         *offsets;
+  my_ulonglong    rows;
+  my_ulonglong    offsets_size;
+
+  DYNAMIC_STRING  select;       /* lookup query up to the list of keys */
+  KEYSET_BUFFER   scratch;      /* key of a row read by a lookup */
+
+  /* rows read by the last lookup */
+  MYSQL_RES     **results;
+  uint            result_count;
+  my_ulonglong    first;
+  SQLULEN         count;
+  SQLULEN         window_size;
+  MYSQL_ROW      *window;       /* NULL for a row that has been deleted */
+  ulong          *lengths;
+
+  my_ulonglong    position;     /* row returned by the next fetch */
+  ulong          *current;      /* lengths of the row returned last */
+};
+
+
+/**
+  Check whether the result of a query that has just been executed can be
+  read through a keyset. The result must come from a single table, with
+  columns and no expressions, and have the fields of the primary key.
+
+  @return TRUE if keyset_read() is to be called once the result has been
+          opened without being stored
+*/
+my_bool keyset_candidate(STMT *stmt)
+{
+  MYSQL *mysql= &stmt->dbc->mysql;
+  MYSQL_FIELD *fields= mysql->fields;
+  uint i, keys= 0;
+
+  /* The query may be run again when the keyset cannot be used */
+  if (!if_keyset_cursor(stmt) || !stmt->dbc->ds->keyset_cursor ||
+      ssps_used(stmt) || !fields || !mysql->field_count ||
+      (mysql->server_status & SERVER_MORE_RESULTS_EXISTS))
+  {
+    return FALSE;
+  }
+
+  for (i= 0; i < mysql->field_count; ++i)
+  {
+    MYSQL_FIELD *field= fields + i;
+
+    if (!field->db || !*field->db || !field->org_table ||
+        !*field->org_table || !field->org_name || !*field->org_name ||
+        strcmp(field->db, fields->db) ||
+        strcmp(field->org_table, fields->org_table))
+    {
+      return FALSE;
+    }
+
+    /* Approximate and bit values do not make reliable literals */
+    if (field->flags & PRI_KEY_FLAG)
+    {
+      if (!(field->flags & NOT_NULL_FLAG) ||
+          field->type == MYSQL_TYPE_FLOAT ||
+          field->type == MYSQL_TYPE_DOUBLE ||
+          field->type == MYSQL_TYPE_BIT || ++keys > MY_MAX_PK_PARTS)
+      {
+        return FALSE;
+      }
+    }
+  }
+
+  return keys > 0;
+}
+
+
+static my_bool keyset_reserve(KEYSET_BUFFER *buf, size_t size)
+{
+  if (buf->used + size > buf->size)
+  {
+    size_t new_size= myodbc_max(myodbc_max(buf->size * 2, 4096),
+                                buf->used + size);
+    char *data= (char *)myodbc_realloc(buf->data, new_size,
+                                       MYF(MY_ALLOW_ZERO_PTR));
+    if (!data)
+    {
+      return TRUE;
+    }
+    buf->data= data;
+    buf->size= new_size;
+  }
+  return FALSE;
+}
+
+
+/**
+  Append the literal of the key of a row to a buffer: the value of the key
+  field, or the values of the key fields in parentheses.
+
+  A string is written in hex with the introducer of the charset of its
+  field, _latin1 X'E9', so that the lookup compares the bytes the server
+  sent whatever the charset of the connection.
+
+  @return TRUE if out of memory
+*/
+static my_bool keyset_append_key(KEYSET *ks, MYSQL_ROW row, ulong *lengths,
+                                 KEYSET_BUFFER *buf)
+{
+  static const char hex[]= "0123456789ABCDEF";
+  size_t size= 2;
+  char *to;
+  uint i;
+
+  /* Room for a hex value, introducer, quotes, separator and null byte */
+  for (i= 0; i < ks->key_count; ++i)
+  {
+    size+= (size_t)lengths[ks->key_fields[i]] * 2 + 6;
+    if (ks->key_charsets[i])
+    {
+      size+= strlen(ks->key_charsets[i]) + 1;
+    }
+  }
+
+  if (keyset_reserve(buf, size))
+  {
+    return TRUE;
+  }
+
+  to= buf->data + buf->used;
+  if (ks->key_count > 1)
+  {
+    *to++= '(';
+  }
+
+  for (i= 0; i < ks->key_count; ++i)
+  {
+    const char *value= row[ks->key_fields[i]];
+    ulong length= lengths[ks->key_fields[i]], j;
+
+    if (i)
+    {
+      *to++= ',';
+    }
+
+    if (!value)
+    {
+      to= myodbc_stpmov(to, "NULL");
+      continue;
+    }
+
+    if (!ks->key_charsets[i])
+    {
+      memcpy(to, value, length);
+      to+= length;
+      continue;
+    }
+
+    *to++= '_';
+    to= myodbc_stpmov(to, ks->key_charsets[i]);
+    *to++= ' ';
+    *to++= 'X';
+    *to++= '\'';
+    for (j= 0; j < length; ++j)
+    {
+      *to++= hex[(uchar)value[j] >> 4];
+      *to++= hex[(uchar)value[j] & 0x0F];
+    }
+    *to++= '\'';
+  }
+
+  if (ks->key_count > 1)
+  {
+    *to++= ')';
+  }
+
+  buf->used= to - buf->data;
+  return FALSE;
+}
+
+
+/**
+  Keep the key of the next row of the result.
+
+  @return TRUE if out of memory
+*/
+static my_bool keyset_add(KEYSET *ks, MYSQL_ROW row, ulong *lengths)
+{
+  if (ks->rows + 2 > ks->offsets_size)
+  {
+    my_ulonglong new_size= myodbc_max(ks->offsets_size * 2, 1024);
+    size_t *offsets= (size_t *)myodbc_realloc(ks->offsets,
+                                              (size_t)new_size *
+                                              sizeof(size_t),
+                                              MYF(MY_ALLOW_ZERO_PTR));
+    if (!offsets)
+    {
+      return TRUE;
+    }
+    ks->offsets= offsets;
+    ks->offsets_size= new_size;
+  }
+
+  ks->offsets[ks->rows]= ks->keys.used;
+  if (keyset_append_key(ks, row, lengths, &ks->keys))
+  {
+    return TRUE;
+  }
+  ks->offsets[++ks->rows]= ks->keys.used;
+
+  return FALSE;
+}
+
+
+static void keyset_window_free(KEYSET *ks)
+{
+  uint i;
+
+  for (i= 0; i < ks->result_count; ++i)
+  {
+    mysql_free_result(ks->results[i]);
+  }
+  ks->result_count= 0;
+  ks->count= 0;
+  ks->current= NULL;
+}
+
+
+static void keyset_delete(KEYSET *ks)
+{
+  if (!ks)
+  {
+    return;
+  }
+
+  keyset_window_free(ks);
+  x_free(ks->results);
+  x_free(ks->window);
+  x_free(ks->lengths);
+  x_free(ks->keys.data);
+  x_free(ks->scratch.data);
+  x_free(ks->offsets);
+  dynstr_free(&ks->select);
+  x_free(ks);
+}
+
+
+/**
+  Allocate a keyset for the result of a statement and prepare the start of
+  its lookup query.
+
+  @return The keyset, or NULL if out of memory or if the charset of a key
+          field is unknown
+*/
+static KEYSET *keyset_new(STMT *stmt)
+{
+  MYSQL_RES *result= stmt->result;
+  MYSQL_FIELD *fields= result->fields;
+  DYNAMIC_STRING *select;
+  KEYSET *ks;
+  my_bool oom;
+  uint i;
+
+  ks= (KEYSET *)myodbc_malloc(sizeof(KEYSET), MYF(MY_ZEROFILL));
+  if (!ks)
+  {
+    return NULL;
+  }
+  ks->dbc= stmt->dbc;
+  ks->fields= result->field_count;
+  select= &ks->select;
+
+  oom= init_dynamic_string(select, "SELECT ", 1024, 1024);
+
+  for (i= 0; !oom && i < ks->fields; ++i)
+  {
+    oom= (i && dynstr_append_mem(select, ",", 1)) ||
+         dynstr_append_quoted_name(select, fields[i].org_name);
+
+    if ((fields[i].flags & PRI_KEY_FLAG) && ks->key_count < MY_MAX_PK_PARTS)
+    {
+      if (!is_numeric_mysql_type(fields + i))
+      {
+        CHARSET_INFO *charset= get_charset(fields[i].charsetnr, MYF(0));
+
+        if (!charset)
+        {
+          keyset_delete(ks);
+          return NULL;
+        }
+        ks->key_charsets[ks->key_count]= charset->csname;
+      }
+      ks->key_fields[ks->key_count++]= i;
+    }
+  }
+
+  oom= oom || dynstr_append_mem(select, " FROM ", 6) ||
+       dynstr_append_quoted_name(select, fields->db) ||
+       dynstr_append_mem(select, ".", 1) ||
+       dynstr_append_quoted_name(select, fields->org_table) ||
+       dynstr_append_mem(select, " WHERE ", 7) ||
+       (ks->key_count > 1 && dynstr_append_mem(select, "(", 1));
+
+  for (i= 0; !oom && i < ks->key_count; ++i)
+  {
+    oom= (i && dynstr_append_mem(select, ",", 1)) ||
+         dynstr_append_quoted_name(select,
+                                   fields[ks->key_fields[i]].org_name);
+  }
+
+  oom= oom || (ks->key_count > 1 && dynstr_append_mem(select, ")", 1)) ||
+       dynstr_append_mem(select, " IN (", 5);
+
+  if (oom)
+  {
+    keyset_delete(ks);
+    return NULL;
+  }
+
+  return ks;
+}
+
+
+/**
+  Check that the key fields of the result are all the fields of the
+  primary key of the table, as SHOW KEYS tells.
+*/
+static my_bool keyset_key_verified(STMT *stmt, KEYSET *ks)
+{
+  uint i, j;
+
+  if (!check_if_usable_unique_key_exists(stmt) ||
+      stmt->cursor.pk_count != ks->key_count)
+  {
+    return FALSE;
+  }
+
+  for (i= 0; i < stmt->cursor.pk_count; ++i)
+  {
+    for (j= 0; j < ks->key_count; ++j)
+    {
+      if (!myodbc_strcasecmp(stmt->cursor.pkcol[i].name,
+                             stmt->result->fields[ks->key_fields[j]].org_name))
+      {
+        break;
+      }
+    }
+
+    if (j == ks->key_count)
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+
+/**
+  Run the query again and store its whole result, for a statement that
+  cannot use a keyset.
+*/
+static SQLRETURN keyset_fallback(STMT *stmt, char *query,
+                                 SQLULEN query_length)
+{
+  DBC *dbc= stmt->dbc;
+  SQLRETURN rc= SQL_SUCCESS;
+
+  /* An error of SHOW KEYS only means that the key could not be checked */
+  CLEAR_STMT_ERROR(stmt);
+
+  myodbc_mutex_lock(&dbc->lock);
+  mysql_free_result(stmt->result);
+  stmt->result= NULL;
+
+  if (exec_stmt_query(stmt, query, query_length, FALSE) ||
+      !(stmt->result= mysql_store_result(&dbc->mysql)))
+  {
+    rc= set_error(stmt, MYERR_S1000, mysql_error(&dbc->mysql),
+                  mysql_errno(&dbc->mysql));
+  }
+  myodbc_mutex_unlock(&dbc->lock);
+
+  if (rc == SQL_SUCCESS)
+  {
+    fix_result_types(stmt);
+  }
+
+  return rc;
+}
+
+
+/**
+  Read the keys of the result of a statement that keyset_candidate()
+  accepted, the result being opened with mysql_use_result().
+
+  Must be called with the connection lock held, so that no other statement
+  uses the connection before the whole result has been read.
+
+  @param[in] stmt          Statement
+
+  @return SQL_SUCCESS, with stmt->keyset set unless the keys could not be
+          kept, or SQL_ERROR
+*/
+SQLRETURN keyset_read(STMT *stmt)
+{
+  DBC *dbc= stmt->dbc;
+  MYSQL_RES *result= stmt->result;
+  KEYSET *ks= keyset_new(stmt);
+  MYSQL_ROW row;
+
+  /* Out of memory, the rows are still read to leave the connection usable */
+  while ((row= mysql_fetch_row(result)))
+  {
+    if (ks && keyset_add(ks, row, mysql_fetch_lengths(result)))
+    {
+      keyset_delete(ks);
+      ks= NULL;
+    }
+  }
+
+  if (mysql_errno(&dbc->mysql))
+  {
+    keyset_delete(ks);
+    return set_error(stmt, MYERR_S1000, mysql_error(&dbc->mysql),
+                     mysql_errno(&dbc->mysql));
+  }
+
+  stmt->keyset= ks;
+  return SQL_SUCCESS;
+}
+
+
+/**
+  Check the keys read by keyset_read() against the primary key of the
+  table, or run the query again for a static cursor when the keyset cannot
+  be used.
+
+  Must be called without the connection lock, which is taken for SHOW KEYS
+  and for the query run again.
+
+  @param[in] stmt          Statement
+  @param[in] query         Query that has been executed
+  @param[in] query_length  Length of the query
+
+  @return SQL_SUCCESS, with stmt->keyset set unless the statement falls
+          back to a static cursor, or SQL_ERROR
+*/
+SQLRETURN keyset_verify(STMT *stmt, char *query, SQLULEN query_length)
+{
+  if (stmt->keyset && keyset_key_verified(stmt, stmt->keyset))
+  {
+    return SQL_SUCCESS;
+  }
+
+  keyset_delete(stmt->keyset);
+  stmt->keyset= NULL;
+  return keyset_fallback(stmt, query, query_length);
+}
+
+
+static my_bool keyset_window_alloc(KEYSET *ks, SQLULEN count)
+{
+  if (count > ks->window_size)
+  {
+    x_free(ks->results);
+    x_free(ks->window);
+    x_free(ks->lengths);
+    ks->window_size= 0;
+
+    ks->results= (MYSQL_RES **)
+      myodbc_malloc(sizeof(MYSQL_RES *) * (count / KEYSET_LOOKUP_BATCH + 1),
+                    MYF(0));
+    ks->window= (MYSQL_ROW *)myodbc_malloc(sizeof(MYSQL_ROW) * count,
+                                           MYF(0));
+    ks->lengths= (ulong *)myodbc_malloc(sizeof(ulong) * count * ks->fields,
+                                        MYF(0));
+    if (!ks->results || !ks->window || !ks->lengths)
+    {
+      x_free(ks->results);
+      x_free(ks->window);
+      x_free(ks->lengths);
+      return TRUE;
+    }
+    ks->window_size= count;
+  }
+
+  if (count)
+  {
+    memset(ks->window, 0, sizeof(MYSQL_ROW) * count);
+  }
+  return FALSE;
+}
+
+
+/**
+  Read from the table the current values of the rows of a rowset. A row
+  whose key is not found anymore is returned as deleted by keyset_fetch().
+
+  @param[in] stmt   Statement with a keyset
+  @param[in] first  First row of the rowset
+  @param[in] count  Number of rows, within the keyset
+
+  @return SQL_SUCCESS or SQL_ERROR
+*/
+SQLRETURN keyset_load(STMT *stmt, my_ulonglong first, SQLULEN count)
+{
+  KEYSET *ks= stmt->keyset;
+  DBC *dbc= stmt->dbc;
+  DYNAMIC_STRING query;
+  my_ulonglong batch, end, i;
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  SQLRETURN rc;
+
+  keyset_window_free(ks);
+
+  if (first >= ks->rows)
+  {
+    count= 0;
+  }
+  else if (count > ks->rows - first)
+  {
+    count= (SQLULEN)(ks->rows - first);
+  }
+
+  if (keyset_window_alloc(ks, count))
+  {
+    return set_error(stmt, MYERR_S1001, NULL, 4001);
+  }
+  ks->first= first;
+  ks->count= count;
+
+  for (batch= first; batch < first + count; batch= end)
+  {
+    end= myodbc_min(batch + KEYSET_LOOKUP_BATCH, first + count);
+
+    /* Sized for the whole query, an initial string would shrink the size */
+    if (init_dynamic_string(&query, NULL, ks->select.length +
+                            (size_t)(ks->offsets[end] - ks->offsets[batch]) +
+                            (size_t)(end - batch) + 2, 1024) ||
+        dynstr_append_mem(&query, ks->select.str, ks->select.length))
+    {
+      dynstr_free(&query);
+      return set_error(stmt, MYERR_S1001, NULL, 4001);
+    }
+
+    for (i= batch; i < end; ++i)
+    {
+      if (i > batch)
+      {
+        dynstr_append_mem(&query, ",", 1);
+      }
+      dynstr_append_mem(&query, ks->keys.data + ks->offsets[i],
+                        ks->offsets[i + 1] - ks->offsets[i]);
+    }
+    dynstr_append_mem(&query, ")", 1);
+
+    myodbc_mutex_lock(&dbc->lock);
+    if (exec_stmt_query(stmt, query.str, query.length, FALSE) ||
+        !(res= mysql_store_result(&dbc->mysql)))
+    {
+      rc= set_error(stmt, MYERR_S1000, mysql_error(&dbc->mysql),
+                    mysql_errno(&dbc->mysql));
+      myodbc_mutex_unlock(&dbc->lock);
+      dynstr_free(&query);
+      return rc;
+    }
+    myodbc_mutex_unlock(&dbc->lock);
+    dynstr_free(&query);
+
+    ks->results[ks->result_count++]= res;
+
+    /* Rows come back in any order, they are put at the place of their key */
+    while ((row= mysql_fetch_row(res)))
+    {
+      ulong *lengths= mysql_fetch_lengths(res);
+
+      ks->scratch.used= 0;
+      if (keyset_append_key(ks, row, lengths, &ks->scratch))
+      {
+        return set_error(stmt, MYERR_S1001, NULL, 4001);
+      }
+
+      for (i= batch; i < end; ++i)
+      {
+        if (ks->offsets[i + 1] - ks->offsets[i] == ks->scratch.used &&
+            !memcmp(ks->keys.data + ks->offsets[i], ks->scratch.data,
+                    ks->scratch.used))
+        {
+          ks->window[i - first]= row;
+          memcpy(ks->lengths + (size_t)(i - first) * ks->fields, lengths,
+                 sizeof(ulong) * ks->fields);
+        }
+      }
+    }
+  }
+
+  return SQL_SUCCESS;
+}
+
+
+/**
+  Get the next row of the keyset, as read by the last keyset_load().
+
+  @return The row, or NULL if it has been deleted or was not loaded
+*/
+MYSQL_ROW keyset_fetch(KEYSET *ks)
+{
+  my_ulonglong row= ks->position++;
+
+  if (row < ks->first || row >= ks->first + ks->count)
+  {
+    ks->current= NULL;
+    return NULL;
+  }
+
+  ks->current= ks->lengths + (size_t)(row - ks->first) * ks->fields;
+  return ks->window[row - ks->first];
+}
+
+
+ulong *keyset_lengths(KEYSET *ks)
+{
+  return ks->current;
+}
+
+
+my_ulonglong keyset_rows(KEYSET *ks)
+{
+  return ks->rows;
+}
+
+
+void keyset_seek(KEYSET *ks, my_ulonglong row)
+{
+  ks->position= row;
+}
+
+
+/**
+  Free the keyset of a statement, if any.
+*/
+void keyset_free(STMT *stmt)
+{
+  keyset_delete(stmt->keyset);
+  stmt->keyset= NULL;
+}
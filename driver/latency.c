@@ -0,0 +1,741 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  latency.c
+  @brief Latency histograms of the main entry points of the driver.
+
+  Each thread that calls an instrumented function gets its own block of
+  histograms, one per function, found through a thread-local key shared
+  by all the environments. Recording then takes no lock: the thread only
+  adds to its own counters. A dump merges the blocks under the environment
+  lock and may miss the calls that are being recorded at the same time.
+
+  The histograms are log-linear like HDR histograms: every power of two is
+  split into LATENCY_SUB_COUNT buckets, so that a bucket is never wider
+  than a quarter of its lower bound, from 1 ns up to about 18 minutes.
+
+  The block of a thread goes back to the environment when the thread ends,
+  for the next new thread to carry on with. Past LATENCY_BLOCKS_MAX threads
+  at a time, or on Windows where thread-local destructors are not run,
+  threads share blocks, and two of them recording at the same time into
+  the same histogram may lose a count.
+
+  A thread may end while an environment it recorded into is being freed,
+  so the users of the blocks are counted under latency_lock, which belongs
+  to no environment. An environment being freed frees its blocks that have
+  no users left, and leaves the others to the last of their threads.
+*/
+
+#include "driver.h"
+#include "myodbc_latency.h"
+#include "../include/sys/my_thread_local.h"
+
+#ifdef _WIN32
+# include <intrin.h>
+#else
+# include <time.h>
+#endif
+
+#define LATENCY_SUB_BITS   2
+#define LATENCY_SUB_COUNT  (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_EXP    40   /* 2^40 ns and more go in the last bucket */
+#define LATENCY_BUCKETS    ((LATENCY_MAX_EXP - LATENCY_SUB_BITS + 1) * \
+                            LATENCY_SUB_COUNT)
+#define LATENCY_BLOCKS_MAX 256
+#define LATENCY_THREAD_ENVS 4   /* environments a thread keeps blocks of */
+
+typedef struct
+{
+  ulonglong count;
+  ulonglong sum;
+  ulonglong max;
+  ulonglong buckets[LATENCY_BUCKETS];
+} LATENCY_HISTOGRAM;
+
+typedef struct
+{
+  uint               users;     /* threads recording into the block */
+  my_bool            orphan;    /* its environment is freed */
+  LATENCY_HISTOGRAM  functions[LATENCY_FUNCTIONS];
+} LATENCY_BLOCK;
+
+/* Blocks of a thread, by id of the statistics of their environment */
+typedef struct
+{
+  ulonglong          ids[LATENCY_THREAD_ENVS];
+  LATENCY_BLOCK     *blocks[LATENCY_THREAD_ENVS];
+} LATENCY_THREAD;
+
+struct st_myodbc_latency
+{
+  ulonglong          id;        /* never reused in the process */
+  LATENCY_BLOCK    **blocks;
+  uint               block_count;
+  uint               next_shared;
+  char              *dump_path;
+};
+
+/*
+  Guards the users and orphan fields of the blocks and the key below. The
+  key exists while an environment has statistics.
+*/
+static native_mutex_t latency_lock;
+static my_thread_once_t latency_once= MY_THREAD_ONCE_INIT;
+static thread_local_key_t latency_key;
+static uint latency_envs= 0;
+static ulonglong latency_last_id= 0;
+
+static const char *latency_names[LATENCY_FUNCTIONS]=
+{
+  "SQLConnect", "SQLDriverConnect", "SQLPrepare", "SQLExecute",
+  "SQLExecDirect", "SQLFetch", "SQLFetchScroll", "SQLGetData",
+  "SQLColumns", "SQLTables"
+};
+
+
+/**
+  Monotonic time in nanoseconds.
+*/
+ulonglong latency_now(void)
+{
+#ifdef _WIN32
+  static LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+
+  if (!frequency.QuadPart)
+  {
+    QueryPerformanceFrequency(&frequency);
+  }
+  QueryPerformanceCounter(&counter);
+
+  return (ulonglong)(counter.QuadPart / frequency.QuadPart) * 1000000000 +
+         (ulonglong)(counter.QuadPart % frequency.QuadPart) * 1000000000 /
+         frequency.QuadPart;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (ulonglong)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+
+static uint latency_log2(ulonglong value)
+{
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(value);
+#elif defined(_WIN64)
+  unsigned long index;
+
+  _BitScanReverse64(&index, value);
+  return (uint)index;
+#else
+  uint index= 0;
+
+  while (value >>= 1)
+  {
+    ++index;
+  }
+  return index;
+#endif
+}
+
+
+static uint latency_bucket(ulonglong value)
+{
+  uint exp;
+
+  if (value < LATENCY_SUB_COUNT)
+  {
+    return (uint)value;
+  }
+
+  exp= latency_log2(value);
+  if (exp >= LATENCY_MAX_EXP)
+  {
+    return LATENCY_BUCKETS - 1;
+  }
+
+  return (exp - LATENCY_SUB_BITS + 1) * LATENCY_SUB_COUNT +
+         (uint)((value >> (exp - LATENCY_SUB_BITS)) & (LATENCY_SUB_COUNT - 1));
+}
+
+
+/**
+  Lower and upper bounds, in nanoseconds, of the values of a bucket.
+*/
+static void latency_bucket_range(uint bucket, ulonglong *low, ulonglong *high)
+{
+  uint exp, sub;
+
+  if (bucket < LATENCY_SUB_COUNT)
+  {
+    *low= *high= bucket;
+    return;
+  }
+
+  exp= bucket / LATENCY_SUB_COUNT + LATENCY_SUB_BITS - 1;
+  sub= bucket % LATENCY_SUB_COUNT;
+  *low= (ulonglong)(LATENCY_SUB_COUNT + sub) << (exp - LATENCY_SUB_BITS);
+  *high= bucket == LATENCY_BUCKETS - 1 ? ~(ulonglong)0
+         : *low + ((ulonglong)1 << (exp - LATENCY_SUB_BITS)) - 1;
+}
+
+
+static void latency_lock_init()
+{
+  native_mutex_init(&latency_lock, NULL);
+}
+
+
+/**
+  Give a block back, freeing it if its environment is gone and no other
+  thread uses it. Called with latency_lock held.
+*/
+static void latency_release(LATENCY_BLOCK *block)
+{
+#ifndef _WIN32
+  if (!--block->users && block->orphan)
+  {
+    x_free(block);
+  }
+#endif
+}
+
+
+/**
+  Give all the blocks of a thread back and free its list. Called with
+  latency_lock held.
+*/
+static void latency_detach_locked(LATENCY_THREAD *thread)
+{
+  uint i;
+
+  for (i= 0; i < LATENCY_THREAD_ENVS; ++i)
+  {
+    if (thread->ids[i])
+    {
+      latency_release(thread->blocks[i]);
+    }
+  }
+
+  x_free(thread);
+}
+
+
+/**
+  Thread-local destructor, gives the blocks of an ending thread back.
+*/
+static void latency_detach(void *arg)
+{
+  native_mutex_lock(&latency_lock);
+  latency_detach_locked((LATENCY_THREAD *)arg);
+  native_mutex_unlock(&latency_lock);
+}
+
+
+/**
+  Find a block for the calling thread: a block no thread uses any more, a
+  new one, or past LATENCY_BLOCKS_MAX one shared with other threads.
+
+  @param[in] env     Environment
+  @param[in] thread  Blocks of the thread, NULL if it has none yet
+
+  @return The block, or NULL if out of memory
+*/
+static LATENCY_BLOCK *latency_attach(ENV *env, LATENCY_THREAD *thread)
+{
+  struct st_myodbc_latency *latency= env->latency;
+  LATENCY_BLOCK *block= NULL;
+  uint i, slot= LATENCY_THREAD_ENVS - 1;
+
+  myodbc_mutex_lock(&env->lock);
+  native_mutex_lock(&latency_lock);
+
+  if (!thread)
+  {
+    thread= (LATENCY_THREAD *)myodbc_malloc(sizeof(LATENCY_THREAD),
+                                            MYF(MY_ZEROFILL));
+    if (!thread || my_set_thread_local(latency_key, thread))
+    {
+      x_free(thread);
+      native_mutex_unlock(&latency_lock);
+      myodbc_mutex_unlock(&env->lock);
+      return NULL;
+    }
+  }
+
+  /*
+    A free slot, or one of an environment freed since, or the last one. On
+    Windows the block of a freed environment is gone, and is not looked at.
+  */
+  for (i= 0; i < LATENCY_THREAD_ENVS; ++i)
+  {
+#ifndef _WIN32
+    if (!thread->ids[i] || thread->blocks[i]->orphan)
+#else
+    if (!thread->ids[i])
+#endif
+    {
+      slot= i;
+      break;
+    }
+  }
+
+  for (i= 0; i < latency->block_count && !block; ++i)
+  {
+    if (!latency->blocks[i]->users)
+    {
+      block= latency->blocks[i];
+    }
+  }
+
+  if (!block && latency->block_count < LATENCY_BLOCKS_MAX)
+  {
+    block= (LATENCY_BLOCK *)myodbc_malloc(sizeof(LATENCY_BLOCK),
+                                          MYF(MY_ZEROFILL));
+    if (block)
+    {
+      latency->blocks[latency->block_count++]= block;
+    }
+  }
+
+  if (!block && latency->block_count)
+  {
+    block= latency->blocks[latency->next_shared++ % latency->block_count];
+  }
+
+  if (block)
+  {
+    if (thread->ids[slot])
+    {
+      latency_release(thread->blocks[slot]);
+    }
+    ++block->users;
+    thread->ids[slot]= latency->id;
+    thread->blocks[slot]= block;
+  }
+
+  native_mutex_unlock(&latency_lock);
+  myodbc_mutex_unlock(&env->lock);
+  return block;
+}
+
+
+/**
+  Record the time spent in a function since start.
+*/
+void latency_record(ENV *env, LATENCY_FUNCTION func, ulonglong start)
+{
+  ulonglong now= latency_now();
+  ulonglong elapsed= now > start ? now - start : 0;
+  LATENCY_THREAD *thread= (LATENCY_THREAD *)my_get_thread_local(latency_key);
+  LATENCY_BLOCK *block= NULL;
+  LATENCY_HISTOGRAM *hist;
+  uint i;
+
+  for (i= 0; thread && i < LATENCY_THREAD_ENVS && !block; ++i)
+  {
+    if (thread->ids[i] == env->latency->id)
+    {
+      block= thread->blocks[i];
+    }
+  }
+
+  if (!block && !(block= latency_attach(env, thread)))
+  {
+    return;
+  }
+
+  hist= &block->functions[func];
+  ++hist->count;
+  hist->sum+= elapsed;
+  if (elapsed > hist->max)
+  {
+    hist->max= elapsed;
+  }
+  ++hist->buckets[latency_bucket(elapsed)];
+}
+
+
+/**
+  Turn the statistics of an environment on or off, or clear them.
+
+  @param[in] env        Environment
+  @param[in] value      One of the MYODBC_LATENCY_* values
+  @param[in] dump_path  File to write the statistics to when the environment
+                        is freed, or NULL. Only the first one given is kept.
+
+  @return TRUE if out of memory
+*/
+my_bool latency_enable(ENV *env, SQLUINTEGER value, const char *dump_path)
+{
+  struct st_myodbc_latency *latency;
+  uint i;
+
+  my_thread_once(&latency_once, latency_lock_init);
+  myodbc_mutex_lock(&env->lock);
+
+  if (!(latency= env->latency) && value == MYODBC_LATENCY_ON)
+  {
+    latency= (struct st_myodbc_latency *)
+      myodbc_malloc(sizeof(struct st_myodbc_latency), MYF(MY_ZEROFILL));
+    if (latency)
+    {
+      latency->blocks= (LATENCY_BLOCK **)
+        myodbc_malloc(sizeof(LATENCY_BLOCK *) * LATENCY_BLOCKS_MAX, MYF(0));
+    }
+
+    native_mutex_lock(&latency_lock);
+    if (!latency || !latency->blocks ||
+        (!latency_envs &&
+         my_create_thread_local_key(&latency_key, latency_detach)))
+    {
+      native_mutex_unlock(&latency_lock);
+      if (latency)
+      {
+        x_free(latency->blocks);
+      }
+      x_free(latency);
+      myodbc_mutex_unlock(&env->lock);
+      return TRUE;
+    }
+    ++latency_envs;
+    latency->id= ++latency_last_id;
+    native_mutex_unlock(&latency_lock);
+
+    env->latency= latency;
+  }
+
+  if (latency && dump_path && *dump_path && !latency->dump_path)
+  {
+    latency->dump_path= myodbc_strdup(dump_path, MYF(0));
+  }
+
+  switch (value)
+  {
+  case MYODBC_LATENCY_ON:
+    env->latency_on= TRUE;
+    break;
+
+  case MYODBC_LATENCY_OFF:
+    env->latency_on= FALSE;
+    break;
+
+  case MYODBC_LATENCY_RESET:
+    for (i= 0; latency && i < latency->block_count; ++i)
+    {
+      memset(latency->blocks[i]->functions, 0,
+             sizeof(latency->blocks[i]->functions));
+    }
+    break;
+  }
+
+  myodbc_mutex_unlock(&env->lock);
+  return FALSE;
+}
+
+
+/**
+  Value under which a share of the calls of a histogram fall, rounded up
+  to the bound of its bucket.
+
+  @param[in] hist     Histogram
+  @param[in] permyriad  Share of the calls, in hundredths of a percent
+*/
+static ulonglong latency_percentile(const LATENCY_HISTOGRAM *hist,
+                                    uint permyriad)
+{
+  ulonglong rank= hist->count - hist->count * (10000 - permyriad) / 10000;
+  ulonglong seen= 0, low, high;
+  uint i;
+
+  for (i= 0; i < LATENCY_BUCKETS; ++i)
+  {
+    seen+= hist->buckets[i];
+    if (seen >= rank && seen)
+    {
+      latency_bucket_range(i, &low, &high);
+      return myodbc_min(high, hist->max);
+    }
+  }
+
+  return hist->max;
+}
+
+
+static my_bool latency_append(DYNAMIC_STRING *out, const char *format, ...)
+{
+  char buff[256];
+  va_list args;
+  int len;
+
+  va_start(args, format);
+  len= vsnprintf(buff, sizeof(buff), format, args);
+  va_end(args);
+
+  return len < 0 ||
+         dynstr_append_mem(out, buff, myodbc_min((size_t)len, sizeof(buff) - 1));
+}
+
+
+static my_bool latency_dump_text(const LATENCY_HISTOGRAM *merged,
+                                 DYNAMIC_STRING *out)
+{
+  uint i;
+
+  if (latency_append(out, "%-18s %10s %12s %10s %10s %10s %10s %10s %10s\n",
+                     "function", "calls", "total_ms", "mean_us", "p50_us",
+                     "p90_us", "p99_us", "p99.9_us", "max_us"))
+  {
+    return TRUE;
+  }
+
+  for (i= 0; i < LATENCY_FUNCTIONS; ++i)
+  {
+    const LATENCY_HISTOGRAM *hist= &merged[i];
+
+    if (!hist->count)
+    {
+      continue;
+    }
+
+    if (latency_append(out, "%-18s %10llu %12.3f %10.3f %10.3f %10.3f "
+                       "%10.3f %10.3f %10.3f\n", latency_names[i],
+                       hist->count, hist->sum / 1e6,
+                       hist->sum / 1e3 / hist->count,
+                       latency_percentile(hist, 5000) / 1e3,
+                       latency_percentile(hist, 9000) / 1e3,
+                       latency_percentile(hist, 9900) / 1e3,
+                       latency_percentile(hist, 9990) / 1e3,
+                       hist->max / 1e3))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+
+static my_bool latency_dump_json(const LATENCY_HISTOGRAM *merged,
+                                 DYNAMIC_STRING *out)
+{
+  my_bool first= TRUE;
+  uint i, j;
+
+  if (latency_append(out, "{\"unit\":\"ns\",\"functions\":{"))
+  {
+    return TRUE;
+  }
+
+  for (i= 0; i < LATENCY_FUNCTIONS; ++i)
+  {
+    const LATENCY_HISTOGRAM *hist= &merged[i];
+    my_bool first_bucket= TRUE;
+
+    if (!hist->count)
+    {
+      continue;
+    }
+
+    if (latency_append(out, "%s\"%s\":{\"count\":%llu,\"sum\":%llu,"
+                       "\"max\":%llu,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,"
+                       "\"p999\":%llu,\"buckets\":[", first ? "" : ",",
+                       latency_names[i], hist->count, hist->sum, hist->max,
+                       latency_percentile(hist, 5000),
+                       latency_percentile(hist, 9000),
+                       latency_percentile(hist, 9900),
+                       latency_percentile(hist, 9990)))
+    {
+      return TRUE;
+    }
+    first= FALSE;
+
+    /* [low, high, count] of the buckets that are not empty */
+    for (j= 0; j < LATENCY_BUCKETS; ++j)
+    {
+      ulonglong low, high;
+
+      if (!hist->buckets[j])
+      {
+        continue;
+      }
+      latency_bucket_range(j, &low, &high);
+      if (latency_append(out, "%s[%llu,%llu,%llu]", first_bucket ? "" : ",",
+                         low, myodbc_min(high, hist->max), hist->buckets[j]))
+      {
+        return TRUE;
+      }
+      first_bucket= FALSE;
+    }
+
+    if (latency_append(out, "]}"))
+    {
+      return TRUE;
+    }
+  }
+
+  return latency_append(out, "}}\n");
+}
+
+
+/**
+  Merge the histograms of all the threads and write them out.
+
+  @param[in]  env   Environment
+  @param[in]  json  TRUE for JSON, FALSE for a table in text
+  @param[out] out   Initialized string the dump is appended to
+
+  @return TRUE if out of memory
+*/
+my_bool latency_dump(ENV *env, my_bool json, DYNAMIC_STRING *out)
+{
+  LATENCY_HISTOGRAM *merged;
+  my_bool rc;
+  uint i, j, k;
+
+  merged= (LATENCY_HISTOGRAM *)
+    myodbc_malloc(sizeof(LATENCY_HISTOGRAM) * LATENCY_FUNCTIONS,
+                  MYF(MY_ZEROFILL));
+  if (!merged)
+  {
+    return TRUE;
+  }
+
+  myodbc_mutex_lock(&env->lock);
+  for (i= 0; env->latency && i < env->latency->block_count; ++i)
+  {
+    for (j= 0; j < LATENCY_FUNCTIONS; ++j)
+    {
+      const LATENCY_HISTOGRAM *hist= &env->latency->blocks[i]->functions[j];
+
+      merged[j].count+= hist->count;
+      merged[j].sum+= hist->sum;
+      merged[j].max= myodbc_max(merged[j].max, hist->max);
+      for (k= 0; k < LATENCY_BUCKETS; ++k)
+      {
+        merged[j].buckets[k]+= hist->buckets[k];
+      }
+    }
+  }
+  myodbc_mutex_unlock(&env->lock);
+
+  rc= json ? latency_dump_json(merged, out) : latency_dump_text(merged, out);
+
+  x_free(merged);
+  return rc;
+}
+
+
+/**
+  Write the dump requested with LATENCY_DUMP, and free the histograms.
+*/
+void latency_free(ENV *env)
+{
+  struct st_myodbc_latency *latency= env->latency;
+  LATENCY_THREAD *thread;
+  uint i;
+
+  if (!latency)
+  {
+    return;
+  }
+
+  if (latency->dump_path)
+  {
+    size_t len= strlen(latency->dump_path);
+    my_bool json= len > 5 &&
+                  !myodbc_casecmp(latency->dump_path + len - 5, ".json", 5);
+    DYNAMIC_STRING dump;
+    FILE *file;
+
+    if (!init_dynamic_string(&dump, "", 4096, 4096))
+    {
+      if (!latency_dump(env, json, &dump) &&
+          (file= fopen(latency->dump_path, "w")))
+      {
+        fwrite(dump.str, 1, dump.length, file);
+        fclose(file);
+      }
+      dynstr_free(&dump);
+    }
+  }
+
+  myodbc_mutex_lock(&env->lock);
+  env->latency_on= FALSE;
+  native_mutex_lock(&latency_lock);
+
+  /* The calling thread gives its block back now */
+  thread= (LATENCY_THREAD *)my_get_thread_local(latency_key);
+  for (i= 0; thread && i < LATENCY_THREAD_ENVS; ++i)
+  {
+    if (thread->ids[i] == latency->id)
+    {
+      thread->ids[i]= 0;
+      latency_release(thread->blocks[i]);
+    }
+  }
+
+  /*
+    The blocks of threads still running, or ending and waiting for the
+    lock in latency_detach(), are freed by the last of their threads. On
+    Windows no destructor runs, and the blocks are freed here.
+  */
+  for (i= 0; i < latency->block_count; ++i)
+  {
+#ifndef _WIN32
+    if (latency->blocks[i]->users)
+    {
+      latency->blocks[i]->orphan= TRUE;
+      continue;
+    }
+#endif
+    x_free(latency->blocks[i]);
+  }
+
+  /*
+    No destructor runs for the threads that end after the key is deleted:
+    the calling thread frees its blocks itself, those of the threads still
+    running are left behind.
+  */
+  if (!--latency_envs)
+  {
+    if (thread)
+    {
+      latency_detach_locked(thread);
+      my_set_thread_local(latency_key, NULL);
+    }
+    my_delete_thread_local_key(latency_key);
+  }
+
+  native_mutex_unlock(&latency_lock);
+  env->latency= NULL;
+  myodbc_mutex_unlock(&env->lock);
+
+  x_free(latency->blocks);
+  x_free(latency->dump_path);
+  x_free(latency);
+}
@@ -678,9 +678,10 @@ char * ssps_get_string(STMT *stmt, ulong column_number, char *value, ulong *leng
       MYSQL_TIME * t = (MYSQL_TIME *)(col_rbind->buffer);
 
       buffer= ALLOC_IFNULL(buffer, 20);
-      myodbc_snprintf(buffer, 10, "%s%02u:%02u:%02u", t->neg? "-":"", t->hour,
+      /* Hours go up to 838 */
+      myodbc_snprintf(buffer, 12, "%s%02u:%02u:%02u", t->neg? "-":"", t->hour,
                                               t->minute, t->second);
-      *length= t->neg ? 9 : 8;
+      *length= strlen(buffer);
 
       if (t->second_part > 0)
       {
@@ -745,6 +746,33 @@ char * ssps_get_string(STMT *stmt, ulong column_number, char *value, ulong *leng
 /* }}} */
 
 
+/**
+  Get the MYSQL_TIME of a DATE, DATETIME or TIMESTAMP column of the current
+  row, so it can be converted without going through a string.
+
+  @return The value, or NULL if the column is of another type or is NULL
+*/
+MYSQL_TIME *ssps_get_datetime(STMT *stmt, ulong column_number)
+{
+  MYSQL_BIND *col_rbind= &stmt->result_bind[column_number];
+
+  if (*col_rbind->is_null)
+  {
+    return NULL;
+  }
+
+  switch (col_rbind->buffer_type)
+  {
+    case MYSQL_TYPE_TIMESTAMP:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_DATE:
+      return (MYSQL_TIME *)(col_rbind->buffer);
+    default:
+      return NULL;
+  }
+}
+
+
 long double ssps_get_double(STMT *stmt, ulong column_number, char *value, ulong length)
 {
   MYSQL_BIND *col_rbind= &stmt->result_bind[column_number];
@@ -67,6 +67,8 @@ my_bool free_current_result(STMT *stmt)
   my_bool res= 0;
   if (stmt->result)
   {
+    read_ahead_stop(stmt);
+    keyset_free(stmt);
     if (ssps_used(stmt))
     {
       free_result_bind(stmt);
@@ -110,6 +112,8 @@ MYSQL_RES * stmt_get_result(STMT *stmt, BOOL force_use)
 MYSQL_RES * get_result_metadata(STMT *stmt, BOOL force_use)
 {
   free_internal_result_buffers(stmt);
+  read_ahead_stop(stmt);
+  keyset_free(stmt);
   /* just a precaution, mysql_free_result checks for NULL anywat */
   mysql_free_result(stmt->result);
 
@@ -197,6 +201,14 @@ my_ulonglong num_rows(STMT *stmt)
   {
     return  offset + mysql_stmt_num_rows(stmt->ssps);
   }
+  else if (stmt->keyset)
+  {
+    return offset + keyset_rows(stmt->keyset);
+  }
+  else if (stmt->read_ahead)
+  {
+    return offset + read_ahead_rows(stmt->read_ahead);
+  }
   else
   {
     return offset + mysql_num_rows(stmt->result);
@@ -224,6 +236,14 @@ MYSQL_ROW fetch_row(STMT *stmt)
 
     return stmt->array;
   }
+  else if (stmt->keyset)
+  {
+    return keyset_fetch(stmt->keyset);
+  }
+  else if (stmt->read_ahead || read_ahead_start(stmt))
+  {
+    return read_ahead_fetch(stmt->read_ahead);
+  }
   else
   {
     return mysql_fetch_row(stmt->result);
@@ -237,6 +257,14 @@ unsigned long* fetch_lengths(STMT *stmt)
   {
     return stmt->result_bind[0].length;
   }
+  else if (stmt->keyset)
+  {
+    return keyset_lengths(stmt->keyset);
+  }
+  else if (stmt->read_ahead)
+  {
+    return read_ahead_lengths(stmt->read_ahead);
+  }
   else
   {
     return mysql_fetch_lengths(stmt->result);
@@ -263,6 +291,10 @@ void data_seek(STMT *stmt, my_ulonglong offset)
   {
     mysql_stmt_data_seek(stmt->ssps, offset);
   }
+  else if (stmt->keyset)
+  {
+    keyset_seek(stmt->keyset, offset);
+  }
   else
   {
     mysql_data_seek(stmt->result, offset);
@@ -380,8 +412,9 @@ SQLRETURN prepare(STMT *stmt, char * query, SQLINTEGER query_length)
                      stmt->dbc->cxn_charset_info);
   /* Tokenising string, detecting and storing parameters placeholders, removing {}
      So far the only possible error is memory allocation. Thus setting it here.
-     If that changes we will need to make "parse" to set error and return rc */
-  if (parse(&stmt->query))
+     If that changes we will need to make "parse" to set error and return rc.
+     The text prepared before on the connection is not tokenized again */
+  if (query_template_parse(stmt->dbc, &stmt->query))
   {
     return set_error(stmt, MYERR_S1001, NULL, 4001);
   }
@@ -389,8 +422,12 @@ SQLRETURN prepare(STMT *stmt, char * query, SQLINTEGER query_length)
   ssps_close(stmt);
   stmt->param_count= PARAM_COUNT(&stmt->query);
   /* Trusting our parsing we are not using prepared statments unsless there are
-     actually parameter markers in it */
-  if (!stmt->dbc->ds->no_ssps && PARAM_COUNT(&stmt->query) && !IS_BATCH(&stmt->query)
+     actually parameter markers in it, or it is a SELECT and the PREPARE_SELECT
+     option asks for results in the binary protocol */
+  if (!stmt->dbc->ds->no_ssps
+    && (PARAM_COUNT(&stmt->query)
+      || (stmt->dbc->ds->prepare_select && is_select_statement(&stmt->query)))
+    && !IS_BATCH(&stmt->query)
     && preparable_on_server(&stmt->query, stmt->dbc->mysql.server_version))
   {
     MYLOG_QUERY(stmt, "Using prepared statement");
@@ -415,6 +452,8 @@ SQLRETURN prepare(STMT *stmt, char * query, SQLINTEGER query_length)
       stmt->param_count= mysql_stmt_param_count(stmt->ssps);
 
       free_internal_result_buffers(stmt);
+      read_ahead_stop(stmt);
+      keyset_free(stmt);
       /* make sure we free the result from the previous time */
       mysql_free_result(stmt->result);
 
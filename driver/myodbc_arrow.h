@@ -0,0 +1,112 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  myodbc_arrow.h
+  @brief Columnar fetch of result sets as Apache Arrow record batches.
+
+  A batch is returned as a struct array with one child per result column,
+  through the Arrow C Data Interface. The consumer owns both structures
+  once they are filled and calls their release callbacks when it is done.
+
+  The batch is fetched with the exported MYODBCFetchArrow() function, which
+  advances the cursor like SQLFetch() with a rowset of
+  SQL_ATTR_MYODBC_ARROW_BATCH_SIZE rows. It takes the handle of the driver,
+  SQL_DRIVER_HSTMT under a driver manager. An application that does not
+  link with the driver reads the address of the function with
+  SQLGetStmtAttr(SQL_ATTR_MYODBC_ARROW_FETCH).
+
+  TIME columns are durations in microseconds ("tDu"), not times of the day,
+  since a MySQL TIME goes from -838:59:59 to 838:59:59.
+
+  The ODBC headers have to be included first.
+*/
+
+#ifndef __MYODBC_ARROW_H__
+#define __MYODBC_ARROW_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+  void (*release)(struct ArrowSchema *);
+  void *private_data;
+};
+
+struct ArrowArray
+{
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+  void (*release)(struct ArrowArray *);
+  void *private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+/* Driver-specific statement attributes */
+#define SQL_ATTR_MYODBC_ARROW_BATCH_SIZE  0x4101  /* SQLULEN, rows per batch */
+#define SQL_ATTR_MYODBC_ARROW_FETCH       0x4102  /* MYODBCFetchArrowFunc, read only */
+
+#define MYODBC_ARROW_DEFAULT_BATCH_SIZE   65536
+
+/*
+  Returns SQL_SUCCESS with the next batch, or SQL_NO_DATA at the end of
+  the result, in which case the structures are left untouched.
+*/
+SQLRETURN SQL_API MYODBCFetchArrow(SQLHSTMT hstmt, struct ArrowSchema *schema,
+                                   struct ArrowArray *array);
+
+typedef SQLRETURN (SQL_API *MYODBCFetchArrowFunc)(SQLHSTMT hstmt,
+                                                  struct ArrowSchema *schema,
+                                                  struct ArrowArray *array);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MYODBC_ARROW_H__ */
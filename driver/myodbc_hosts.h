@@ -0,0 +1,45 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  myodbc_hosts.h
+  @brief Health of the hosts of server lists.
+
+  When SERVER is a list of hosts, the connect time and failures of each
+  host are kept in the environment. They are read as a null terminated
+  table with SQLGetConnectAttr() on any connection of the environment, one
+  line per host after a header line:
+
+    host:port  failures  seconds left in the backoff  smoothed connect ms
+
+  The ODBC headers have to be included first.
+*/
+
+#ifndef __MYODBC_HOSTS_H__
+#define __MYODBC_HOSTS_H__
+
+/* Driver-specific connection attributes */
+#define SQL_ATTR_MYODBC_HOSTS_TEXT  0x4106  /* SQLCHAR *, read only */
+
+#endif /* __MYODBC_HOSTS_H__ */
@@ -0,0 +1,56 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  myodbc_latency.h
+  @brief Latency histograms of the entry points of the driver.
+
+  With LATENCY_STATS=1 in the data source, or SQL_ATTR_MYODBC_LATENCY_STATS
+  set on the environment, the time spent in the main entry points is
+  recorded per function in log-linear histograms. Each thread records in
+  its own histograms, which are merged when a dump is requested.
+
+  The dump is read as a null terminated string with SQLGetEnvAttr(), or with
+  SQLGetConnectAttr() on any connection of the environment, which works
+  through driver managers that do not pass environment attributes on. With
+  LATENCY_DUMP=<file> in the data source it is also written to that file
+  when the environment is freed, as JSON if the name ends with .json.
+
+  The ODBC headers have to be included first.
+*/
+
+#ifndef __MYODBC_LATENCY_H__
+#define __MYODBC_LATENCY_H__
+
+/* Driver-specific environment and connection attributes */
+#define SQL_ATTR_MYODBC_LATENCY_STATS  0x4103  /* SQLUINTEGER, MYODBC_LATENCY_* */
+#define SQL_ATTR_MYODBC_LATENCY_TEXT   0x4104  /* SQLCHAR *, read only */
+#define SQL_ATTR_MYODBC_LATENCY_JSON   0x4105  /* SQLCHAR *, read only */
+
+/* Values of SQL_ATTR_MYODBC_LATENCY_STATS */
+#define MYODBC_LATENCY_OFF    0
+#define MYODBC_LATENCY_ON     1
+#define MYODBC_LATENCY_RESET  2   /* clears the histograms, set only */
+
+#endif /* __MYODBC_LATENCY_H__ */
@@ -40,6 +40,7 @@
 */
 
 #define if_dynamic_cursor(st) ((st)->stmt_options.cursor_type == SQL_CURSOR_DYNAMIC)
+#define if_keyset_cursor(st) ((st)->stmt_options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
 #define if_forward_cache(st) ((st)->stmt_options.cursor_type == SQL_CURSOR_FORWARD_ONLY && \
 			     (st)->dbc->ds->dont_cache_result)
 #define is_connected(dbc)    ((dbc)->mysql.net.vio)
@@ -251,6 +252,8 @@ my_bool   str_to_date           (SQL_DATE_STRUCT *rgbValue, const char *str,
 int       str_to_ts             (SQL_TIMESTAMP_STRUCT *ts, const char *str, int len,
                                 int zeroToMin, BOOL dont_use_set_locale);
 my_bool str_to_time_st          (SQL_TIME_STRUCT *ts, const char *str);
+int   mysql_time_to_ts          (SQL_TIMESTAMP_STRUCT *ts, const MYSQL_TIME *t,
+                                int zeroToMin);
 ulong str_to_time_as_long       (const char *str,uint length);
 void  init_getfunctions         (void);
 void  myodbc_init               (void);
@@ -281,13 +284,18 @@ my_bool myodbc_net_realloc(NET *net, size_t length);
 void myodbc_net_end(NET *net);
 my_bool set_dynamic_result        (STMT *stmt);
 void    set_current_cursor_data   (STMT *stmt,SQLUINTEGER irow);
+my_bool check_if_usable_unique_key_exists(STMT *stmt);
 my_bool is_minimum_version        (const char *server_version,const char *version);
 int     myodbc_strcasecmp         (const char *s, const char *t);
 int     myodbc_casecmp            (const char *s, const char *t, uint len);
 my_bool reget_current_catalog     (DBC *dbc);
+const char* check_row_locking    (CHARSET_INFO *cs, char *query, char *query_end,
+                                  BOOL is_share_mode);
 
 ulong   myodbc_escape_string      (MYSQL *mysql, char *to, ulong to_length,
                                   const char *from, ulong length, int escape_id);
+ulong   myodbc_escape_value       (MYSQL *mysql, char *to, const char *from,
+                                  ulong length);
 
 DESCREC*  desc_get_rec            (DESC *desc, int recnum, my_bool expand);
 
@@ -295,6 +303,12 @@ DESC*     desc_alloc              (STMT *stmt, SQLSMALLINT alloc_type,
                                   desc_ref_type ref_type, desc_desc_type desc_type);
 void      desc_free_paramdata     (DESC *desc);
 void      desc_free               (DESC *desc);
+void      desc_reset              (DESC *desc);
+SQLWCHAR *desc_get_wstr           (DESC *desc, uint recnum, SQLCHAR *value,
+                                   CHARSET_INFO *charset_info,
+                                   SQLINTEGER *len);
+void      desc_free_wstrs         (DESC *desc);
+my_bool   desc_hot_refresh        (DESC *desc, SQLLEN count);
 void      desc_rec_init_apd       (DESCREC *rec);
 void      desc_rec_init_ipd       (DESCREC *rec);
 void      desc_remove_stmt        (DESC *desc, STMT *stmt);
@@ -373,6 +387,7 @@ int get_session_variable(STMT *stmt, const char *var, char *result);
 /* handle.c*/
 BOOL          allocate_param_bind     (DYNAMIC_ARRAY **param_bind, uint elements);
 int           adjust_param_bind_array (STMT *stmt);
+void          stmt_pool_flush         (DBC *dbc);
 /* Actions taken when connection is put to the pool. Used in connection freeing as well */
 int           reset_connection        (DBC *dbc);
 /* Actions taken when connection is taken from the pool */
@@ -382,6 +397,9 @@ int           wakeup_connection       (DBC *dbc);
 /*results.c*/
 long long     binary2numeric        (long long *dst, char *src, uint srcLen);
 void          fill_ird_data_lengths (DESC *ird, ulong *lengths, uint fields);
+int           get_timestamp         (STMT *stmt, ulong column_number, char *value,
+                                     ulong length, SQL_TIMESTAMP_STRUCT *ts,
+                                     char *as_string);
 
 /* Functions to work with prepared and regular statements  */
 
@@ -452,12 +470,137 @@ long double ssps_get_double       (STMT *stmt, ulong column_number, char *value,
                                   ulong length);
 char *      ssps_get_string       (STMT *stmt, ulong column_number, char *value,
                                   ulong *length, char * buffer);
+MYSQL_TIME *ssps_get_datetime     (STMT *stmt, ulong column_number);
 SQLRETURN   ssps_send_long_data   (STMT *stmt, unsigned int param_num, const char *chunk,
                                   unsigned long length);
 MYSQL_BIND * get_param_bind       (STMT *stmt, unsigned int param_number, int reset);
 
 /* connect.c */
 void free_connection_stmts(DBC *dbc);
+SQLRETURN myodbc_do_connect(DBC *dbc, DataSource *ds);
+
+/* workers.c */
+typedef struct st_myodbc_workers MYODBC_WORKERS;
+typedef void (*myodbc_task_func)(void *task);
+
+MYODBC_WORKERS *  workers_create      (uint thread_count);
+void              workers_destroy     (MYODBC_WORKERS *pool);
+uint              workers_count       (MYODBC_WORKERS *pool);
+void              workers_run         (MYODBC_WORKERS *pool, myodbc_task_func func,
+                                       void *tasks, size_t task_size,
+                                       uint task_count);
+MYODBC_WORKERS *  env_get_workers     (ENV *env, uint thread_count);
+
+/* catalog_fanout.c */
+#define CATALOG_FANOUT_MAX 16
+
+typedef MYSQL_RES *(*catalog_fanout_func)(MYSQL *mysql, void *arg, uint index);
+
+SQLRETURN catalog_fanout_run  (STMT *stmt, const char *catalog, uint count,
+                               catalog_fanout_func func, void *arg,
+                               MYSQL_RES **results);
+void      catalog_fanout_close(DBC *dbc);
+
+/* arrow.c */
+struct ArrowSchema;
+struct ArrowArray;
+
+SQLRETURN arrow_fetch (STMT *stmt, struct ArrowSchema *schema,
+                       struct ArrowArray *array);
+
+/* result_cache.c */
+my_bool result_cache_get    (STMT *stmt, char *query, SQLULEN query_length);
+void    result_cache_update (STMT *stmt, char *query, SQLULEN query_length,
+                             SQLRETURN rc);
+void    result_cache_clear  (ENV *env);
+void    result_cache_free   (ENV *env);
+
+/* query_template.c */
+#define QUERY_TEMPLATE_MAX 64
+#define QUERY_TEMPLATE_MAX_LENGTH 65536
+
+my_bool query_template_parse  (DBC *dbc, MY_PARSED_QUERY *pq);
+void    query_template_flush  (DBC *dbc);
+
+/* read_ahead.c */
+#define READ_AHEAD_MAX_BLOCKS 8
+
+typedef struct st_read_ahead READ_AHEAD;
+
+my_bool       read_ahead_start    (STMT *stmt);
+MYSQL_ROW     read_ahead_fetch    (READ_AHEAD *ra);
+ulong *       read_ahead_lengths  (READ_AHEAD *ra);
+my_ulonglong  read_ahead_rows     (READ_AHEAD *ra);
+void          read_ahead_stop     (STMT *stmt);
+
+/* hosts.c */
+#define HOSTS_MAX 64
+
+#define HOSTS_FAILOVER    0
+#define HOSTS_ROUND_ROBIN 1
+#define HOSTS_RANDOM      2
+#define HOSTS_LATENCY     3
+
+typedef struct
+{
+  char *host;
+  uint  port;
+} MYODBC_HOST;
+
+uint  hosts_parse     (const char *list, uint default_port, MYODBC_HOST *hosts,
+                       uint max_hosts, char *buffer);
+int   hosts_strategy  (const char *name);
+void  hosts_order     (ENV *env, const MYODBC_HOST *hosts, uint count,
+                       int strategy, uint *order);
+void  hosts_report    (ENV *env, const MYODBC_HOST *host, my_bool ok,
+                       double ms, uint backoff);
+my_bool hosts_dump    (ENV *env, DYNAMIC_STRING *out);
+void  hosts_free      (ENV *env);
+
+/* tls_sessions.c */
+void  tls_sessions_apply  (DBC *dbc, DataSource *ds, const char *host,
+                           uint port);
+void  tls_sessions_save   (DBC *dbc, DataSource *ds, const char *host,
+                           uint port);
+void  tls_sessions_report (DBC *dbc);
+void  tls_sessions_free   (ENV *env);
+
+/* latency.c */
+typedef enum
+{
+  LATENCY_CONNECT, LATENCY_DRIVER_CONNECT, LATENCY_PREPARE, LATENCY_EXECUTE,
+  LATENCY_EXEC_DIRECT, LATENCY_FETCH, LATENCY_FETCH_SCROLL, LATENCY_GET_DATA,
+  LATENCY_COLUMNS, LATENCY_TABLES, LATENCY_FUNCTIONS
+} LATENCY_FUNCTION;
+
+/*
+  The start time is only taken while the statistics are on, the single
+  check of env->latency_on is all an entry point pays otherwise.
+*/
+#define LATENCY_BEGIN(env) ((env)->latency_on ? latency_now() : 0)
+#define LATENCY_END(env, func, start) \
+  if ((start) && (env)->latency_on) latency_record((env), (func), (start))
+
+ulonglong latency_now     (void);
+void      latency_record  (ENV *env, LATENCY_FUNCTION func, ulonglong start);
+my_bool   latency_enable  (ENV *env, SQLUINTEGER value, const char *dump_path);
+my_bool   latency_dump    (ENV *env, my_bool json, DYNAMIC_STRING *out);
+void      latency_free    (ENV *env);
+
+/* keyset.c */
+typedef struct st_keyset KEYSET;
+
+my_bool       keyset_candidate    (STMT *stmt);
+SQLRETURN     keyset_read         (STMT *stmt);
+SQLRETURN     keyset_verify       (STMT *stmt, char *query,
+                                   SQLULEN query_length);
+SQLRETURN     keyset_load         (STMT *stmt, my_ulonglong first,
+                                   SQLULEN count);
+MYSQL_ROW     keyset_fetch        (KEYSET *ks);
+ulong *       keyset_lengths      (KEYSET *ks);
+my_ulonglong  keyset_rows         (KEYSET *ks);
+void          keyset_seek         (KEYSET *ks, my_ulonglong row);
+void          keyset_free         (STMT *stmt);
 
 #ifdef __WIN__
 #define cmp_database(A,B) myodbc_strcasecmp((const char *)(A),(const char *)(B))
@@ -29,6 +29,9 @@
 
 #include "driver.h"
 #include "errmsg.h"
+#include "myodbc_arrow.h"
+#include "myodbc_hosts.h"
+#include "myodbc_latency.h"
 
 /*
   @type    : myodbc3 internal
@@ -65,6 +68,11 @@ static SQLRETURN set_constmt_attr(SQLSMALLINT  HandleType,
                     return set_handle_error(HandleType,Handle,MYERR_01S02,
                                             "Forcing the use of forward-only cursor)",0);
             }
+            else if (((STMT *)Handle)->dbc->ds->keyset_cursor &&
+                     ValuePtr == (SQLPOINTER)SQL_CURSOR_KEYSET_DRIVEN)
+            {
+                options->cursor_type= SQL_CURSOR_KEYSET_DRIVEN;
+            }
             else if (((STMT *)Handle)->dbc->ds->dynamic_cursor)
             {
                 if (ValuePtr != (SQLPOINTER)SQL_CURSOR_KEYSET_DRIVEN)
@@ -426,6 +434,19 @@ MySQLSetConnectAttr(SQLHDBC hdbc, SQLINTEGER Attribute,
       return set_dbc_error(dbc, "HYC00",
                            "Optional feature not supported", 0);
 
+    /* Same as on the environment, which driver managers may not pass on */
+    case SQL_ATTR_MYODBC_LATENCY_STATS:
+      if ((SQLULEN)ValuePtr > MYODBC_LATENCY_RESET)
+      {
+        return set_dbc_error(dbc, "HY024", "Invalid attribute value", 0);
+      }
+      if (latency_enable(dbc->env, (SQLUINTEGER)(SQLULEN)ValuePtr, NULL))
+      {
+        return set_dbc_error(dbc, "HY001", "Memory allocation error",
+                             MYERR_S1001);
+      }
+      break;
+
       /*
         3.x driver doesn't support any statement attributes
         at connection level, but to make sure all 2.x apps
@@ -579,6 +600,54 @@ MySQLGetConnectAttr(SQLHDBC hdbc, SQLINTEGER attrib, SQLCHAR **char_attr,
     *((SQLINTEGER *)num_attr)= dbc->txn_isolation;
     break;
 
+  case SQL_ATTR_MYODBC_LATENCY_STATS:
+    *((SQLUINTEGER *)num_attr)= dbc->env->latency_on ? MYODBC_LATENCY_ON
+                                                     : MYODBC_LATENCY_OFF;
+    break;
+
+  case SQL_ATTR_MYODBC_LATENCY_TEXT:
+  case SQL_ATTR_MYODBC_LATENCY_JSON:
+    {
+      DYNAMIC_STRING dump;
+
+      if (init_dynamic_string(&dump, "", 4096, 4096))
+      {
+        return set_dbc_error(dbc, "HY001", "Memory allocation error",
+                             MYERR_S1001);
+      }
+      if (latency_dump(dbc->env, attrib == SQL_ATTR_MYODBC_LATENCY_JSON,
+                       &dump))
+      {
+        dynstr_free(&dump);
+        return set_dbc_error(dbc, "HY001", "Memory allocation error",
+                             MYERR_S1001);
+      }
+
+      /* The string has to outlive the call */
+      x_free(dbc->latency_dump);
+      dbc->latency_dump= dump.str;
+      *char_attr= (SQLCHAR *)dbc->latency_dump;
+    }
+    break;
+
+  case SQL_ATTR_MYODBC_HOSTS_TEXT:
+    {
+      DYNAMIC_STRING dump;
+
+      if (init_dynamic_string(&dump, "", 1024, 1024) ||
+          hosts_dump(dbc->env, &dump))
+      {
+        dynstr_free(&dump);
+        return set_dbc_error(dbc, "HY001", "Memory allocation error",
+                             MYERR_S1001);
+      }
+
+      x_free(dbc->hosts_dump);
+      dbc->hosts_dump= dump.str;
+      *char_attr= (SQLCHAR *)dbc->hosts_dump;
+    }
+    break;
+
   default:
     return set_handle_error(SQL_HANDLE_DBC, hdbc, MYERR_S1092, NULL, 0);
   }
@@ -770,6 +839,13 @@ MySQLSetStmtAttr(SQLHSTMT hstmt, SQLINTEGER Attribute, SQLPOINTER ValuePtr,
             options->simulateCursor= (SQLUINTEGER)(SQLULEN)ValuePtr;
             break;
 
+        case SQL_ATTR_MYODBC_ARROW_BATCH_SIZE:
+            options->arrow_batch_size= (SQLULEN)ValuePtr;
+            break;
+
+        case SQL_ATTR_MYODBC_ARROW_FETCH:
+            return set_error(stmt, MYERR_S1092, NULL, 0);
+
             /*
               3.x driver doesn't support any statement attributes
               at connection level, but to make sure all 2.x apps
@@ -875,6 +951,17 @@ MySQLGetStmtAttr(SQLHSTMT hstmt, SQLINTEGER Attribute, SQLPOINTER ValuePtr,
             *(SQLUINTEGER *)ValuePtr= options->simulateCursor;
             break;
 
+        case SQL_ATTR_MYODBC_ARROW_BATCH_SIZE:
+            *(SQLULEN *)ValuePtr= options->arrow_batch_size ?
+                                  options->arrow_batch_size :
+                                  MYODBC_ARROW_DEFAULT_BATCH_SIZE;
+            break;
+
+        case SQL_ATTR_MYODBC_ARROW_FETCH:
+            *(MYODBCFetchArrowFunc *)ValuePtr= MYODBCFetchArrow;
+            *StringLengthPtr= sizeof(MYODBCFetchArrowFunc);
+            break;
+
         case SQL_ATTR_APP_ROW_DESC:
             *(SQLPOINTER *)ValuePtr= stmt->ard;
             *StringLengthPtr= sizeof(SQLPOINTER);
@@ -923,7 +1010,9 @@ SQLSetEnvAttr(SQLHENV    henv,
 {
   CHECK_HANDLE(henv);
 
-  if (((ENV *)henv)->connections)
+  /* The statistics can be switched at any time */
+  if (((ENV *)henv)->connections &&
+      Attribute != SQL_ATTR_MYODBC_LATENCY_STATS)
       return set_env_error(henv, MYERR_S1010, NULL, 0);
 
   switch (Attribute)
@@ -947,6 +1036,15 @@ SQLSetEnvAttr(SQLHENV    henv,
       case SQL_ATTR_OUTPUT_NTS:
           if (ValuePtr == (SQLPOINTER)SQL_TRUE)
               break;
+          return set_env_error(henv,MYERR_S1C00,NULL,0);
+
+      case SQL_ATTR_MYODBC_LATENCY_STATS:
+          if ((SQLULEN)ValuePtr > MYODBC_LATENCY_RESET)
+              return set_env_error(henv,MYERR_S1024,NULL,0);
+          if (latency_enable((ENV *)henv, (SQLUINTEGER)(SQLULEN)ValuePtr,
+                             NULL))
+              return set_env_error(henv,MYERR_S1001,NULL,0);
+          break;
 
       default:
           return set_env_error(henv,MYERR_S1C00,NULL,0);
@@ -964,8 +1062,8 @@ SQLRETURN SQL_API
 SQLGetEnvAttr(SQLHENV    henv,
               SQLINTEGER Attribute,
               SQLPOINTER ValuePtr,
-              SQLINTEGER BufferLength __attribute__((unused)),
-              SQLINTEGER *StringLengthPtr __attribute__((unused)))
+              SQLINTEGER BufferLength,
+              SQLINTEGER *StringLengthPtr)
 {
     CHECK_HANDLE(henv);
     /* NULL is acceptable for ValuePtr, so we are not checking for it here */
@@ -984,6 +1082,41 @@ SQLGetEnvAttr(SQLHENV    henv,
             IF_NOT_NULL(ValuePtr, *((SQLINTEGER*)ValuePtr)= SQL_TRUE);
             break;
 
+        case SQL_ATTR_MYODBC_LATENCY_STATS:
+            IF_NOT_NULL(ValuePtr, *((SQLUINTEGER*)ValuePtr)=
+                        ((ENV *)henv)->latency_on ? MYODBC_LATENCY_ON
+                                                  : MYODBC_LATENCY_OFF);
+            break;
+
+        case SQL_ATTR_MYODBC_LATENCY_TEXT:
+        case SQL_ATTR_MYODBC_LATENCY_JSON:
+            {
+              DYNAMIC_STRING dump;
+              SQLRETURN rc= SQL_SUCCESS;
+
+              if (init_dynamic_string(&dump, "", 4096, 4096))
+                return set_env_error(henv,MYERR_S1001,NULL,0);
+              if (latency_dump((ENV *)henv,
+                               Attribute == SQL_ATTR_MYODBC_LATENCY_JSON,
+                               &dump))
+              {
+                dynstr_free(&dump);
+                return set_env_error(henv,MYERR_S1001,NULL,0);
+              }
+
+              if (ValuePtr && BufferLength > 0)
+                strmake((char *)ValuePtr, dump.str,
+                        myodbc_min(dump.length, (size_t)BufferLength - 1));
+              if (ValuePtr &&
+                  dump.length >= (size_t)myodbc_max(BufferLength, 0))
+                rc= set_env_error(henv,MYERR_01004,NULL,0);
+              IF_NOT_NULL(StringLengthPtr,
+                          *StringLengthPtr= (SQLINTEGER)dump.length);
+
+              dynstr_free(&dump);
+              return rc;
+            }
+
         default:
             return set_env_error(henv,MYERR_S1C00,NULL,0);
     }
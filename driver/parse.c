@@ -538,6 +538,82 @@ BOOL stmt_returns_result(const MY_PARSED_QUERY *query)
 }
 
 
+#define PARSE_ONES  0x0101010101010101ULL
+#define PARSE_HIGHS 0x8080808080808080ULL
+
+/* Non-zero if one of the bytes of the word is less than n (n <= 128) */
+#define PARSE_HAS_LESS(w, n) (((w) - PARSE_ONES * (n)) & ~(w) & PARSE_HIGHS)
+
+/*
+  Bytes that may start a quote, an escape, a comment, a query separator or
+  a parameter marker outside of quotes. Spaces and control characters stop
+  a run as well, for they end a token.
+*/
+static const char plain_stop_bytes[]= "'\"`\\?-#/;";
+
+/**
+  Get the end of the run of bytes at a position that the tokenizer would
+  only step over.
+
+  The bytes are checked 8 at a time: a byte equal to c is found by looking
+  for a zero byte in the word xor-ed with c in all bytes. Bytes with the
+  high bit set may start a multibyte character, or be a space in a single
+  byte charset, so they are left to the CHARSET_INFO checks.
+
+  @param[in]  pos         Position to start at, on a character boundary
+  @param[in]  end         End of the query
+  @param[in]  stop        Bytes that end the run
+  @param[in]  stop_count  Number of bytes in stop
+  @param[in]  below       Bytes less than this end the run
+  @param[in]  stop_high   Whether bytes with the high bit set end the run
+
+  @return End of the run
+*/
+static char * skip_plain_run(char *pos, const char *end, const char *stop,
+                             uint stop_count, uchar below, my_bool stop_high)
+{
+  uint i;
+
+  while (end - pos >= 8)
+  {
+    ulonglong word;
+
+    memcpy(&word, pos, 8);
+
+    if ((stop_high && (word & PARSE_HIGHS)) || PARSE_HAS_LESS(word, below))
+    {
+      break;
+    }
+
+    for (i= 0; i < stop_count; ++i)
+    {
+      ulonglong diff= word ^ (PARSE_ONES * (uchar)stop[i]);
+
+      if (PARSE_HAS_LESS(diff, 1))
+      {
+        break;
+      }
+    }
+
+    if (i < stop_count)
+    {
+      break;
+    }
+
+    pos+= 8;
+  }
+
+  /* Rest of the query, or the word where the run ends */
+  while (pos < end && !(stop_high && (uchar)*pos >= 0x80) &&
+         (uchar)*pos >= below && !memchr(stop, *pos, stop_count))
+  {
+    ++pos;
+  }
+
+  return pos;
+}
+
+
 /* TRUE if end has been reached */
 BOOL skip_spaces(MY_PARSER *parser)
 {
@@ -651,6 +727,25 @@ char * find_closing_quote(MY_PARSER *parser)
   char *closing_quote= NULL;
   while(END_NOT_REACHED(parser))
   {
+    /* Bytes that can neither escape nor close the quote */
+    if (parser->quote->bytes == 1)
+    {
+      char stop[2];
+      char *run_end;
+
+      stop[0]= parser->quote->str[0];
+      stop[1]= parser->syntax->escape->str[0];
+      run_end= skip_plain_run(parser->pos, parser->query->query_end, stop, 2,
+                              0, parser->query->cs->mbmaxlen > 1);
+
+      if (run_end > parser->pos)
+      {
+        parser->pos= run_end;
+        get_ctype(parser);
+        continue;
+      }
+    }
+
     if (is_escape(parser))
     {
       step_char(parser);
@@ -763,6 +858,20 @@ BOOL tokenize(MY_PARSER *parser)
     }
     else
     {
+      char *run_end= skip_plain_run(parser->pos, parser->query->query_end,
+                                    plain_stop_bytes,
+                                    sizeof(plain_stop_bytes) - 1, 0x21, TRUE);
+
+      /* A run of bytes that are only stepped over, the last one of which
+         is the last character so far */
+      if (run_end > parser->pos)
+      {
+        parser->query->last_char= run_end - 1;
+        parser->pos= run_end;
+        get_ctype(parser);
+        continue;
+      }
+
       if (IS_SPACE(parser))
       {
         step_char(parser);
@@ -782,7 +891,11 @@ BOOL tokenize(MY_PARSER *parser)
       /* is_query_separator moves position to the 1st char of the next query */
       if (is_query_separator(parser))
       {
-        skip_spaces(parser);
+        /* Another statement follows, not only spaces up to the end */
+        if (!skip_spaces(parser) && parser->query->is_batch == NULL)
+        {
+          parser->query->is_batch= parser->pos;
+        }
 
         if (add_token(parser))
         {
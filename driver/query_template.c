@@ -0,0 +1,264 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  query_template.c
+  @brief Parsed queries kept per connection for preparing the same text again.
+
+  Preparing a statement tokenizes its text to find the parameter markers,
+  the query type and the ODBC escape braces around it. The outcome is kept
+  in the connection as a template: the text with the braces removed, the
+  offsets of the tokens and of the parameter markers, and the type of the
+  query. Preparing the same text again copies the template instead of
+  tokenizing, and the offsets of the markers are what the execution uses to
+  copy the literal segments of the query around the parameter values.
+*/
+
+#include "driver.h"
+
+typedef struct st_query_template
+{
+  LIST             list;
+  ulong            hash;
+  CHARSET_INFO    *cs;
+  size_t           length;
+  char            *text;        /* text as prepared, the key */
+  char            *parsed;      /* text with the braces removed */
+  uint            *tokens;      /* offsets of the tokens */
+  uint            *params;      /* offsets of the parameter markers */
+  uint             token_count;
+  uint             param_count;
+  long             last_char;   /* offsets, or -1 if not set */
+  long             is_batch;
+  QUERY_TYPE_ENUM  query_type;
+} QUERY_TEMPLATE;
+
+
+static ulong query_template_hash(const char *text, size_t len)
+{
+  ulong hash= 2166136261UL;
+
+  while (len--)
+  {
+    hash= (hash ^ (uchar)*text++) * 16777619UL;
+  }
+
+  return hash;
+}
+
+
+/**
+  Fill a parsed query from a template. The query text is already there,
+  with the same length as the text of the template.
+*/
+static my_bool query_template_copy(QUERY_TEMPLATE *templ,
+                                   MY_PARSED_QUERY *pq)
+{
+  if (myodbc_allocate_dynamic(&pq->token, templ->token_count) ||
+      myodbc_allocate_dynamic(&pq->param_pos, templ->param_count))
+  {
+    return TRUE;
+  }
+
+  memcpy(GET_QUERY(pq), templ->parsed, templ->length);
+  memcpy(pq->token.buffer, templ->tokens, sizeof(uint) * templ->token_count);
+  pq->token.elements= templ->token_count;
+  memcpy(pq->param_pos.buffer, templ->params,
+         sizeof(uint) * templ->param_count);
+  pq->param_pos.elements= templ->param_count;
+
+  pq->last_char= templ->last_char < 0 ? NULL
+                                      : GET_QUERY(pq) + templ->last_char;
+  pq->is_batch= templ->is_batch < 0 ? NULL
+                                    : GET_QUERY(pq) + templ->is_batch;
+  pq->query_type= templ->query_type;
+
+  return FALSE;
+}
+
+
+/**
+  Make a template of a query that has just been parsed.
+
+  @param[in] text  Copy of the query text from before parsing
+*/
+static QUERY_TEMPLATE *query_template_new(MY_PARSED_QUERY *pq, char *text,
+                                          ulong hash)
+{
+  size_t length= GET_QUERY_LENGTH(pq);
+  uint tokens= TOKEN_COUNT(pq), params= PARAM_COUNT(pq);
+  QUERY_TEMPLATE *templ;
+  char *buff;
+
+  templ= (QUERY_TEMPLATE *)myodbc_malloc(sizeof(QUERY_TEMPLATE) + length +
+                                         sizeof(uint) * (tokens + params),
+                                         MYF(0));
+  if (!templ)
+  {
+    return NULL;
+  }
+
+  buff= (char *)(templ + 1);
+  templ->tokens= (uint *)buff;
+  memcpy(templ->tokens, pq->token.buffer, sizeof(uint) * tokens);
+  templ->params= templ->tokens + tokens;
+  memcpy(templ->params, pq->param_pos.buffer, sizeof(uint) * params);
+  templ->parsed= (char *)(templ->params + params);
+  memcpy(templ->parsed, GET_QUERY(pq), length);
+
+  templ->list.data= templ;
+  templ->hash= hash;
+  templ->cs= pq->cs;
+  templ->length= length;
+  templ->text= text;
+  templ->token_count= tokens;
+  templ->param_count= params;
+  templ->last_char= pq->last_char ? (long)(pq->last_char - GET_QUERY(pq)) : -1;
+  templ->is_batch= pq->is_batch ? (long)(pq->is_batch - GET_QUERY(pq)) : -1;
+  templ->query_type= pq->query_type;
+
+  return templ;
+}
+
+
+static void query_template_free(QUERY_TEMPLATE *templ)
+{
+  x_free(templ->text);
+  x_free(templ);
+}
+
+
+/**
+  Parse a query, or copy the outcome of parsing the same text earlier on
+  the connection. The query is set in the parsed query, not yet parsed.
+
+  @return TRUE if memory ran out, like parse()
+*/
+my_bool query_template_parse(DBC *dbc, MY_PARSED_QUERY *pq)
+{
+  size_t length= GET_QUERY_LENGTH(pq);
+  ulong hash;
+  LIST *elem;
+  QUERY_TEMPLATE *templ= NULL;
+  char *text;
+  my_bool found= FALSE;
+
+  if (length > QUERY_TEMPLATE_MAX_LENGTH)
+  {
+    return parse(pq);
+  }
+
+  hash= query_template_hash(GET_QUERY(pq), length);
+
+  myodbc_mutex_lock(&dbc->lock);
+  for (elem= dbc->templates; elem; elem= elem->next)
+  {
+    templ= (QUERY_TEMPLATE *)elem->data;
+
+    if (templ->hash == hash && templ->length == length &&
+        templ->cs == pq->cs && !memcmp(templ->text, GET_QUERY(pq), length))
+    {
+      /* Most recently used first */
+      dbc->templates= list_delete(dbc->templates, elem);
+      dbc->templates= list_add(dbc->templates, elem);
+      found= TRUE;
+      break;
+    }
+  }
+
+  if (found)
+  {
+    my_bool rc= query_template_copy(templ, pq);
+
+    myodbc_mutex_unlock(&dbc->lock);
+    return rc;
+  }
+  myodbc_mutex_unlock(&dbc->lock);
+
+  /* Parsing removes the braces, the key is the text from before */
+  text= (char *)myodbc_memdup(GET_QUERY(pq), length, MYF(0));
+
+  if (parse(pq))
+  {
+    x_free(text);
+    return TRUE;
+  }
+
+  if (!text || !(templ= query_template_new(pq, text, hash)))
+  {
+    x_free(text);
+    return FALSE;
+  }
+
+  myodbc_mutex_lock(&dbc->lock);
+  dbc->templates= list_add(dbc->templates, &templ->list);
+
+  if (++dbc->template_count > QUERY_TEMPLATE_MAX)
+  {
+    LIST *last= dbc->templates;
+
+    while (last->next)
+    {
+      last= last->next;
+    }
+    dbc->templates= list_delete(dbc->templates, last);
+    --dbc->template_count;
+    templ= (QUERY_TEMPLATE *)last->data;
+  }
+  else
+  {
+    templ= NULL;
+  }
+  myodbc_mutex_unlock(&dbc->lock);
+
+  if (templ)
+  {
+    query_template_free(templ);
+  }
+
+  return FALSE;
+}
+
+
+/**
+  Free the query templates of a connection.
+*/
+void query_template_flush(DBC *dbc)
+{
+  LIST *templates;
+
+  myodbc_mutex_lock(&dbc->lock);
+  templates= dbc->templates;
+  dbc->templates= NULL;
+  dbc->template_count= 0;
+  myodbc_mutex_unlock(&dbc->lock);
+
+  while (templates)
+  {
+    QUERY_TEMPLATE *templ= (QUERY_TEMPLATE *)templates->data;
+
+    templates= templates->next;
+    query_template_free(templ);
+  }
+}
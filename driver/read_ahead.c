@@ -0,0 +1,451 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  read_ahead.c
+  @brief Background read-ahead of the rows of forward-only result sets.
+
+  With READ_AHEAD set, the first fetch from a result that is read row by
+  row from the server starts a thread reading the following rows into a
+  small ring of blocks, while the application converts the rows of the
+  block in front of it. The thread stops when all blocks are full, so the
+  memory used is bounded by the number of blocks.
+
+  The thread holds the connection lock while it fills a block, so that no
+  other command is sent on the connection in the middle of a read.
+*/
+
+#include "driver.h"
+#include "../include/sys/thr_cond.h"
+
+/* A block ends when either of these limits is reached */
+#define READ_AHEAD_BLOCK_ROWS  1024
+#define READ_AHEAD_BLOCK_BYTES (256 * 1024)
+
+/* Time to wait before trying again to take the connection lock, in ns */
+#define READ_AHEAD_LOCK_WAIT   1000000ULL
+
+typedef struct
+{
+  char  **values;     /* READ_AHEAD_BLOCK_ROWS rows of field pointers */
+  ulong  *lengths;
+  char   *data;       /* the values, each followed by a null byte */
+  size_t  data_used;
+  size_t  data_size;
+  uint    rows;
+} READ_AHEAD_BLOCK;
+
+struct st_read_ahead
+{
+  DBC              *dbc;
+  MYSQL_RES        *result;
+  uint              fields;
+
+  myodbc_mutex_t    lock;
+  native_cond_t     cond;      /* signalled when a block is filled or freed */
+  my_thread_handle  thread;
+
+  READ_AHEAD_BLOCK *blocks;
+  uint              block_count;
+  uint              head;      /* block the rows are returned from */
+  uint              filled;    /* blocks filled, the head block included */
+  my_bool           done;      /* all rows have been read */
+  volatile my_bool  stop;      /* the result is being closed */
+
+  /* state of the fetching thread, not protected by the lock */
+  READ_AHEAD_BLOCK *current;
+  uint              next_row;
+  ulong            *lengths;
+  my_ulonglong      rows;
+};
+
+
+/**
+  Copy a row read from the server at the end of a block.
+
+  The field pointers are kept as offsets in the data until the block is
+  complete, as the data may still move. A null field is stored as 0.
+
+  @return TRUE if out of memory
+*/
+static my_bool read_ahead_copy_row(READ_AHEAD *ra, READ_AHEAD_BLOCK *block,
+                                   MYSQL_ROW row, ulong *lengths)
+{
+  char  **values= block->values + (size_t)block->rows * ra->fields;
+  ulong  *row_lengths= block->lengths + (size_t)block->rows * ra->fields;
+  size_t  size= ra->fields;
+  uint    i;
+
+  for (i= 0; i < ra->fields; ++i)
+  {
+    size+= lengths[i];
+  }
+
+  if (block->data_used + size > block->data_size)
+  {
+    size_t new_size= myodbc_max(block->data_size * 2,
+                                block->data_used + size);
+    char *data= (char *)myodbc_realloc(block->data, new_size,
+                                       MYF(MY_ALLOW_ZERO_PTR));
+    if (!data)
+    {
+      return TRUE;
+    }
+    block->data= data;
+    block->data_size= new_size;
+  }
+
+  for (i= 0; i < ra->fields; ++i)
+  {
+    row_lengths[i]= lengths[i];
+
+    if (!row[i])
+    {
+      values[i]= NULL;
+      continue;
+    }
+
+    values[i]= (char *)(block->data_used + 1);
+    memcpy(block->data + block->data_used, row[i], lengths[i]);
+    block->data_used+= lengths[i];
+    block->data[block->data_used++]= '\0';
+  }
+
+  ++block->rows;
+  return FALSE;
+}
+
+
+/**
+  Read rows from the server into a block, with the connection lock held.
+
+  @return TRUE if the end of the result was reached, or the read failed
+*/
+static my_bool read_ahead_fill(READ_AHEAD *ra, READ_AHEAD_BLOCK *block)
+{
+  my_bool end= FALSE;
+  size_t i;
+
+  block->rows= 0;
+  block->data_used= 0;
+
+  while (!ra->stop && block->rows < READ_AHEAD_BLOCK_ROWS &&
+         block->data_used < READ_AHEAD_BLOCK_BYTES)
+  {
+    MYSQL_ROW row= mysql_fetch_row(ra->result);
+
+    if (!row)
+    {
+      end= TRUE;
+      break;
+    }
+
+    if (read_ahead_copy_row(ra, block, row, mysql_fetch_lengths(ra->result)))
+    {
+      set_mem_error(&ra->dbc->mysql);
+      end= TRUE;
+      break;
+    }
+  }
+
+  for (i= 0; i < (size_t)block->rows * ra->fields; ++i)
+  {
+    if (block->values[i])
+    {
+      block->values[i]= block->data + ((size_t)block->values[i] - 1);
+    }
+  }
+
+  return end;
+}
+
+
+/**
+  Take the connection lock, unless the result is closed meanwhile.
+
+  The statement may be closed by a thread holding the connection lock, so
+  it is never waited for without also watching the stop flag.
+
+  Must be called with the read-ahead lock held, returns with it held.
+*/
+static my_bool read_ahead_lock_dbc(READ_AHEAD *ra)
+{
+  while (myodbc_mutex_trylock(&ra->dbc->lock))
+  {
+    struct timespec abstime;
+
+    if (ra->stop)
+    {
+      return FALSE;
+    }
+
+    set_timespec_nsec(&abstime, READ_AHEAD_LOCK_WAIT);
+    native_cond_timedwait(&ra->cond, &ra->lock, &abstime);
+  }
+
+  return TRUE;
+}
+
+
+static void *read_ahead_thread(void *arg)
+{
+  READ_AHEAD *ra= (READ_AHEAD *)arg;
+
+  mysql_thread_init();
+
+  myodbc_mutex_lock(&ra->lock);
+  while (!ra->stop)
+  {
+    READ_AHEAD_BLOCK *block;
+    my_bool end;
+
+    if (ra->filled == ra->block_count)
+    {
+      native_cond_wait(&ra->cond, &ra->lock);
+      continue;
+    }
+
+    if (!read_ahead_lock_dbc(ra))
+    {
+      break;
+    }
+
+    block= &ra->blocks[(ra->head + ra->filled) % ra->block_count];
+    myodbc_mutex_unlock(&ra->lock);
+
+    end= read_ahead_fill(ra, block);
+    myodbc_mutex_unlock(&ra->dbc->lock);
+
+    myodbc_mutex_lock(&ra->lock);
+    if (block->rows)
+    {
+      ++ra->filled;
+    }
+    ra->done= end;
+    native_cond_broadcast(&ra->cond);
+
+    if (end)
+    {
+      break;
+    }
+  }
+  myodbc_mutex_unlock(&ra->lock);
+
+  mysql_thread_end();
+  return NULL;
+}
+
+
+static void read_ahead_free(READ_AHEAD *ra)
+{
+  uint i;
+
+  for (i= 0; i < ra->block_count; ++i)
+  {
+    x_free(ra->blocks[i].values);
+    x_free(ra->blocks[i].lengths);
+    x_free(ra->blocks[i].data);
+  }
+
+  native_cond_destroy(&ra->cond);
+  myodbc_mutex_destroy(&ra->lock);
+
+  x_free(ra->blocks);
+  x_free(ra);
+}
+
+
+/**
+  Start reading ahead the rows of the result of a statement, if it is
+  enabled and the result is read from the server row by row.
+
+  @return TRUE if the rows are now read ahead
+*/
+my_bool read_ahead_start(STMT *stmt)
+{
+  MYSQL_RES *result= stmt->result;
+  READ_AHEAD *ra;
+  my_thread_attr_t attr;
+  uint i;
+
+  if (!stmt->dbc->ds->read_ahead || !result || stmt->fake_result ||
+      result->data || !result->handle || !result->field_count ||
+      !if_forward_cache(stmt) || stmt->fix_fields ||
+      ssps_used(stmt) || scroller_exists(stmt))
+  {
+    return FALSE;
+  }
+
+  ra= (READ_AHEAD *)myodbc_malloc(sizeof(READ_AHEAD), MYF(MY_ZEROFILL));
+  if (!ra)
+  {
+    return FALSE;
+  }
+
+  ra->dbc= stmt->dbc;
+  ra->result= result;
+  ra->fields= result->field_count;
+  ra->block_count= myodbc_min(myodbc_max(stmt->dbc->ds->read_ahead, 2),
+                              READ_AHEAD_MAX_BLOCKS);
+  myodbc_mutex_init(&ra->lock, NULL);
+  native_cond_init(&ra->cond);
+
+  ra->blocks= (READ_AHEAD_BLOCK *)myodbc_malloc(sizeof(READ_AHEAD_BLOCK) *
+                                                ra->block_count,
+                                                MYF(MY_ZEROFILL));
+  if (!ra->blocks)
+  {
+    ra->block_count= 0;
+    read_ahead_free(ra);
+    return FALSE;
+  }
+
+  for (i= 0; i < ra->block_count; ++i)
+  {
+    size_t cells= (size_t)READ_AHEAD_BLOCK_ROWS * ra->fields;
+
+    ra->blocks[i].values= (char **)myodbc_malloc(sizeof(char *) * cells,
+                                                 MYF(0));
+    ra->blocks[i].lengths= (ulong *)myodbc_malloc(sizeof(ulong) * cells,
+                                                  MYF(0));
+    if (!ra->blocks[i].values || !ra->blocks[i].lengths)
+    {
+      read_ahead_free(ra);
+      return FALSE;
+    }
+  }
+
+  my_thread_attr_init(&attr);
+  my_thread_attr_setstacksize(&attr, DEFAULT_THREAD_STACK);
+  my_thread_attr_setdetachstate(&attr, MY_THREAD_CREATE_JOINABLE);
+
+  if (my_thread_create(&ra->thread, &attr, read_ahead_thread, ra))
+  {
+    my_thread_attr_destroy(&attr);
+    read_ahead_free(ra);
+    return FALSE;
+  }
+  my_thread_attr_destroy(&attr);
+
+  stmt->read_ahead= ra;
+  return TRUE;
+}
+
+
+/**
+  Get the next row read ahead.
+
+  The row stays valid until the next call, which releases its block once
+  all the rows of the block have been returned.
+
+  @return The row, or NULL at the end of the result or if the read failed,
+          with the error set in the connection
+*/
+MYSQL_ROW read_ahead_fetch(READ_AHEAD *ra)
+{
+  MYSQL_ROW row;
+
+  if (!ra->current || ra->next_row == ra->current->rows)
+  {
+    myodbc_mutex_lock(&ra->lock);
+
+    if (ra->current)
+    {
+      ra->head= (ra->head + 1) % ra->block_count;
+      --ra->filled;
+      ra->current= NULL;
+      native_cond_broadcast(&ra->cond);
+    }
+
+    while (!ra->filled && !ra->done)
+    {
+      native_cond_wait(&ra->cond, &ra->lock);
+    }
+
+    if (ra->filled)
+    {
+      ra->current= &ra->blocks[ra->head];
+      ra->next_row= 0;
+    }
+
+    myodbc_mutex_unlock(&ra->lock);
+
+    if (!ra->current)
+    {
+      return NULL;
+    }
+  }
+
+  row= ra->current->values + (size_t)ra->next_row * ra->fields;
+  ra->lengths= ra->current->lengths + (size_t)ra->next_row * ra->fields;
+  ++ra->next_row;
+  ++ra->rows;
+
+  return row;
+}
+
+
+/**
+  Get the lengths of the last row returned by read_ahead_fetch().
+*/
+ulong *read_ahead_lengths(READ_AHEAD *ra)
+{
+  return ra->lengths;
+}
+
+
+/**
+  Get the number of rows returned so far by read_ahead_fetch().
+*/
+my_ulonglong read_ahead_rows(READ_AHEAD *ra)
+{
+  return ra->rows;
+}
+
+
+/**
+  Stop reading ahead the rows of the result of a statement, and free the
+  rows read. The rows not read yet are left in the result.
+
+  May be called with the connection lock held.
+*/
+void read_ahead_stop(STMT *stmt)
+{
+  READ_AHEAD *ra= stmt->read_ahead;
+
+  if (!ra)
+  {
+    return;
+  }
+
+  myodbc_mutex_lock(&ra->lock);
+  ra->stop= TRUE;
+  native_cond_broadcast(&ra->cond);
+  myodbc_mutex_unlock(&ra->lock);
+
+  my_thread_join(&ra->thread, NULL);
+
+  stmt->read_ahead= NULL;
+  read_ahead_free(ra);
+}
@@ -0,0 +1,695 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  result_cache.c
+  @brief Client-side cache of the results of read-only queries.
+
+  With RESULT_CACHE_TTL set, the result of a SELECT or SHOW statement sent
+  as text is kept in the environment for that many seconds, and the same
+  query sent again on any connection of the environment to the same
+  server, as the same user and with the same current database, gets a copy
+  of it instead of going to the server. The parameters of client-side
+  prepared statements are part of the query text, so they are part of the
+  key as well.
+
+  Any other statement, or batch of statements, run on any connection of
+  the environment clears the cache, as it may have changed the data, with
+  RESULT_CACHE_TTL set on that connection or not. Nothing is cached or
+  served inside of a transaction.
+
+  The cache is shared by sessions that may not see the same values, so
+  queries referring to user or system variables (anything with @ outside
+  of quotes), or calling one of the functions of
+  result_cache_session_words, are never cached. Neither are results with
+  TIMESTAMP columns, whose values depend on the time zone of the session.
+  The memory used is capped by RESULT_CACHE_SIZE, the least recently used
+  results being dropped first.
+*/
+
+#include "driver.h"
+
+/* Default memory cap, in kilobytes */
+#define RESULT_CACHE_DEFAULT_SIZE 16384
+
+typedef struct
+{
+  LIST          list;         /* most recently used first */
+  ulong         hash;
+  char         *key;
+  size_t        key_len;
+  time_t        expires;
+  size_t        size;         /* memory accounted to the entry */
+
+  MYSQL_FIELD  *fields;
+  uint          field_count;
+  my_ulonglong  row_count;
+  char        **values;       /* row_count * field_count, into data */
+  ulong        *lengths;
+  char         *data;         /* the values, each followed by a null byte */
+  size_t        data_len;
+} RESULT_CACHE_ENTRY;
+
+struct st_myodbc_result_cache
+{
+  LIST   *entries;
+  size_t  size;
+};
+
+
+static size_t result_cache_cap(DataSource *ds)
+{
+  return (size_t)(ds->result_cache_size ? ds->result_cache_size
+                                        : RESULT_CACHE_DEFAULT_SIZE) * 1024;
+}
+
+
+/*
+  Functions whose values depend on the session or on the time of the call.
+  Some of them can be called without parentheses, so any identifier with
+  one of these names outside of quotes counts.
+*/
+static const char *result_cache_session_words[]=
+{
+  "BENCHMARK", "CONNECTION_ID", "CONVERT_TZ", "CURDATE", "CURRENT_DATE",
+  "CURRENT_ROLE", "CURRENT_TIME", "CURRENT_TIMESTAMP", "CURRENT_USER",
+  "CURTIME", "DATABASE", "FOUND_ROWS", "FROM_UNIXTIME", "GET_LOCK",
+  "IS_FREE_LOCK", "IS_USED_LOCK", "LAST_INSERT_ID", "LOCALTIME",
+  "LOCALTIMESTAMP", "NOW", "RAND", "RELEASE_LOCK", "ROW_COUNT", "SCHEMA",
+  "SESSION_USER", "SLEEP", "SYSDATE", "SYSTEM_USER", "UNIX_TIMESTAMP",
+  "USER", "UTC_DATE", "UTC_TIME", "UTC_TIMESTAMP", "UUID", "UUID_SHORT",
+  /* session state shown by SHOW */
+  "ERRORS", "PROCESSLIST", "STATUS", "VARIABLES", "WARNINGS",
+  NULL
+};
+
+
+/**
+  Check if the result of a query may differ between sessions or between
+  calls, see result_cache_session_words.
+*/
+static my_bool result_cache_session_dependent(const char *query,
+                                              const char *end)
+{
+  char quote= 0;
+
+  while (query < end)
+  {
+    if (quote)
+    {
+      if (*query == '\\' && query + 1 < end)
+      {
+        ++query;
+      }
+      else if (*query == quote)
+      {
+        quote= 0;
+      }
+      ++query;
+    }
+    else if (*query == '\'' || *query == '"' || *query == '`')
+    {
+      quote= *query++;
+    }
+    else if (*query == '@')
+    {
+      return TRUE;
+    }
+    else if (isalpha((uchar)*query) || *query == '_')
+    {
+      const char *word= query;
+      uint i;
+
+      while (query < end && (isalnum((uchar)*query) || *query == '_' ||
+                             *query == '$'))
+      {
+        ++query;
+      }
+
+      for (i= 0; result_cache_session_words[i]; ++i)
+      {
+        if (strlen(result_cache_session_words[i]) == (size_t)(query - word) &&
+            !myodbc_casecmp(word, result_cache_session_words[i],
+                            (uint)(query - word)))
+        {
+          return TRUE;
+        }
+      }
+    }
+    else if (isdigit((uchar)*query))
+    {
+      /* so that a number followed by letters is not taken for a word */
+      while (query < end && (isalnum((uchar)*query) || *query == '_'))
+      {
+        ++query;
+      }
+    }
+    else
+    {
+      ++query;
+    }
+  }
+
+  return FALSE;
+}
+
+
+/**
+  Check if the result of a query may come from the cache.
+*/
+static my_bool result_cache_eligible(STMT *stmt, char *query,
+                                     SQLULEN query_length)
+{
+  QUERY_TYPE_ENUM type= stmt->query.query_type;
+  CHARSET_INFO *cs= stmt->dbc->cxn_charset_info;
+
+  /* Inside a transaction the data seen is not the data of the others, and
+     a keyset cursor reads the rows again at each fetch */
+  if (ssps_used(stmt) || (type != myqtSelect && type != myqtShow) ||
+      IS_BATCH(&stmt->query) ||
+      (trans_supported(stmt->dbc) && !autocommit_on(stmt->dbc)) ||
+      (if_keyset_cursor(stmt) && stmt->dbc->ds->keyset_cursor))
+  {
+    return FALSE;
+  }
+
+  /* Locking reads are meant to reach the server */
+  return !check_row_locking(cs, query, query + query_length, FALSE) &&
+         !check_row_locking(cs, query, query + query_length, TRUE) &&
+         !result_cache_session_dependent(query, query + query_length);
+}
+
+
+/**
+  Build the key of a query: the identity of the session followed by the
+  query with its runs of spaces outside of quotes collapsed.
+
+  @return The key, to be freed by the caller, or NULL if out of memory
+*/
+static char *result_cache_key(STMT *stmt, const char *query,
+                              SQLULEN query_length, size_t *key_len)
+{
+  DBC *dbc= stmt->dbc;
+  const char *end= query + query_length;
+  char session[1024], *key, *to;
+  char quote= 0;
+  size_t session_len;
+
+  myodbc_snprintf(session, sizeof(session), "%s:%u|%s|%s|%s|%lu|",
+                  dbc->mysql.host ? dbc->mysql.host : "", dbc->mysql.port,
+                  dbc->mysql.user ? dbc->mysql.user : "",
+                  dbc->database ? dbc->database : "",
+                  dbc->cxn_charset_info->csname,
+                  (unsigned long)stmt->stmt_options.max_rows);
+  session_len= strlen(session);
+
+  if (!(key= myodbc_malloc(session_len + query_length + 1, MYF(0))))
+  {
+    return NULL;
+  }
+  memcpy(key, session, session_len);
+  to= key + session_len;
+
+  while (query < end && isspace((uchar)*query))
+  {
+    ++query;
+  }
+  while (end > query && (isspace((uchar)end[-1]) || end[-1] == ';'))
+  {
+    --end;
+  }
+
+  for (; query < end; ++query)
+  {
+    if (quote)
+    {
+      if (*query == '\\' && query + 1 < end)
+      {
+        *to++= *query++;
+      }
+      else if (*query == quote)
+      {
+        quote= 0;
+      }
+    }
+    else if (*query == '\'' || *query == '"' || *query == '`')
+    {
+      quote= *query;
+    }
+    else if (isspace((uchar)*query))
+    {
+      if (to[-1] != ' ')
+      {
+        *to++= ' ';
+      }
+      continue;
+    }
+
+    *to++= *query;
+  }
+  *to= '\0';
+
+  *key_len= to - key;
+  return key;
+}
+
+
+static ulong result_cache_hash(const char *key, size_t len)
+{
+  ulong hash= 2166136261UL;
+
+  while (len--)
+  {
+    hash= (hash ^ (uchar)*key++) * 16777619UL;
+  }
+
+  return hash;
+}
+
+
+/**
+  Copy an array of fields with their names in one allocation.
+*/
+static MYSQL_FIELD *result_cache_copy_fields(const MYSQL_FIELD *src,
+                                             uint count, size_t *size)
+{
+  MYSQL_FIELD *fields;
+  char *to;
+  size_t len= sizeof(MYSQL_FIELD) * count;
+  uint i;
+
+  for (i= 0; i < count; ++i)
+  {
+    len+= src[i].name_length + src[i].org_name_length + src[i].table_length +
+          src[i].org_table_length + src[i].db_length +
+          src[i].catalog_length + src[i].def_length + 7;
+  }
+
+  if (!(fields= (MYSQL_FIELD *)myodbc_malloc(len, MYF(0))))
+  {
+    return NULL;
+  }
+  memcpy(fields, src, sizeof(MYSQL_FIELD) * count);
+  to= (char *)(fields + count);
+
+#define COPY_NAME(F) \
+  if (src[i].F) \
+  { \
+    fields[i].F= to; \
+    memcpy(to, src[i].F, src[i].F##_length); \
+    to+= src[i].F##_length; \
+    *to++= '\0'; \
+  }
+
+  for (i= 0; i < count; ++i)
+  {
+    COPY_NAME(name)
+    COPY_NAME(org_name)
+    COPY_NAME(table)
+    COPY_NAME(org_table)
+    COPY_NAME(db)
+    COPY_NAME(catalog)
+    COPY_NAME(def)
+    fields[i].extension= NULL;
+  }
+
+#undef COPY_NAME
+
+  if (size)
+  {
+    *size= len;
+  }
+  return fields;
+}
+
+
+static void result_cache_free_entry(RESULT_CACHE_ENTRY *entry)
+{
+  x_free(entry->key);
+  x_free(entry->fields);
+  x_free(entry->values);
+  x_free(entry->lengths);
+  x_free(entry->data);
+  x_free(entry);
+}
+
+
+/**
+  Remove an entry from the cache and free it.
+*/
+static void result_cache_drop(struct st_myodbc_result_cache *cache,
+                              RESULT_CACHE_ENTRY *entry)
+{
+  cache->entries= list_delete(cache->entries, &entry->list);
+  cache->size-= entry->size;
+  result_cache_free_entry(entry);
+}
+
+
+/**
+  Serve the result of a query from the cache.
+
+  @return TRUE if the statement now has the cached result
+*/
+my_bool result_cache_get(STMT *stmt, char *query, SQLULEN query_length)
+{
+  ENV *env= stmt->dbc->env;
+  RESULT_CACHE_ENTRY *entry= NULL;
+  LIST *element;
+  MYSQL_RES *result;
+  MYSQL_FIELD *fields= NULL;
+  char **values= NULL;
+  ulong *lengths= NULL;
+  char *key, *data;
+  size_t key_len, cells, i;
+  ulong hash;
+  uint field_count;
+  my_ulonglong row_count;
+  time_t now= time(NULL);
+
+  if (stmt->result || !result_cache_eligible(stmt, query, query_length) ||
+      !(key= result_cache_key(stmt, query, query_length, &key_len)))
+  {
+    return FALSE;
+  }
+  hash= result_cache_hash(key, key_len);
+
+  myodbc_mutex_lock(&env->lock);
+
+  for (element= env->result_cache ? env->result_cache->entries : NULL;
+       element; element= element->next)
+  {
+    RESULT_CACHE_ENTRY *e= (RESULT_CACHE_ENTRY *)element->data;
+
+    if (e->hash == hash && e->key_len == key_len &&
+        !memcmp(e->key, key, key_len))
+    {
+      entry= e;
+      break;
+    }
+  }
+  x_free(key);
+
+  if (!entry)
+  {
+    myodbc_mutex_unlock(&env->lock);
+    return FALSE;
+  }
+
+  if (entry->expires <= now)
+  {
+    result_cache_drop(env->result_cache, entry);
+    myodbc_mutex_unlock(&env->lock);
+    return FALSE;
+  }
+
+  /* Most recently used first */
+  env->result_cache->entries= list_delete(env->result_cache->entries,
+                                          &entry->list);
+  env->result_cache->entries= list_add(env->result_cache->entries,
+                                       &entry->list);
+
+  field_count= entry->field_count;
+  row_count= entry->row_count;
+  cells= (size_t)row_count * field_count;
+
+  result= (MYSQL_RES *)myodbc_malloc(sizeof(MYSQL_RES), MYF(MY_ZEROFILL));
+  fields= result_cache_copy_fields(entry->fields, field_count, NULL);
+  values= (char **)myodbc_malloc(sizeof(char *) * cells + entry->data_len + 1,
+                                 MYF(0));
+  lengths= (ulong *)myodbc_malloc(sizeof(ulong) * cells + 1, MYF(0));
+
+  if (!result || !fields || !values || !lengths)
+  {
+    myodbc_mutex_unlock(&env->lock);
+    x_free(result);
+    x_free(fields);
+    x_free(values);
+    x_free(lengths);
+    return FALSE;
+  }
+
+  /* The values follow their pointers */
+  data= (char *)(values + cells);
+  memcpy(data, entry->data, entry->data_len);
+  memcpy(lengths, entry->lengths, sizeof(ulong) * cells);
+  for (i= 0; i < cells; ++i)
+  {
+    values[i]= entry->values[i] ? data + (entry->values[i] - entry->data)
+                                : NULL;
+  }
+
+  myodbc_mutex_unlock(&env->lock);
+
+  free_internal_result_buffers(stmt);
+  stmt->result= result;
+  stmt->fake_result= 1;
+  stmt->result_array= values;
+  stmt->lengths= lengths;
+  stmt->fields= fields;
+
+  set_row_count(stmt, row_count);
+  myodbc_link_fields(stmt, fields, field_count);
+
+  MYLOG_QUERY(stmt, "result served from the client-side cache");
+  return TRUE;
+}
+
+
+/**
+  Add the result of a query just executed to the cache.
+*/
+static void result_cache_put(STMT *stmt, char *query, SQLULEN query_length)
+{
+  ENV *env= stmt->dbc->env;
+  DataSource *ds= stmt->dbc->ds;
+  MYSQL_RES *result= stmt->result;
+  struct st_myodbc_result_cache *cache;
+  RESULT_CACHE_ENTRY *entry;
+  size_t cap= result_cache_cap(ds), data_len= 0, fields_size, cells, cell;
+  my_ulonglong row_count;
+  MYSQL_ROW row;
+  LIST *element;
+  uint i;
+
+  /* Only complete results of a single statement */
+  if (!result || stmt->fake_result || !result->data ||
+      scroller_exists(stmt) || mysql_more_results(&stmt->dbc->mysql) ||
+      !result_cache_eligible(stmt, query, query_length))
+  {
+    return;
+  }
+
+  /* TIMESTAMP values are shown in the time zone of the session */
+  for (i= 0; i < result->field_count; ++i)
+  {
+    if (result->fields[i].type == MYSQL_TYPE_TIMESTAMP)
+    {
+      return;
+    }
+  }
+
+  row_count= mysql_num_rows(result);
+  cells= (size_t)row_count * result->field_count;
+
+  mysql_data_seek(result, 0);
+  while ((row= mysql_fetch_row(result)))
+  {
+    ulong *lengths= mysql_fetch_lengths(result);
+
+    for (i= 0; i < result->field_count; ++i)
+    {
+      data_len+= lengths[i] + 1;
+    }
+  }
+
+  /* A single result is not allowed to take more than a quarter of the cap */
+  if (data_len + cells * (sizeof(char *) + sizeof(ulong)) > cap / 4)
+  {
+    mysql_data_seek(result, 0);
+    return;
+  }
+
+  entry= (RESULT_CACHE_ENTRY *)myodbc_malloc(sizeof(RESULT_CACHE_ENTRY),
+                                             MYF(MY_ZEROFILL));
+  if (!entry ||
+      !(entry->key= result_cache_key(stmt, query, query_length,
+                                     &entry->key_len)) ||
+      !(entry->fields= result_cache_copy_fields(result->fields,
+                                                result->field_count,
+                                                &fields_size)) ||
+      !(entry->values= (char **)myodbc_malloc(sizeof(char *) * cells + 1,
+                                              MYF(0))) ||
+      !(entry->lengths= (ulong *)myodbc_malloc(sizeof(ulong) * cells + 1,
+                                               MYF(0))) ||
+      !(entry->data= (char *)myodbc_malloc(data_len + 1, MYF(0))))
+  {
+    if (entry)
+    {
+      result_cache_free_entry(entry);
+    }
+    mysql_data_seek(result, 0);
+    return;
+  }
+
+  entry->list.data= entry;
+  entry->hash= result_cache_hash(entry->key, entry->key_len);
+  entry->expires= time(NULL) + ds->result_cache_ttl;
+  entry->field_count= result->field_count;
+  entry->row_count= row_count;
+  entry->data_len= data_len;
+  entry->size= sizeof(RESULT_CACHE_ENTRY) + entry->key_len + fields_size +
+               cells * (sizeof(char *) + sizeof(ulong)) + data_len;
+
+  data_len= 0;
+  cell= 0;
+  mysql_data_seek(result, 0);
+  while ((row= mysql_fetch_row(result)))
+  {
+    ulong *lengths= mysql_fetch_lengths(result);
+
+    for (i= 0; i < result->field_count; ++i, ++cell)
+    {
+      entry->lengths[cell]= lengths[i];
+      entry->values[cell]= row[i] ? entry->data + data_len : NULL;
+      if (row[i])
+      {
+        memcpy(entry->data + data_len, row[i], lengths[i]);
+      }
+      data_len+= lengths[i];
+      entry->data[data_len++]= '\0';
+    }
+  }
+  mysql_data_seek(result, 0);
+
+  myodbc_mutex_lock(&env->lock);
+
+  if (!(cache= env->result_cache))
+  {
+    cache= (struct st_myodbc_result_cache *)
+      myodbc_malloc(sizeof(struct st_myodbc_result_cache), MYF(MY_ZEROFILL));
+    if (!cache)
+    {
+      myodbc_mutex_unlock(&env->lock);
+      result_cache_free_entry(entry);
+      return;
+    }
+    env->result_cache= cache;
+  }
+
+  /* A result of the same query cached meanwhile is replaced */
+  for (element= cache->entries; element; element= element->next)
+  {
+    RESULT_CACHE_ENTRY *e= (RESULT_CACHE_ENTRY *)element->data;
+
+    if (e->hash == entry->hash && e->key_len == entry->key_len &&
+        !memcmp(e->key, entry->key, entry->key_len))
+    {
+      result_cache_drop(cache, e);
+      break;
+    }
+  }
+
+  /* Drop the least recently used results until the new one fits */
+  while (cache->entries && cache->size + entry->size > cap)
+  {
+    for (element= cache->entries; element->next; element= element->next);
+    result_cache_drop(cache, (RESULT_CACHE_ENTRY *)element->data);
+  }
+
+  cache->entries= list_add(cache->entries, &entry->list);
+  cache->size+= entry->size;
+
+  myodbc_mutex_unlock(&env->lock);
+}
+
+
+/**
+  Drop all the cached results of an environment.
+*/
+void result_cache_clear(ENV *env)
+{
+  myodbc_mutex_lock(&env->lock);
+
+  while (env->result_cache && env->result_cache->entries)
+  {
+    result_cache_drop(env->result_cache,
+                      (RESULT_CACHE_ENTRY *)env->result_cache->entries->data);
+  }
+
+  myodbc_mutex_unlock(&env->lock);
+}
+
+
+/**
+  Update the cache after a query has been executed: keep its result if it
+  can be reused, or drop all results if the query may have changed data.
+  Called for every query of an environment, as a connection without
+  RESULT_CACHE_TTL may change the data of the results cached by others.
+
+  @param[in]  stmt          Statement the query was executed on
+  @param[in]  query         The query as sent to the server
+  @param[in]  query_length  Length of the query
+  @param[in]  rc            Result of the execution
+*/
+void result_cache_update(STMT *stmt, char *query, SQLULEN query_length,
+                         SQLRETURN rc)
+{
+  QUERY_TYPE_ENUM type= stmt->query.query_type;
+  my_bool cached= stmt->dbc->ds->result_cache_ttl != 0;
+
+  /* A batch is typed by its first statement, the others may write */
+  if ((type != myqtSelect && type != myqtShow) || IS_BATCH(&stmt->query))
+  {
+    result_cache_clear(stmt->dbc->env);
+
+    /* The current database is part of the key */
+    if (cached && type == myqtUse && SQL_SUCCEEDED(rc))
+    {
+      reget_current_catalog(stmt->dbc);
+    }
+    return;
+  }
+
+  if (cached && rc == SQL_SUCCESS)
+  {
+    result_cache_put(stmt, query, query_length);
+  }
+}
+
+
+/**
+  Free the result cache of an environment.
+*/
+void result_cache_free(ENV *env)
+{
+  if (!env->result_cache)
+  {
+    return;
+  }
+
+  result_cache_clear(env);
+  x_free(env->result_cache);
+  env->result_cache= NULL;
+}
@@ -362,6 +362,36 @@ sql_get_bookmark_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
 }
 
 
+/**
+  Convert a DATE, DATETIME or TIMESTAMP field to a timestamp. Values of
+  server side prepared statements are taken from their MYSQL_TIME.
+
+  @param[in]  stmt          Handle of statement
+  @param[in]  column_number Column number
+  @param[in]  value         The field data
+  @param[in]  length        Length of value
+  @param[out] ts            Timestamp to fill (can be NULL)
+  @param[in]  as_string     Buffer for the string representation of value
+
+  @return Same as str_to_ts()
+*/
+int get_timestamp(STMT *stmt, ulong column_number, char *value,
+                  ulong length, SQL_TIMESTAMP_STRUCT *ts, char *as_string)
+{
+  MYSQL_TIME *t= ssps_used(stmt) ? ssps_get_datetime(stmt, column_number)
+                                 : NULL;
+
+  if (t)
+  {
+    return mysql_time_to_ts(ts, t, stmt->dbc->ds->zero_date_to_min);
+  }
+
+  return str_to_ts(ts, get_string(stmt, column_number, value, &length,
+                                  as_string),
+                   SQL_NTS, stmt->dbc->ds->zero_date_to_min, TRUE);
+}
+
+
 /**
   Retrieve the data from a field as a specified ODBC C type.
 
@@ -642,15 +672,39 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
     case SQL_C_TYPE_DATE:
       {
         SQL_DATE_STRUCT tmp_date;
-        char *tmp= get_string(stmt, column_number, value, &length, as_string);
+        MYSQL_TIME *t= ssps_used(stmt) ? ssps_get_datetime(stmt, column_number)
+                                       : NULL;
+        my_bool bad_date;
 
         if (!rgbValue)
         {
           rgbValue= (char *)&tmp_date;
         }
 
-        if (!str_to_date((SQL_DATE_STRUCT *)rgbValue, tmp, length,
-                          stmt->dbc->ds->zero_date_to_min))
+        if (t)
+        {
+          SQL_TIMESTAMP_STRUCT ts;
+          SQL_DATE_STRUCT *date= (SQL_DATE_STRUCT *)rgbValue;
+
+          bad_date= mysql_time_to_ts(&ts, t,
+                                     stmt->dbc->ds->zero_date_to_min) != 0;
+          if (!bad_date)
+          {
+            date->year=  ts.year;
+            date->month= ts.month;
+            date->day=   ts.day;
+          }
+        }
+        else
+        {
+          char *tmp= get_string(stmt, column_number, value, &length,
+                                as_string);
+
+          bad_date= str_to_date((SQL_DATE_STRUCT *)rgbValue, tmp, length,
+                                stmt->dbc->ds->zero_date_to_min);
+        }
+
+        if (!bad_date)
         {
           *pcbValue= sizeof(SQL_DATE_STRUCT);
         }
@@ -665,7 +719,7 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
     case SQL_C_INTERVAL_HOUR_TO_SECOND:
     case SQL_C_INTERVAL_HOUR_TO_MINUTE:
       {
-        if (field->type= MYSQL_TYPE_TIME)
+        if (field->type == MYSQL_TYPE_TIME)
         {
           SQL_TIME_STRUCT ts;
           char *tmp= get_string(stmt,
@@ -712,9 +766,8 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
       {
         SQL_TIMESTAMP_STRUCT ts;
 
-        switch (str_to_ts(&ts, get_string(stmt, column_number, value, &length,
-                          as_string), SQL_NTS, stmt->dbc->ds->zero_date_to_min,
-                          TRUE))
+        switch (get_timestamp(stmt, column_number, value, length, &ts,
+                              as_string))
         {
         case SQLTS_BAD_DATE:
           return set_stmt_error(stmt, "22018", "Data value is not a valid time(stamp) value", 0);
@@ -798,12 +851,11 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
     case SQL_C_TIMESTAMP:
     case SQL_C_TYPE_TIMESTAMP:
       {
-      char *tmp= get_string(stmt, column_number, value, &length, as_string);
-
       if (field->type == MYSQL_TYPE_TIME)
       {
         SQL_TIME_STRUCT ts;
-        
+        char *tmp= get_string(stmt, column_number, value, &length, as_string);
+
         if (str_to_time_st(&ts, tmp))
         {
           *pcbValue= SQL_NULL_DATA;
@@ -837,8 +889,8 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
       }
       else
       {
-        switch (str_to_ts((SQL_TIMESTAMP_STRUCT *)rgbValue, tmp, SQL_NTS,
-                      stmt->dbc->ds->zero_date_to_min, TRUE))
+        switch (get_timestamp(stmt, column_number, value, length,
+                              (SQL_TIMESTAMP_STRUCT *)rgbValue, as_string))
         {
         case SQLTS_BAD_DATE:
           return set_stmt_error(stmt, "22018", "Data value is not a valid date/time(stamp) value", 0);
@@ -1415,18 +1467,17 @@ my_bool set_dynamic_result(STMT *stmt)
 
 
 /*
-  @type    : ODBC 1.0 API
-  @purpose : retrieves data for a single column in the result set. It can
-  be called multiple times to retrieve variable-length data
-  in parts
+  @type    : myodbc3 internal
+  @purpose : retrieves data for a single column in the result set, see
+  SQLGetData()
 */
 
-SQLRETURN SQL_API SQLGetData(SQLHSTMT      StatementHandle,
-                             SQLUSMALLINT  ColumnNumber,
-                             SQLSMALLINT   TargetType,
-                             SQLPOINTER    TargetValuePtr,
-                             SQLLEN        BufferLength,
-                             SQLLEN *      StrLen_or_IndPtr)
+static SQLRETURN get_data(SQLHSTMT      StatementHandle,
+                          SQLUSMALLINT  ColumnNumber,
+                          SQLSMALLINT   TargetType,
+                          SQLPOINTER    TargetValuePtr,
+                          SQLLEN        BufferLength,
+                          SQLLEN *      StrLen_or_IndPtr)
 {
     STMT *stmt= (STMT *) StatementHandle;
     SQLRETURN result;
@@ -1534,6 +1585,36 @@ SQLRETURN SQL_API SQLGetData(SQLHSTMT      StatementHandle,
 }
 
 
+/*
+  @type    : ODBC 1.0 API
+  @purpose : retrieves data for a single column in the result set. It can
+  be called multiple times to retrieve variable-length data
+  in parts
+*/
+
+SQLRETURN SQL_API SQLGetData(SQLHSTMT      StatementHandle,
+                             SQLUSMALLINT  ColumnNumber,
+                             SQLSMALLINT   TargetType,
+                             SQLPOINTER    TargetValuePtr,
+                             SQLLEN        BufferLength,
+                             SQLLEN *      StrLen_or_IndPtr)
+{
+    STMT *stmt= (STMT *) StatementHandle;
+    SQLRETURN result;
+    ulonglong start;
+
+    CHECK_HANDLE(stmt);
+
+    start= LATENCY_BEGIN(stmt->dbc->env);
+
+    result= get_data(StatementHandle, ColumnNumber, TargetType,
+                     TargetValuePtr, BufferLength, StrLen_or_IndPtr);
+
+    LATENCY_END(stmt->dbc->env, LATENCY_GET_DATA, start);
+    return result;
+}
+
+
 /*
   @type    : ODBC 1.0 API
   @purpose : determines whether more results are available on a statement
@@ -1787,39 +1868,43 @@ fill_fetch_bookmark_buffers(STMT *stmt, ulong value, uint rownum)
 
   @param[in]  stmt        Handle of statement
   @param[in]  values      Row buffers from libmysql
+  @param[in]  lengths     Data lengths of the row, or NULL to take them
+                          from the IRD
   @param[in]  rownum      Row number of current fetch block
+
+  The hot fields of the ARD must have been refreshed for the fetch with
+  desc_hot_refresh().
 */
 static SQLRETURN
-fill_fetch_buffers(STMT *stmt, MYSQL_ROW values, uint rownum)
+fill_fetch_buffers(STMT *stmt, MYSQL_ROW values, ulong *lengths, uint rownum)
 {
   SQLRETURN res= SQL_SUCCESS, tmp_res;
-  int i;
+  int i, count= (int)myodbc_min(stmt->ird->count, stmt->ard->count);
   ulong length= 0;
-  DESCREC *irrec, *arrec;
- 
-  for (i= 0; i < myodbc_min(stmt->ird->count, stmt->ard->count); ++i, ++values)
-  {
-    irrec= desc_get_rec(stmt->ird, i, FALSE);
-    arrec= desc_get_rec(stmt->ard, i, FALSE);
-    assert(irrec && arrec);
+  DESC_HOT *arhot= stmt->ard->hot;
 
-    if (ARD_IS_BOUND(arrec))
+  assert(stmt->ard->hot_count >= count);
+
+  for (i= 0; i < count; ++i, ++values, ++arhot)
+  {
+    if (HOT_IS_BOUND(arhot))
     {
       SQLLEN *pcbValue= NULL;
       SQLPOINTER TargetValuePtr= NULL;
 
       reset_getdata_position(stmt);
 
-      if (arrec->data_ptr)
+      if (arhot->data_ptr)
       {
-        TargetValuePtr= ptr_offset_adjust(arrec->data_ptr, 
+        TargetValuePtr= ptr_offset_adjust(arhot->data_ptr, 
                                           stmt->ard->bind_offset_ptr, 
                                           stmt->ard->bind_type, 
-                                          arrec->octet_length, rownum);
+                                          arhot->octet_length, rownum);
       }
 
       /* catalog functions with "fake" results won't have lengths */
-      length= irrec->row.datalen;
+      length= lengths ? lengths[i] :
+                        desc_get_rec(stmt->ird, i, FALSE)->row.datalen;
 
       if (!length && *values)
       {
@@ -1829,17 +1914,17 @@ fill_fetch_buffers(STMT *stmt, MYSQL_ROW values, uint rownum)
       /* We need to pass that pointer to the sql_get_data so it could detect
          22002 error - for NULL values that pointer has to be supplied by user.
        */
-      if (arrec->octet_length_ptr)
+      if (arhot->octet_length_ptr)
       {
-        pcbValue= ptr_offset_adjust(arrec->octet_length_ptr, 
+        pcbValue= ptr_offset_adjust(arhot->octet_length_ptr, 
                                       stmt->ard->bind_offset_ptr, 
                                       stmt->ard->bind_type, 
                                       sizeof(SQLLEN), rownum);
       }
 
-      tmp_res= sql_get_data(stmt, arrec->concise_type, (uint)i,
-                            TargetValuePtr, arrec->octet_length, pcbValue,
-                            *values, length, arrec);
+      tmp_res= sql_get_data(stmt, arhot->concise_type, (uint)i,
+                            TargetValuePtr, arhot->octet_length, pcbValue,
+                            *values, length, arhot->rec);
       if (tmp_res != SQL_SUCCESS)
       {
         if (tmp_res == SQL_SUCCESS_WITH_INFO)
@@ -1859,6 +1944,258 @@ fill_fetch_buffers(STMT *stmt, MYSQL_ROW values, uint rownum)
 }
 
 
+/* Default minimum number of cells (rows * bound columns) in a rowset before
+   its conversion is spread over the worker pool */
+#define PARALLEL_FETCH_MIN_CELLS 65536
+
+/* Number of tiles each pool thread gets, to even out uneven rows */
+#define PARALLEL_FETCH_TILES_PER_THREAD 4
+
+/* Rowset read in full before its buffers are filled by the worker pool */
+typedef struct
+{
+  MYSQL_ROW *values;    /* row buffers, one per row */
+  ulong     *lengths;   /* data lengths, columns entries per row */
+  SQLRETURN *results;   /* fill_fetch_buffers() result, one per row */
+  uint       columns;
+} FETCH_ROWSET;
+
+/* Range of rows of a FETCH_ROWSET converted by one task */
+typedef struct
+{
+  STMT         *stmt;   /* private copy of the statement */
+  FETCH_ROWSET *rowset;
+  uint          first_row;
+  uint          row_count;
+} FETCH_TILE;
+
+
+/**
+  Decide whether the buffers of a rowset can be filled on the worker pool.
+
+  Only rows that stay valid after the next row has been read can be
+  converted in parallel, that is rows of a stored result or of a result
+  array. Server side prepared statements are excluded as their bind
+  buffers are reused for each row.
+
+  @param[in]  stmt        Handle of statement
+  @param[in]  rows        Number of rows in the rowset
+  @param[in]  fFetchType  Fetch orientation
+
+  @return The pool to use, or NULL to fill the buffers serially
+*/
+static MYODBC_WORKERS *
+parallel_fetch_pool(STMT *stmt, SQLULEN rows, SQLUSMALLINT fFetchType)
+{
+  DataSource *ds= stmt->dbc->ds;
+  ulonglong min_cells= ds->parallel_fetch_min_cells ?
+                       ds->parallel_fetch_min_cells : PARALLEL_FETCH_MIN_CELLS;
+
+  if (!ds->parallel_fetch_threads || rows < 2
+    || fFetchType == SQL_FETCH_BOOKMARK
+    || stmt->out_params_state != OPS_UNKNOWN
+    || stmt->fix_fields || ssps_used(stmt) || scroller_exists(stmt)
+    || stmt->keyset || (if_forward_cache(stmt) && !stmt->result_array))
+  {
+    return NULL;
+  }
+
+  if ((ulonglong)rows * myodbc_min(stmt->ird->count, stmt->ard->count)
+      < min_cells)
+  {
+    return NULL;
+  }
+
+  return env_get_workers(stmt->dbc->env, ds->parallel_fetch_threads);
+}
+
+
+/**
+  Allocate the rowset used to defer filling of the fetch buffers.
+*/
+static FETCH_ROWSET *parallel_fetch_rowset(STMT *stmt, SQLULEN rows)
+{
+  uint columns= myodbc_min(stmt->ird->count, stmt->ard->count);
+  FETCH_ROWSET *rowset;
+
+  rowset= (FETCH_ROWSET *)myodbc_malloc(sizeof(FETCH_ROWSET) +
+                                        rows * sizeof(MYSQL_ROW) +
+                                        rows * columns * sizeof(ulong) +
+                                        rows * sizeof(SQLRETURN),
+                                        MYF(0));
+  if (!rowset)
+  {
+    return NULL;
+  }
+
+  rowset->values=  (MYSQL_ROW *)(rowset + 1);
+  rowset->lengths= (ulong *)(rowset->values + rows);
+  rowset->results= (SQLRETURN *)(rowset->lengths + rows * columns);
+  rowset->columns= columns;
+
+  return rowset;
+}
+
+
+/**
+  Remember a row of the rowset, with the lengths currently in the IRD.
+*/
+static void
+parallel_fetch_add_row(STMT *stmt, FETCH_ROWSET *rowset, MYSQL_ROW values,
+                       uint rownum)
+{
+  ulong *lengths= rowset->lengths + rownum * rowset->columns;
+  uint i;
+
+  rowset->values[rownum]= values;
+
+  for (i= 0; i < rowset->columns; ++i)
+  {
+    lengths[i]= desc_get_rec(stmt->ird, i, FALSE)->row.datalen;
+  }
+}
+
+
+static void parallel_fetch_tile(void *arg)
+{
+  FETCH_TILE *tile= (FETCH_TILE *)arg;
+  FETCH_ROWSET *rowset= tile->rowset;
+  uint row;
+
+  for (row= tile->first_row; row < tile->first_row + tile->row_count; ++row)
+  {
+    rowset->results[row]=
+      fill_fetch_buffers(tile->stmt, rowset->values[row],
+                         rowset->lengths + row * rowset->columns, row);
+  }
+}
+
+
+/**
+  Fill the fetch buffers of a rowset on the worker pool.
+
+  Each task converts a range of rows on its own copy of the statement, so
+  that the SQLGetData position and the error of the statement are not
+  shared between threads. Rows that did not convert cleanly are converted
+  again on the statement itself, in row order, so that the statement is
+  left with the same diagnostics as a serial fetch would leave it with.
+
+  @param[in]  stmt        Handle of statement
+  @param[in]  pool        Worker pool
+  @param[in]  rowset      Rows to convert
+  @param[in]  rows        Number of rows in the rowset
+*/
+static void
+parallel_fetch_fill(STMT *stmt, MYODBC_WORKERS *pool, FETCH_ROWSET *rowset,
+                    uint rows)
+{
+  uint tile_count= myodbc_min(rows, (workers_count(pool) + 1) *
+                                    PARALLEL_FETCH_TILES_PER_THREAD);
+  FETCH_TILE *tiles= NULL;
+  STMT *copies= NULL;
+  uint i, row;
+
+  if (tile_count > 1)
+  {
+    tiles= (FETCH_TILE *)myodbc_malloc(sizeof(FETCH_TILE) * tile_count, MYF(0));
+    copies= (STMT *)myodbc_malloc(sizeof(STMT) * tile_count, MYF(0));
+  }
+
+  if (tiles && copies)
+  {
+    for (i= 0, row= 0; i < tile_count; ++i)
+    {
+      memcpy(&copies[i], stmt, sizeof(STMT));
+      tiles[i].stmt= &copies[i];
+      tiles[i].rowset= rowset;
+      tiles[i].first_row= row;
+      tiles[i].row_count= rows / tile_count + (i < rows % tile_count);
+      row+= tiles[i].row_count;
+    }
+
+    workers_run(pool, parallel_fetch_tile, tiles, sizeof(FETCH_TILE),
+                tile_count);
+  }
+  else
+  {
+    /* Out of memory, convert on the statement itself */
+    for (row= 0; row < rows; ++row)
+    {
+      rowset->results[row]= SQL_ERROR;
+    }
+  }
+
+  x_free(tiles);
+  x_free(copies);
+
+  for (row= 0; row < rows; ++row)
+  {
+    if (rowset->results[row] != SQL_SUCCESS)
+    {
+      rowset->results[row]=
+        fill_fetch_buffers(stmt, rowset->values[row],
+                           rowset->lengths + row * rowset->columns, row);
+    }
+  }
+
+  reset_getdata_position(stmt);
+}
+
+
+/**
+  Account the result of filling the buffers of a row in the result of
+  the fetch and in the row status arrays.
+
+  @param[in]      stmt          Handle of statement
+  @param[in]      rownum        Row number of current fetch block
+  @param[in]      row_res       Result of filling the row buffers
+  @param[in]      row_book      Result of filling the bookmark buffers
+  @param[in,out]  res           Result of the fetch
+  @param[out]     rgfRowStatus  Row status array of SQLExtendedFetch()
+  @param[in]      upd_status    Whether to update the IRD status array
+*/
+static void
+set_row_result(STMT *stmt, SQLULEN rownum, SQLRETURN row_res,
+               SQLRETURN row_book, SQLRETURN *res,
+               SQLUSMALLINT *rgfRowStatus, my_bool upd_status)
+{
+  /* For SQL_SUCCESS we need all rows to be SQL_SUCCESS */
+  if (*res != row_res || *res != row_book)
+  {
+    /* Any successful row makes overall result SQL_SUCCESS_WITH_INFO */
+    if (SQL_SUCCEEDED(row_res) && SQL_SUCCEEDED(row_res))
+    {
+      *res= SQL_SUCCESS_WITH_INFO;
+    }
+    /* Else error */
+    else if (rownum == 0)
+    {
+      /* SQL_ERROR only if all rows fail */
+      *res= SQL_ERROR;
+    }
+    else
+    {
+      *res= SQL_SUCCESS_WITH_INFO;
+    }
+  }
+
+  /* "Fetching" includes buffers filling. I think errors in that 
+     have to affect row status */
+
+  if (rgfRowStatus)
+  {
+    rgfRowStatus[rownum]= sqlreturn2row_status(row_res);
+  }
+  /*
+    No need to update rowStatusPtr_ex, it's the same as rgfRowStatus.
+  */
+  if (upd_status && stmt->ird->array_status_ptr)
+  {
+    stmt->ird->array_status_ptr[rownum]= sqlreturn2row_status(row_res);
+  }
+}
+
+
 /*
   @type    : myodbc3 internal
   @purpose : fetches the specified row from the result set and
@@ -1896,6 +2233,9 @@ SQLRETURN SQL_API myodbc_single_fetch( SQLHSTMT             hstmt,
     reset_getdata_position(stmt);
     stmt->current_values= 0;          /* For SQLGetData */
 
+    if (desc_hot_refresh(stmt->ard, stmt->ard->count))
+      return set_error(stmt, MYERR_S1001, NULL, 4001);
+
     switch ( fFetchType )
     {
       case SQL_FETCH_NEXT:
@@ -2098,7 +2438,7 @@ SQLRETURN SQL_API myodbc_single_fetch( SQLHSTMT             hstmt,
                               stmt->result->field_count);
     }
 
-    row_res= fill_fetch_buffers(stmt, values, cur_row);
+    row_res= fill_fetch_buffers(stmt, values, NULL, cur_row);
 
     /* For SQL_SUCCESS we need all rows to be SQL_SUCCESS */
     if (res != row_res)
@@ -2216,6 +2556,8 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
     SQLULEN           dummy_pcrow;
     BOOL              disconnected= FALSE;
     long              brow= 0;
+    MYODBC_WORKERS    *pool;
+    FETCH_ROWSET      *rowset= NULL;
 
     if ( !stmt->result )
       return set_stmt_error(stmt, "24000", "Fetch without a SELECT", 0);
@@ -2259,6 +2601,9 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
     reset_getdata_position(stmt);
     stmt->current_values= 0;          /* For SQLGetData */
 
+    if (desc_hot_refresh(stmt->ard, stmt->ard->count))
+      return set_error(stmt, MYERR_S1001, NULL, 4001);
+
     switch ( fFetchType )
     {
       case SQL_FETCH_NEXT:
@@ -2351,6 +2696,7 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
           might be deleted
         */
         if ( stmt->stmt_options.cursor_type != SQL_CURSOR_DYNAMIC &&
+             !stmt->keyset &&
              cur_row && cur_row == (long)(stmt->current_row +
                                           stmt->rows_found_in_set) )
             row_seek(stmt, stmt->end_of_set);
@@ -2390,11 +2736,23 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
       }
     }
 
+    /* The rows of a keyset cursor are read again for each rowset */
+    if (stmt->keyset &&
+        keyset_load(stmt, cur_row, rows_to_fetch) != SQL_SUCCESS)
+    {
+      return SQL_ERROR;
+    }
+
     if (!stmt->dbc->ds->dont_use_set_locale)
     {
       setlocale(LC_NUMERIC, "C");
     }
 
+    if ((pool= parallel_fetch_pool(stmt, rows_to_fetch, fFetchType)))
+    {
+      rowset= parallel_fetch_rowset(stmt, rows_to_fetch);
+    }
+
     res= SQL_SUCCESS;
     for (i= 0 ; i < rows_to_fetch ; ++i)
     {
@@ -2417,7 +2775,21 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
         if ( stmt->out_params_state == OPS_UNKNOWN
           && !(values= fetch_row(stmt)) )
         {
-          if (scroller_exists(stmt))
+          if (stmt->keyset && cur_row < max_row)
+          {
+            /* The key is not found anymore, the row has been deleted */
+            if (rgfRowStatus)
+            {
+              rgfRowStatus[i]= SQL_ROW_DELETED;
+            }
+            if (upd_status && stmt->ird->array_status_ptr)
+            {
+              stmt->ird->array_status_ptr[i]= SQL_ROW_DELETED;
+            }
+            ++cur_row;
+            continue;
+          }
+          else if (scroller_exists(stmt))
           {
             scroller_move(stmt);
 
@@ -2483,45 +2855,36 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
       {
         row_book= fill_fetch_bookmark_buffers(stmt, irow + i + 1, i);
       }  
-      row_res= fill_fetch_buffers(stmt, values, i);
 
-      /* For SQL_SUCCESS we need all rows to be SQL_SUCCESS */
-      if (res != row_res || res != row_book)
+      if (rowset)
       {
-        /* Any successful row makes overall result SQL_SUCCESS_WITH_INFO */
-        if (SQL_SUCCEEDED(row_res) && SQL_SUCCEEDED(row_res))
-        {
-          res= SQL_SUCCESS_WITH_INFO;
-        }
-        /* Else error */
-        else if (i == 0)
-        {
-          /* SQL_ERROR only if all rows fail */
-          res= SQL_ERROR;
-        }
-        else
-        {
-          res= SQL_SUCCESS_WITH_INFO;
-        }
+        /* Buffers are filled once the whole rowset has been read */
+        parallel_fetch_add_row(stmt, rowset, values, (uint)i);
+        ++cur_row;
+        continue;
       }
 
-      /* "Fetching" includes buffers filling. I think errors in that 
-         have to affect row status */
+      row_res= fill_fetch_buffers(stmt, values, NULL, i);
+      set_row_result(stmt, i, row_res, row_book, &res, rgfRowStatus,
+                     upd_status);
 
-      if (rgfRowStatus)
-      {
-        rgfRowStatus[i]= sqlreturn2row_status(row_res);
-      }
-      /*
-        No need to update rowStatusPtr_ex, it's the same as rgfRowStatus.
-      */
-      if (upd_status && stmt->ird->array_status_ptr)
+      ++cur_row;
+    }   /* fetching cycle end*/
+
+    if (rowset)
+    {
+      SQLULEN j;
+
+      parallel_fetch_fill(stmt, pool, rowset, (uint)i);
+
+      for (j= 0; j < i; ++j)
       {
-        stmt->ird->array_status_ptr[i]= sqlreturn2row_status(row_res);
+        set_row_result(stmt, j, rowset->results[j], SQL_SUCCESS, &res,
+                       rgfRowStatus, upd_status);
       }
 
-      ++cur_row;
-    }   /* fetching cycle end*/
+      x_free(rowset);
+    }
 
     stmt->rows_found_in_set= i;
     *pcrow= i;
@@ -2623,9 +2986,13 @@ SQLRETURN SQL_API SQLFetchScroll( SQLHSTMT      StatementHandle,
 {
     STMT *stmt = (STMT *)StatementHandle;
     STMT_OPTIONS *options;
+    SQLRETURN rc;
+    ulonglong start;
 
     CHECK_HANDLE(stmt);
 
+    start= LATENCY_BEGIN(stmt->dbc->env);
+
     options= &stmt->stmt_options;
     options->rowStatusPtr_ex= NULL;
 
@@ -2644,9 +3011,12 @@ SQLRETURN SQL_API SQLFetchScroll( SQLHSTMT      StatementHandle,
                        stmt->stmt_options.bookmark_ptr);
     }
 
-    return my_SQLExtendedFetch(StatementHandle, FetchOrientation, FetchOffset,
-                               stmt->ird->rows_processed_ptr, stmt->ird->array_status_ptr,
-                               0);
+    rc= my_SQLExtendedFetch(StatementHandle, FetchOrientation, FetchOffset,
+                            stmt->ird->rows_processed_ptr, stmt->ird->array_status_ptr,
+                            0);
+
+    LATENCY_END(stmt->dbc->env, LATENCY_FETCH_SCROLL, start);
+    return rc;
 }
 
 /*
@@ -2659,13 +3029,20 @@ SQLRETURN SQL_API SQLFetch(SQLHSTMT StatementHandle)
 {
     STMT *stmt = (STMT *)StatementHandle;
     STMT_OPTIONS *options;
+    SQLRETURN rc;
+    ulonglong start;
 
     CHECK_HANDLE(stmt);
 
+    start= LATENCY_BEGIN(stmt->dbc->env);
+
     options= &stmt->stmt_options;
     options->rowStatusPtr_ex= NULL;
 
-    return my_SQLExtendedFetch(StatementHandle, SQL_FETCH_NEXT, 0,
-                               stmt->ird->rows_processed_ptr, stmt->ird->array_status_ptr,
-                               0);
+    rc= my_SQLExtendedFetch(StatementHandle, SQL_FETCH_NEXT, 0,
+                            stmt->ird->rows_processed_ptr, stmt->ird->array_status_ptr,
+                            0);
+
+    LATENCY_END(stmt->dbc->env, LATENCY_FETCH, start);
+    return rc;
 }
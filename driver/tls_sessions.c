@@ -0,0 +1,293 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  tls_sessions.c
+  @brief Cache of TLS sessions for resumption on new connections.
+
+  After a connection over TLS is established, its session is kept in the
+  environment, under a key made of the server endpoint and of the SSL
+  settings of the data source. The next connection with the same key
+  offers that session to the server, which saves the full handshake when
+  the server accepts it. Resumption needs a client library that can
+  export and import sessions (MySQL 8.0.29 and later); with older ones
+  the cache stays empty.
+*/
+
+#include "driver.h"
+
+/* Number of sessions kept, the least recently stored one goes first */
+#define TLS_SESSIONS_MAX 32
+
+typedef struct
+{
+  char   *key;
+  char   *data;      /* serialized session */
+  ulong   stored;    /* store sequence number, for the replacement */
+} MYODBC_TLS_SESSION;
+
+struct st_myodbc_tls_sessions
+{
+  MYODBC_TLS_SESSION entries[TLS_SESSIONS_MAX];
+  uint               count;
+  ulong              stores;
+  ulong              hits;     /* connections that resumed a session */
+  ulong              misses;   /* TLS connections that made a handshake */
+};
+
+
+#if MYSQL_VERSION_ID >= 80029
+/**
+  Build the cache key of a connection attempt.
+
+  @return TRUE if the key did not fit in the buffer, in which case the
+          session is not cached
+*/
+static my_bool tls_session_key(DataSource *ds, const char *host, uint port,
+                               char *key, size_t size)
+{
+  size_t len= myodbc_snprintf(key, size, "%s:%u|%s|%s|%s|%s|%s|%s|%u|%d%d%d",
+                              host ? host : "", port,
+                              ds->sslmode8 ? (char *)ds->sslmode8 : "",
+                              ds->sslca8 ? (char *)ds->sslca8 : "",
+                              ds->sslcapath8 ? (char *)ds->sslcapath8 : "",
+                              ds->sslcert8 ? (char *)ds->sslcert8 : "",
+                              ds->sslkey8 ? (char *)ds->sslkey8 : "",
+                              ds->sslcipher8 ? (char *)ds->sslcipher8 : "",
+                              ds->sslverify, ds->tls_1, ds->no_tls_1_1,
+                              ds->no_tls_1_2);
+
+  return len >= size;
+}
+
+
+/**
+  Find the cached session of a key.
+
+  Must be called with the environment lock held.
+*/
+static MYODBC_TLS_SESSION *tls_session_find(ENV *env, const char *key)
+{
+  uint i;
+
+  if (!env->tls_sessions)
+  {
+    return NULL;
+  }
+
+  for (i= 0; i < env->tls_sessions->count; ++i)
+  {
+    if (!strcmp(env->tls_sessions->entries[i].key, key))
+    {
+      return &env->tls_sessions->entries[i];
+    }
+  }
+
+  return NULL;
+}
+#endif
+
+
+/**
+  Offer the cached session of a server, if any, to the next connection
+  attempt.
+
+  @param[in]  dbc   Connection about to connect
+  @param[in]  ds    Data source of the connection
+  @param[in]  host  Host of the attempt
+  @param[in]  port  Port of the attempt
+*/
+void tls_sessions_apply(DBC *dbc, DataSource *ds, const char *host,
+                        uint port)
+{
+#if MYSQL_VERSION_ID >= 80029
+  ENV *env= dbc->env;
+  MYODBC_TLS_SESSION *session;
+  char key[1024];
+  char *data= NULL;
+
+  if (!tls_session_key(ds, host, port, key, sizeof(key)))
+  {
+    myodbc_mutex_lock(&env->lock);
+    if ((session= tls_session_find(env, key)))
+    {
+      data= myodbc_strdup(session->data, MYF(0));
+    }
+    myodbc_mutex_unlock(&env->lock);
+  }
+
+  /* The options may keep the session of the previous host of a list */
+  mysql_options(&dbc->mysql, MYSQL_OPT_SSL_SESSION_DATA, data);
+  x_free(data);
+#endif
+}
+
+
+/**
+  Record the session of a connection that was just established, and
+  whether it was resumed.
+
+  @param[in]  dbc   Connection just established
+  @param[in]  ds    Data source of the connection
+  @param[in]  host  Host connected to
+  @param[in]  port  Port connected to
+*/
+void tls_sessions_save(DBC *dbc, DataSource *ds, const char *host, uint port)
+{
+#if MYSQL_VERSION_ID >= 80029
+  ENV *env= dbc->env;
+  struct st_myodbc_tls_sessions *sessions;
+  MYODBC_TLS_SESSION *session;
+  my_bool reused;
+  char key[1024];
+  char *data;
+  uint i, len;
+
+  /* Nothing to keep from a connection without TLS */
+  if (!mysql_get_ssl_cipher(&dbc->mysql) ||
+      tls_session_key(ds, host, port, key, sizeof(key)))
+  {
+    return;
+  }
+
+  reused= mysql_get_ssl_session_reused(&dbc->mysql);
+  data= (char *)mysql_get_ssl_session_data(&dbc->mysql, 0, &len);
+
+  myodbc_mutex_lock(&env->lock);
+
+  sessions= env->tls_sessions;
+  if (!sessions)
+  {
+    sessions= (struct st_myodbc_tls_sessions *)
+      myodbc_malloc(sizeof(struct st_myodbc_tls_sessions), MYF(MY_ZEROFILL));
+    env->tls_sessions= sessions;
+  }
+
+  if (sessions)
+  {
+    if (reused)
+      ++sessions->hits;
+    else
+      ++sessions->misses;
+
+    if (data && (session= tls_session_find(env, key)))
+    {
+      x_free(session->data);
+      session->data= myodbc_strdup(data, MYF(0));
+      session->stored= ++sessions->stores;
+    }
+    else if (data)
+    {
+      if (sessions->count < TLS_SESSIONS_MAX)
+      {
+        session= &sessions->entries[sessions->count++];
+      }
+      else
+      {
+        session= &sessions->entries[0];
+        for (i= 1; i < sessions->count; ++i)
+        {
+          if (sessions->entries[i].stored < session->stored)
+            session= &sessions->entries[i];
+        }
+        x_free(session->key);
+        x_free(session->data);
+      }
+
+      session->key= myodbc_strdup(key, MYF(0));
+      session->data= myodbc_strdup(data, MYF(0));
+      session->stored= ++sessions->stores;
+    }
+
+    /* An entry that could not be filled is dropped */
+    if (data && (!session->key || !session->data))
+    {
+      x_free(session->key);
+      x_free(session->data);
+      *session= sessions->entries[--sessions->count];
+    }
+  }
+
+  myodbc_mutex_unlock(&env->lock);
+
+  if (data)
+  {
+    mysql_free_ssl_session_data(&dbc->mysql, data);
+  }
+#endif
+}
+
+
+/**
+  Write to the query log whether the session of a connection was resumed,
+  with the counters of the environment.
+
+  @param[in]  dbc   Connection just established, with its query log open
+*/
+void tls_sessions_report(DBC *dbc)
+{
+#if MYSQL_VERSION_ID >= 80029
+  ENV *env= dbc->env;
+  char buff[96];
+
+  if (!dbc->ds->save_queries || !mysql_get_ssl_cipher(&dbc->mysql))
+  {
+    return;
+  }
+
+  myodbc_mutex_lock(&env->lock);
+  myodbc_snprintf(buff, sizeof(buff),
+                  "TLS session %s (resumed: %lu, full handshakes: %lu)",
+                  mysql_get_ssl_session_reused(&dbc->mysql) ? "resumed"
+                                                            : "negotiated",
+                  env->tls_sessions ? env->tls_sessions->hits : 0,
+                  env->tls_sessions ? env->tls_sessions->misses : 0);
+  myodbc_mutex_unlock(&env->lock);
+
+  MYLOG_DBC_QUERY(dbc, buff);
+#endif
+}
+
+
+/**
+  Free the TLS sessions cached in the environment.
+*/
+void tls_sessions_free(ENV *env)
+{
+  uint i;
+
+  if (!env->tls_sessions)
+  {
+    return;
+  }
+
+  for (i= 0; i < env->tls_sessions->count; ++i)
+  {
+    x_free(env->tls_sessions->entries[i].key);
+    x_free(env->tls_sessions->entries[i].data);
+  }
+
+  x_free(env->tls_sessions);
+  env->tls_sessions= NULL;
+}
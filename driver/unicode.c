@@ -86,14 +86,18 @@ SQLColAttributeWImpl(SQLHSTMT hstmt, SQLUSMALLINT column,
   SQLCHAR *value= NULL;
   SQLWCHAR *wvalue;
   SQLINTEGER len= SQL_NTS;
-  uint errors;
   SQLRETURN rc= MySQLColAttribute(hstmt, column, field, &value, num_attr);
 
   if (value)
   {
-    my_bool free_value= FALSE;
-    wvalue= sqlchar_as_sqlwchar(stmt->dbc->cxn_charset_info, value,
-                                &len, &errors);
+    /* The string belongs to the IRD record, its conversion is kept there */
+    wvalue= desc_get_wstr(stmt->ird, column - 1, value,
+                          stmt->dbc->cxn_charset_info, &len);
+    if (len == -1)
+    {
+      set_mem_error(&stmt->dbc->mysql);
+      return handle_connection_error(stmt);
+    }
 
     /* char_attr_max is in bytes, we want it in chars. */
     char_attr_max/= sizeof(SQLWCHAR);
@@ -112,10 +116,6 @@ SQLColAttributeWImpl(SQLHSTMT hstmt, SQLUSMALLINT column,
                    len * sizeof(SQLWCHAR));
       ((SQLWCHAR *)char_attr)[len]= 0;
     }
-
-    if (free_value)
-      x_free(value);
-    x_free(wvalue);
   }
 
   return rc;
@@ -191,10 +191,12 @@ SQLColumnsW(SQLHSTMT hstmt,
   SQLINTEGER len;
   uint errors= 0;
   DBC *dbc;
+  ulonglong start;
 
   CHECK_HANDLE(hstmt);
 
   dbc= ((STMT *)hstmt)->dbc;
+  start= LATENCY_BEGIN(dbc->env);
 
   len= catalog_len;
   catalog8= sqlwchar_as_sqlchar(dbc->cxn_charset_info, catalog, &len, &errors);
@@ -220,6 +222,7 @@ SQLColumnsW(SQLHSTMT hstmt,
   x_free(table8);
   x_free(column8);
 
+  LATENCY_END(dbc->env, LATENCY_COLUMNS, start);
   return rc;
 }
 
@@ -229,11 +232,18 @@ SQLConnectW(SQLHDBC hdbc, SQLWCHAR *dsn, SQLSMALLINT dsn_len,
             SQLWCHAR *user, SQLSMALLINT user_len,
             SQLWCHAR *auth, SQLSMALLINT auth_len)
 {
+  SQLRETURN rc;
+  ulonglong start= latency_now();
+
   CHECK_HANDLE(hdbc);
 
   ((DBC *)hdbc)->unicode= TRUE; /* Hooray, a Unicode connection! */
 
-  return MySQLConnect(hdbc, dsn, dsn_len, user, user_len, auth, auth_len);
+  rc= MySQLConnect(hdbc, dsn, dsn_len, user, user_len, auth, auth_len);
+
+  /* Timed in any case, the connection may turn the statistics on */
+  LATENCY_END(((DBC *)hdbc)->env, LATENCY_CONNECT, start);
+  return rc;
 }
 
 
@@ -244,6 +254,8 @@ SQLDriverConnectW(SQLHDBC hdbc, SQLHWND hwnd,
                   SQLUSMALLINT completion)
 {
   SQLSMALLINT dummy_out_len = 0;
+  SQLRETURN rc;
+  ulonglong start= latency_now();
 
   CHECK_HANDLE(hdbc);
 
@@ -253,8 +265,12 @@ SQLDriverConnectW(SQLHDBC hdbc, SQLHWND hwnd,
 
   ((DBC *)hdbc)->unicode= TRUE; /* Hooray, a Unicode connection! */
 
-  return MySQLDriverConnect(hdbc, hwnd, in, in_len, out, out_max,
-                            out_len, completion);
+  rc= MySQLDriverConnect(hdbc, hwnd, in, in_len, out, out_max,
+                         out_len, completion);
+
+  /* Timed in any case, the connection may turn the statistics on */
+  LATENCY_END(((DBC *)hdbc)->env, LATENCY_DRIVER_CONNECT, start);
+  return rc;
 }
 
 
@@ -286,8 +302,14 @@ SQLDescribeColW(SQLHSTMT hstmt, SQLUSMALLINT column,
 
   if (value)
   {
-    wvalue= sqlchar_as_sqlwchar(stmt->dbc->cxn_charset_info, value, &len,
-                                &errors);
+    /* Names built for the call are converted once, names of the IRD
+       records are converted once per result */
+    if (free_value)
+      wvalue= sqlchar_as_sqlwchar(stmt->dbc->cxn_charset_info, value, &len,
+                                  &errors);
+    else
+      wvalue= desc_get_wstr(stmt->ird, column - 1, value,
+                            stmt->dbc->cxn_charset_info, &len);
     if (len == -1)
     {
       if (free_value)
@@ -312,8 +334,10 @@ SQLDescribeColW(SQLHSTMT hstmt, SQLUSMALLINT column,
     }
 
     if (free_value)
+    {
       x_free(value);
-    x_free(wvalue);
+      x_free(wvalue);
+    }
   }
 
   return rc;
@@ -354,13 +378,18 @@ SQLRETURN SQL_API
 SQLExecDirectW(SQLHSTMT hstmt, SQLWCHAR *str, SQLINTEGER str_len)
 {
   int error;
+  ENV *env;
+  ulonglong start;
 
   CHECK_HANDLE(hstmt);
 
-  if ((error= SQLPrepareWImpl(hstmt, str, str_len)))
-    return error;
-  error= my_SQLExecute((STMT *)hstmt);
+  env= ((STMT *)hstmt)->dbc->env;
+  start= LATENCY_BEGIN(env);
+
+  if (!(error= SQLPrepareWImpl(hstmt, str, str_len)))
+    error= my_SQLExecute((STMT *)hstmt);
 
+  LATENCY_END(env, LATENCY_EXEC_DIRECT, start);
   return error;
 }
 
@@ -842,9 +871,19 @@ SQLNativeSqlW(SQLHDBC hdbc, SQLWCHAR *in, SQLINTEGER in_len,
 SQLRETURN SQL_API
 SQLPrepareW(SQLHSTMT hstmt, SQLWCHAR *str, SQLINTEGER str_len)
 {
+  SQLRETURN rc;
+  ENV *env;
+  ulonglong start;
+
   CHECK_HANDLE(hstmt);
 
-  return SQLPrepareWImpl(hstmt, str, str_len);
+  env= ((STMT *)hstmt)->dbc->env;
+  start= LATENCY_BEGIN(env);
+
+  rc= SQLPrepareWImpl(hstmt, str, str_len);
+
+  LATENCY_END(env, LATENCY_PREPARE, start);
+  return rc;
 }
 
 
@@ -1222,10 +1261,12 @@ SQLTablesW(SQLHSTMT hstmt,
   SQLINTEGER len;
   uint errors= 0;
   DBC *dbc;
+  ulonglong start;
 
   CHECK_HANDLE(hstmt);
 
   dbc= ((STMT *)hstmt)->dbc;
+  start= LATENCY_BEGIN(dbc->env);
 
   /* we must preserve NULL/blank strings for SQLTables() semantics */
 
@@ -1262,6 +1303,7 @@ SQLTablesW(SQLHSTMT hstmt,
     x_free(table8);
   x_free(type8);
 
+  LATENCY_END(dbc->env, LATENCY_TABLES, start);
   return rc;
 }
 
@@ -106,6 +106,12 @@ SQLRETURN exec_stmt_query(STMT *stmt, const char *query,
     return rc;
   }
 
+  /* Positioned updates and deletes change data behind cached results */
+  if (myodbc_casecmp(query, "SELECT", 6) && myodbc_casecmp(query, "SHOW", 4))
+  {
+    result_cache_clear(stmt->dbc->env);
+  }
+
   MYLOG_QUERY(stmt, "pre-odbc_stmt in exec_stmt_query");
   return odbc_stmt2(stmt, query, query_length, req_lock);
 }
@@ -217,6 +223,9 @@ void fix_result_types(STMT *stmt)
 
   stmt->state= ST_EXECUTED;  /* Mark set found */
 
+  /* Names of the previous result are not valid anymore */
+  desc_free_wstrs(stmt->ird);
+
   /* Populate the IRD records */
   for (i= 0; i < field_count(stmt); ++i)
   {
@@ -660,6 +669,51 @@ copy_ansi_result(STMT *stmt,
     stmt->getdata.latest_used+= new_bytes;
   }
 
+  /*
+    No character is split between two buffers with a single-byte ANSI
+    character set, so the data goes by chunks through copy_and_convert(),
+    which uses a direct conversion table for such character sets.
+  */
+  while (to_cs->mbmaxlen == 1 && src < src_end)
+  {
+    char buff[512];
+    uint32 consumed, chars, bytes;
+    uint errors= 0;
+
+    bytes= copy_and_convert(result ? (char *)result : buff,
+                            result ? (uint32)(result_end - result)
+                                   : (uint32)sizeof(buff),
+                            to_cs, src, (uint32)(src_end - src), from_cs,
+                            &consumed, &chars, &errors);
+    error_count+= errors;
+
+    /* An incomplete character is left to the loop below */
+    if (!consumed)
+      break;
+
+    used_bytes+= bytes;
+    used_chars+= chars;
+    src+= consumed;
+
+    if (result)
+    {
+      result+= bytes;
+      stmt->getdata.source+= consumed;
+
+      if (result == result_end)
+      {
+        /* The rest is converted by the next call */
+        if (stmt->getdata.dst_bytes != (ulong)~0L)
+        {
+          src= src_end;
+          break;
+        }
+        *result= '\0';
+        result= NULL;
+      }
+    }
+  }
+
   while (src < src_end)
   {
     /* Find the conversion functions. */
@@ -797,6 +851,66 @@ convert_to_out:
 }
 
 
+/*
+  Count the SQLWCHAR units a valid utf8 string converts to, without
+  converting it.
+
+  @param[in]  src     Start of the string
+  @param[in]  end     End of the string
+  @param[in]  maxlen  Longest character of the utf8 variant, 3 or 4
+
+  @return Number of SQLWCHAR units, or -1 if the string is not valid or
+          ends in the middle of a character, in which case it has to be
+          converted to know its length
+*/
+static long utf8_wchar_count(const uchar *src, const uchar *end, uint maxlen)
+{
+  long count= 0;
+
+  while (src < end)
+  {
+    if (*src < 0x80)
+    {
+      ++src;
+      ++count;
+    }
+    else if (*src >= 0xC2 && *src < 0xE0)
+    {
+      if (end - src < 2 || (src[1] & 0xC0) != 0x80)
+        return -1;
+      src+= 2;
+      ++count;
+    }
+    else if (*src >= 0xE0 && *src < 0xF0)
+    {
+      /* Overlong forms and surrogates are left to the conversion */
+      if (end - src < 3 || (src[1] & 0xC0) != 0x80 ||
+          (src[2] & 0xC0) != 0x80 || (*src == 0xE0 && src[1] < 0xA0) ||
+          (*src == 0xED && src[1] >= 0xA0))
+        return -1;
+      src+= 3;
+      ++count;
+    }
+    else if (maxlen > 3 && *src >= 0xF0 && *src < 0xF5)
+    {
+      if (end - src < 4 || (src[1] & 0xC0) != 0x80 ||
+          (src[2] & 0xC0) != 0x80 || (src[3] & 0xC0) != 0x80 ||
+          (*src == 0xF0 && src[1] < 0x90) || (*src == 0xF4 && src[1] >= 0x90))
+        return -1;
+      src+= 4;
+      /* Outside of the BMP, UTF-16 needs a surrogate pair */
+      count+= sizeof(SQLWCHAR) == 2 ? 2 : 1;
+    }
+    else
+    {
+      return -1;
+    }
+  }
+
+  return count;
+}
+
+
 /**
   Copy a result from the server into a buffer as a SQL_C_WCHAR.
 
@@ -960,8 +1074,24 @@ convert_to_out:
 
       if (result && result == result_end)
       {
+        long rest;
+
         *result= 0;
         result= NULL;
+
+        /* Once the length is known, the rest is left to the next calls */
+        if (stmt->getdata.dst_bytes != (ulong)~0L)
+          break;
+
+        /* Otherwise only the length of the rest is needed */
+        if (is_utf8_charset(from_cs->number) &&
+            (rest= utf8_wchar_count((uchar *)src, (uchar *)src_end,
+                                    myodbc_min(from_cs->mbmaxlen,
+                                      utf8_charset_info->mbmaxlen))) >= 0)
+        {
+          used_chars+= rest;
+          break;
+        }
       }
     }
     else if (stmt->getdata.latest_bytes == MY_CS_ILUNI && wc != '?')
@@ -2027,6 +2157,181 @@ SQLLEN get_bookmark_value(SQLSMALLINT fCType, SQLPOINTER rgbValue)
 }
 
 
+/*
+  Fixed-format date/time parsing.
+
+  Almost all date and time values come from the server in the canonical
+  "YYYY-MM-DD HH:MM:SS[.fffffffff]" layout. Such strings are checked eight
+  bytes at a time against a layout and then decoded from fixed positions.
+  Anything that does not match goes to the generic parsers below.
+*/
+
+/* Layout of 8 bytes: digit positions and separators expected elsewhere */
+typedef struct
+{
+  char digits[8];   /* 0xff where a digit is expected */
+  char seps[8];     /* separators, 0 at digit positions */
+} DT_LAYOUT;
+
+/* "YYYY-MM-" */
+static const DT_LAYOUT dt_layout_ymd= {"\xff\xff\xff\xff\0\xff\xff\0",
+                                       "\0\0\0\0-\0\0-"};
+/* "YY-MM-DD" */
+static const DT_LAYOUT dt_layout_ymd_end= {"\xff\xff\0\xff\xff\0\xff\xff",
+                                           "\0\0-\0\0-\0\0"};
+/* "DD HH:MM" */
+static const DT_LAYOUT dt_layout_dhm= {"\xff\xff\0\xff\xff\0\xff\xff",
+                                       "\0\0 \0\0:\0\0"};
+/* "HH:MM:SS" */
+static const DT_LAYOUT dt_layout_hms= {"\xff\xff\0\xff\xff\0\xff\xff",
+                                       "\0\0:\0\0:\0\0"};
+
+#define DT_DIGITS2(p) ((uint)((p)[0] - '0') * 10 + (uint)((p)[1] - '0'))
+
+/**
+  Check 8 bytes of a string against a layout.
+
+  All 8 bytes are loaded in a single word, digits are validated at once
+  by checking that each byte masked as digit has 0x3 for high nibble and
+  that adding 6 to its low nibble does not carry into the high nibble.
+
+  @param[in]  str     String, must have at least 8 bytes
+  @param[in]  layout  Expected layout
+
+  @return TRUE if the bytes match the layout
+*/
+static my_bool dt_layout_match(const char *str, const DT_LAYOUT *layout)
+{
+  ulonglong word, mask, seps;
+
+  memcpy(&word, str, 8);
+  memcpy(&mask, layout->digits, 8);
+  memcpy(&seps, layout->seps, 8);
+
+  if ((word & ~mask) != seps)
+  {
+    return FALSE;
+  }
+
+  word&= mask;
+
+  return (word & 0xf0f0f0f0f0f0f0f0ULL) == (0x3030303030303030ULL & mask) &&
+         (((word & 0x0f0f0f0f0f0f0f0fULL) + (0x0606060606060606ULL & mask))
+          & 0xf0f0f0f0f0f0f0f0ULL) == 0;
+}
+
+
+/**
+  Parse a string in the canonical "YYYY-MM-DD HH:MM:SS[.fffffffff]" format.
+
+  @return 0 on success, SQLTS_NULL_DATE for a zero date that is not
+          converted, 1 if the string is not in the canonical format
+*/
+static int str_to_ts_fixed(SQL_TIMESTAMP_STRUCT *ts, const char *str,
+                            uint len, int zeroToMin, BOOL dont_use_set_locale)
+{
+  SQLUINTEGER fraction= 0;
+  uint month, day;
+
+  if (len < 19 ||
+      !dt_layout_match(str, &dt_layout_ymd) ||
+      !dt_layout_match(str + 8, &dt_layout_dhm) ||
+      !dt_layout_match(str + 11, &dt_layout_hms))
+  {
+    return 1;
+  }
+
+  if (len > 19)
+  {
+    const char *pos= str + 20, *end= str + len;
+    uint digits= len - 20;
+
+    /* With the locale decimal point the generic parser has to look for it */
+    if (!dont_use_set_locale || str[19] != '.' || digits < 1 || digits > 9)
+    {
+      return 1;
+    }
+
+    for (; pos < end; ++pos)
+    {
+      if (!isdigit(*pos))
+      {
+        return 1;
+      }
+      fraction= fraction * 10 + (*pos - '0');
+    }
+
+    for (; digits < 9; ++digits)
+    {
+      fraction*= 10;
+    }
+  }
+
+  month= DT_DIGITS2(str + 5);
+  day=   DT_DIGITS2(str + 8);
+
+  if (!month || !day)
+  {
+    if (!zeroToMin) /* Don't convert invalid */
+      return SQLTS_NULL_DATE;
+
+    /* convert invalid to min allowed */
+    if (!month)
+      month= 1;
+    if (!day)
+      day= 1;
+  }
+
+  ts->year=     DT_DIGITS2(str) * 100 + DT_DIGITS2(str + 2);
+  ts->month=    month;
+  ts->day=      day;
+  ts->hour=     DT_DIGITS2(str + 11);
+  ts->minute=   DT_DIGITS2(str + 14);
+  ts->second=   DT_DIGITS2(str + 17);
+  ts->fraction= fraction;
+
+  return 0;
+}
+
+
+/**
+  Convert a MYSQL_TIME of a binary protocol result to a timestamp, without
+  going through its string representation.
+
+  @param[out] ts          Timestamp to fill, can be NULL
+  @param[in]  t           DATE, DATETIME or TIMESTAMP value
+  @param[in]  zeroToMin   Convert zero month and day to 1
+
+  @return Same as str_to_ts()
+*/
+int mysql_time_to_ts(SQL_TIMESTAMP_STRUCT *ts, const MYSQL_TIME *t,
+                     int zeroToMin)
+{
+  SQL_TIMESTAMP_STRUCT tmp_timestamp;
+
+  if (!ts)
+  {
+    ts= &tmp_timestamp;
+  }
+
+  if (!t->month || !t->day)
+  {
+    if (!zeroToMin)
+      return SQLTS_NULL_DATE;
+  }
+
+  ts->year=     t->year;
+  ts->month=    t->month ? t->month : 1;
+  ts->day=      t->day ? t->day : 1;
+  ts->hour=     t->hour;
+  ts->minute=   t->minute;
+  ts->second=   t->second;
+  ts->fraction= t->second_part * 1000;
+
+  return 0;
+}
+
+
 /*
   @type    : myodbc internal
   @purpose : convert a possible string to a timestamp value
@@ -2052,6 +2357,14 @@ int str_to_ts(SQL_TIMESTAMP_STRUCT *ts, const char *str, int len, int zeroToMin,
       len= strlen(str);
     }
 
+    switch (str_to_ts_fixed(ts, str, len, zeroToMin, dont_use_set_locale))
+    {
+    case 0:
+      return 0;
+    case SQLTS_NULL_DATE:
+      return SQLTS_NULL_DATE;
+    }
+
     /* We don't wan to change value in the out parameter directly
        before we know that string is a good datetime */
     end= get_fractional_part(str, len, dont_use_set_locale, &fraction);
@@ -2146,6 +2459,18 @@ my_bool str_to_time_st(SQL_TIME_STRUCT *ts, const char *str)
     if ( !ts )
         ts= (SQL_TIME_STRUCT *) &tmp_time;
 
+    /* "HH:MM:SS" with optional fractional part */
+    if (strlen(str) >= 8 && dt_layout_match(str, &dt_layout_hms)
+        && (!str[8] || str[8] == '.')
+        && str[3] <= '5' && str[6] <= '5')
+    {
+      ts->hour  = DT_DIGITS2(str);
+      ts->minute= DT_DIGITS2(str + 3);
+      ts->second= DT_DIGITS2(str + 6);
+
+      return 0;
+    }
+
     /* remember the position of the first numeric string */
     tokens[0]= buff;
 
@@ -2208,6 +2533,23 @@ my_bool str_to_date(SQL_DATE_STRUCT *rgbValue, const char *str,
     uint field_length,year_length,digits,i,date[3];
     const char *pos;
     const char *end= str+length;
+
+    /* "YYYY-MM-DD", possibly followed by the time part */
+    if (length >= 10 && dt_layout_match(str, &dt_layout_ymd)
+        && dt_layout_match(str + 2, &dt_layout_ymd_end))
+    {
+      uint month= DT_DIGITS2(str + 5), day= DT_DIGITS2(str + 8);
+
+      if ((!month || !day) && !zeroToMin)
+        return 1;
+
+      rgbValue->year=  DT_DIGITS2(str) * 100 + DT_DIGITS2(str + 2);
+      rgbValue->month= month ? month : 1;
+      rgbValue->day=   day ? day : 1;
+
+      return 0;
+    }
+
     for ( ; !isdigit(*str) && str != end ; ++str ) ;
     /*
       Calculate first number of digits.
@@ -2270,6 +2612,20 @@ ulong str_to_time_as_long(const char *str, uint length)
     if ( length == 0 )
         return 0;
 
+    /* "HH:MM:SS" or "YYYY-MM-DD HH:MM:SS" */
+    if (length == 8 && dt_layout_match(str, &dt_layout_hms))
+    {
+      return (ulong) DT_DIGITS2(str) * 10000L + DT_DIGITS2(str + 3) * 100L +
+             DT_DIGITS2(str + 6);
+    }
+    if (length == 19 && dt_layout_match(str, &dt_layout_ymd)
+        && dt_layout_match(str + 8, &dt_layout_dhm)
+        && dt_layout_match(str + 11, &dt_layout_hms))
+    {
+      return (ulong) DT_DIGITS2(str + 11) * 10000L +
+             DT_DIGITS2(str + 14) * 100L + DT_DIGITS2(str + 17);
+    }
+
     for ( ; !isdigit(*str) && str != end ; ++str ) --length;
 
     for ( i= 0 ; i < 3 && str != end; ++i )
@@ -2558,6 +2914,79 @@ my_bool is_minimum_version(const char *server_version,const char *version)
 }
 
 
+#define ESC_ONES  0x0101010101010101ULL
+#define ESC_HIGHS 0x8080808080808080ULL
+
+/* Non-zero if one of the bytes of the word is zero */
+#define ESC_HAS_ZERO(w) (((w) - ESC_ONES) & ~(w) & ESC_HIGHS)
+
+/* Bytes escaped in values and in patterns */
+static const char esc_value_bytes[]=   "\0\n\r\\'\"\032";
+static const char esc_pattern_bytes[]= "\0\n\r\\'\"\032_%";
+
+/**
+  Get the length of the run of bytes at the start of a string that can be
+  copied as is when escaping it.
+
+  The string is checked 8 bytes at a time: a byte equal to c is found by
+  looking for a zero byte in the word xor-ed with c in all bytes.
+
+  @param[in]  from          String to check
+  @param[in]  end           End of the string
+  @param[in]  special       Bytes that are escaped
+  @param[in]  special_count Number of bytes in special
+  @param[in]  stop_high     Whether bytes with the high bit set stop the run,
+                            for they may start a multibyte character
+
+  @return Length of the run
+*/
+static ulong escape_plain_run(const char *from, const char *end,
+                              const char *special, uint special_count,
+                              my_bool stop_high)
+{
+  const char *start= from;
+  uint i;
+
+  while (end - from >= 8)
+  {
+    ulonglong word;
+
+    memcpy(&word, from, 8);
+
+    if (stop_high && (word & ESC_HIGHS))
+    {
+      break;
+    }
+
+    for (i= 0; i < special_count; ++i)
+    {
+      ulonglong diff= word ^ (ESC_ONES * (uchar)special[i]);
+
+      if (ESC_HAS_ZERO(diff))
+      {
+        break;
+      }
+    }
+
+    if (i < special_count)
+    {
+      break;
+    }
+
+    from+= 8;
+  }
+
+  /* Rest of the string, or the word where the run ends */
+  while (from < end && !(stop_high && (uchar)*from >= 0x80) &&
+         !memchr(special, *from, special_count))
+  {
+    ++from;
+  }
+
+  return (ulong)(from - start);
+}
+
+
 /**
  Escapes a string that may contain wildcard characters (%, _) and other
  problematic characters (", ', \n, etc). Like mysql_real_escape_string() but
@@ -2580,10 +3009,34 @@ ulong myodbc_escape_string(MYSQL *mysql __attribute__((unused)),
   my_bool overflow= FALSE;
   CHARSET_INFO *charset_info= mysql->charset;
   my_bool use_mb_flag= use_mb(charset_info);
+  const char *special= escape_id ? "`" : esc_pattern_bytes;
+  uint special_count= escape_id ? 1 : sizeof(esc_pattern_bytes) - 1;
+
   for (end= from + length; from < end; ++from)
   {
     char escape= 0;
     int tmp_length;
+    ulong run= escape_plain_run(from, end, special, special_count,
+                                use_mb_flag);
+
+    /* Copy the bytes that need no escaping in one go */
+    if (run)
+    {
+      if (to + run > to_end)
+      {
+        overflow= TRUE;
+        break;
+      }
+      memcpy(to, from, run);
+      to+= run;
+      from+= run;
+
+      if (from == end)
+      {
+        break;
+      }
+    }
+
     if (use_mb_flag && (tmp_length= my_ismbchar(charset_info, from, end)))
     {
       if (to + tmp_length > to_end)
@@ -2665,62 +3118,148 @@ ulong myodbc_escape_string(MYSQL *mysql __attribute__((unused)),
 
 
 /**
-  Scale an int[] representing SQL_C_NUMERIC
-
-  @param[in] ary   Array in little endian form
-  @param[in] s     Scale
+  Escape a parameter value the way mysql_real_escape_string() does, but
+  copying the runs of bytes that need no escaping in one go. Only the
+  bytes that are escaped, or that may start a multibyte character, go
+  through the character by character path.
+
+  @param[in]   mysql   Connection, for the charset and the
+                       NO_BACKSLASH_ESCAPES sql mode
+  @param[out]  to      Buffer for escaped string, at least 2*length+1 bytes
+  @param[in]   from    The string to escape
+  @param[in]   length  The length of the string to escape
+
+  @return Length of the escaped string
 */
-static void sqlnum_scale(int *ary, int s)
+ulong myodbc_escape_value(MYSQL *mysql, char *to, const char *from,
+                          ulong length)
 {
-  /* multiply out all pieces */
-  while (s--)
-  {
-    ary[0] *= 10;
-    ary[1] *= 10;
-    ary[2] *= 10;
-    ary[3] *= 10;
-    ary[4] *= 10;
-    ary[5] *= 10;
-    ary[6] *= 10;
-    ary[7] *= 10;
-  }
-}
-
-
-/**
-  Unscale an int[] representing SQL_C_NUMERIC. This
-  leaves the last element (0) with the value of the
-  last digit.
+  CHARSET_INFO *charset_info= mysql->charset;
+  my_bool use_mb_flag= use_mb(charset_info);
+  my_bool quotes_only= (mysql->server_status &
+                        SERVER_STATUS_NO_BACKSLASH_ESCAPES) != 0;
+  const char *special= quotes_only ? "'" : esc_value_bytes;
+  uint special_count= quotes_only ? 1 : sizeof(esc_value_bytes) - 1;
+  const char *end= from + length, *to_start= to;
 
-  @param[in] ary   Array in little endian form
-*/
-static void sqlnum_unscale_le(int *ary)
-{
-  int i;
-  for (i= 7; i > 0; --i)
+  while (from < end)
   {
-    ary[i - 1] += (ary[i] % 10) << 16;
-    ary[i] /= 10;
-  }
-}
+    char escape= 0;
+    int tmp_length;
+    ulong run= escape_plain_run(from, end, special, special_count,
+                                use_mb_flag);
 
+    if (run)
+    {
+      memcpy(to, from, run);
+      to+= run;
+      from+= run;
 
-/**
-  Unscale an int[] representing SQL_C_NUMERIC. This
-  leaves the last element (7) with the value of the
-  last digit.
+      if (from == end)
+      {
+        break;
+      }
+    }
 
-  @param[in] ary   Array in big endian form
-*/
-static void sqlnum_unscale_be(int *ary, int start)
-{
-  int i;
-  for (i= start; i < 7; ++i)
-  {
-    ary[i + 1] += (ary[i] % 10) << 16;
-    ary[i] /= 10;
-  }
-}
+    if (use_mb_flag && (tmp_length= my_ismbchar(charset_info, from, end)))
+    {
+      memcpy(to, from, tmp_length);
+      to+= tmp_length;
+      from+= tmp_length;
+      continue;
+    }
+
+    if (quotes_only)
+    {
+      /* Quotes are doubled, anything else is kept */
+      if (*from == '\'')
+      {
+        *to++= '\'';
+      }
+      *to++= *from++;
+      continue;
+    }
+
+    /* See myodbc_escape_string() about bytes looking like multibyte */
+    if (use_mb_flag && my_mbcharlen(charset_info, (uchar)*from) > 1)
+      escape= *from;
+    else
+    switch (*from) {
+    case 0:
+      escape= '0';
+      break;
+    case '\n':
+      escape= 'n';
+      break;
+    case '\r':
+      escape= 'r';
+      break;
+    case '\\':
+    case '\'':
+    case '"':
+      escape= *from;
+      break;
+    case '\032':
+      escape= 'Z';
+      break;
+    }
+
+    if (escape)
+    {
+      *to++= '\\';
+      *to++= escape;
+    }
+    else
+    {
+      *to++= *from;
+    }
+    ++from;
+  }
+
+  *to= 0;
+  return (ulong)(to - to_start);
+}
+
+
+/**
+  Scale an int[] representing SQL_C_NUMERIC
+
+  @param[in] ary   Array in little endian form
+  @param[in] s     Scale
+*/
+static void sqlnum_scale(int *ary, int s)
+{
+  /* multiply out all pieces */
+  while (s--)
+  {
+    ary[0] *= 10;
+    ary[1] *= 10;
+    ary[2] *= 10;
+    ary[3] *= 10;
+    ary[4] *= 10;
+    ary[5] *= 10;
+    ary[6] *= 10;
+    ary[7] *= 10;
+  }
+}
+
+
+/**
+  Unscale an int[] representing SQL_C_NUMERIC. This
+  leaves the last element (0) with the value of the
+  last digit.
+
+  @param[in] ary   Array in little endian form
+*/
+static void sqlnum_unscale_le(int *ary)
+{
+  int i;
+  for (i= 7; i > 0; --i)
+  {
+    ary[i - 1] += (ary[i] % 10) << 16;
+    ary[i] /= 10;
+  }
+}
 
 
 /**
@@ -2742,18 +3281,13 @@ static void sqlnum_carry(int *ary)
 
 
 /**
-  Retrieve a SQL_NUMERIC_STRUCT from a string. The requested scale
-  and precesion are first read from sqlnum, and then updated values
-  are written back at the end.
-
-  @param[in] numstr       String representation of number to convert
-  @param[in] sqlnum       Destination struct
-  @param[in] overflow_ptr Whether or not whole-number overflow occurred.
-                          This indicates failure, and the result of sqlnum
-                          is undefined.
+  Retrieve a SQL_NUMERIC_STRUCT from a string in segments of 4 digits.
+  Only used for strings that are not plain decimal numbers, which
+  sqlnum_from_str() takes care of itself.
 */
-void sqlnum_from_str(const char *numstr, SQL_NUMERIC_STRUCT *sqlnum,
-                     int *overflow_ptr)
+static void sqlnum_from_str_segments(const char *numstr,
+                                     SQL_NUMERIC_STRUCT *sqlnum,
+                                     int *overflow_ptr)
 {
   /*
      We use 16 bits of each integer to convert the
@@ -2897,6 +3431,370 @@ end:
 }
 
 
+/*
+  Values of SQL_NUMERIC_STRUCT are handled as 128-bit unsigned integers:
+  the native type where the compiler has one, else two 64-bit halves
+  worked on in 32-bit limbs. Digits are converted in chunks of the largest
+  power of 10 that the arithmetic takes in one step.
+*/
+#ifdef __SIZEOF_INT128__
+typedef unsigned __int128 sqlnum_uint;
+# define SQLNUM_CHUNK_DIGITS 19
+#else
+typedef struct
+{
+  ulonglong lo, hi;
+} sqlnum_uint;
+# define SQLNUM_CHUNK_DIGITS 9
+#endif
+
+/* Longest plain decimal number converted without the segments */
+#define SQLNUM_MAX_STR 64
+
+static const ulonglong sqlnum_pow10[20]=
+{
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+  10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+  100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+  100000000000000000ULL, 1000000000000000000ULL,
+  10000000000000000000ULL
+};
+
+/* 2^128 - 1, the largest value of SQL_NUMERIC_STRUCT */
+static const char sqlnum_max_digits[]= "340282366920938463463374607431768211455";
+
+
+#ifdef __SIZEOF_INT128__
+
+# define sqlnum_set_zero(v) (*(v)= 0)
+# define sqlnum_is_zero(v) ((v) == 0)
+# define sqlnum_fits64(v) ((v) >> 64 == 0)
+# define sqlnum_low64(v) ((ulonglong)(v))
+
+/* v= v * mul + add, with mul at most 10^SQLNUM_CHUNK_DIGITS */
+static void sqlnum_mul_add(sqlnum_uint *v, ulonglong mul, ulonglong add)
+{
+  *v= *v * mul + add;
+}
+
+/* v= v * 10, TRUE if it does not fit */
+static my_bool sqlnum_mul10(sqlnum_uint *v)
+{
+  if (*v > ~(sqlnum_uint)0 / 10)
+  {
+    return TRUE;
+  }
+  *v*= 10;
+  return FALSE;
+}
+
+/* v= v / div, returning the remainder */
+static ulonglong sqlnum_div(sqlnum_uint *v, ulonglong div)
+{
+  sqlnum_uint q= *v / div;
+  ulonglong rem= (ulonglong)(*v - q * div);
+
+  *v= q;
+  return rem;
+}
+
+static void sqlnum_to_val(sqlnum_uint v, SQLCHAR *val)
+{
+  int i;
+
+  for (i= 0; i < SQL_MAX_NUMERIC_LEN; ++i, v>>= 8)
+  {
+    val[i]= (SQLCHAR)v;
+  }
+}
+
+static sqlnum_uint sqlnum_from_val(const SQLCHAR *val)
+{
+  sqlnum_uint v= 0;
+  int i;
+
+  for (i= SQL_MAX_NUMERIC_LEN; i--; )
+  {
+    v= v << 8 | val[i];
+  }
+  return v;
+}
+
+#else
+
+# define sqlnum_set_zero(v) ((v)->lo= (v)->hi= 0)
+# define sqlnum_is_zero(v) (!(v).lo && !(v).hi)
+# define sqlnum_fits64(v) ((v).hi == 0)
+# define sqlnum_low64(v) ((v).lo)
+
+/* Multiply and add in 32-bit limbs, returning what is carried out */
+static ulonglong sqlnum_mul_add_carry(sqlnum_uint *v, ulonglong mul,
+                                      ulonglong add)
+{
+  ulonglong limb[4], carry= add;
+  int i;
+
+  limb[0]= v->lo & 0xffffffff;
+  limb[1]= v->lo >> 32;
+  limb[2]= v->hi & 0xffffffff;
+  limb[3]= v->hi >> 32;
+
+  for (i= 0; i < 4; ++i)
+  {
+    ulonglong t= limb[i] * mul + carry;
+
+    limb[i]= t & 0xffffffff;
+    carry= t >> 32;
+  }
+
+  v->lo= limb[1] << 32 | limb[0];
+  v->hi= limb[3] << 32 | limb[2];
+  return carry;
+}
+
+/* v= v * mul + add, with mul at most 10^SQLNUM_CHUNK_DIGITS */
+static void sqlnum_mul_add(sqlnum_uint *v, ulonglong mul, ulonglong add)
+{
+  sqlnum_mul_add_carry(v, mul, add);
+}
+
+/* v= v * 10, TRUE if it does not fit */
+static my_bool sqlnum_mul10(sqlnum_uint *v)
+{
+  sqlnum_uint t= *v;
+
+  if (sqlnum_mul_add_carry(&t, 10, 0))
+  {
+    return TRUE;
+  }
+  *v= t;
+  return FALSE;
+}
+
+/* v= v / div, returning the remainder, with div below 2^32 */
+static ulonglong sqlnum_div(sqlnum_uint *v, ulonglong div)
+{
+  ulonglong limb[4], rem= 0;
+  int i;
+
+  limb[0]= v->lo & 0xffffffff;
+  limb[1]= v->lo >> 32;
+  limb[2]= v->hi & 0xffffffff;
+  limb[3]= v->hi >> 32;
+
+  for (i= 4; i--; )
+  {
+    ulonglong t= rem << 32 | limb[i];
+
+    limb[i]= t / div;
+    rem= t % div;
+  }
+
+  v->lo= limb[1] << 32 | limb[0];
+  v->hi= limb[3] << 32 | limb[2];
+  return rem;
+}
+
+static void sqlnum_to_val(sqlnum_uint v, SQLCHAR *val)
+{
+  int i;
+
+  for (i= 0; i < 8; ++i)
+  {
+    val[i]= (SQLCHAR)(v.lo >> (8 * i));
+    val[i + 8]= (SQLCHAR)(v.hi >> (8 * i));
+  }
+}
+
+static sqlnum_uint sqlnum_from_val(const SQLCHAR *val)
+{
+  sqlnum_uint v;
+  int i;
+
+  v.lo= v.hi= 0;
+  for (i= 8; i--; )
+  {
+    v.lo= v.lo << 8 | val[i];
+    v.hi= v.hi << 8 | val[i + 8];
+  }
+  return v;
+}
+
+#endif
+
+
+/**
+  Check if a string of digits, with leading zeros and maybe a decimal
+  point, is more than the largest value of SQL_NUMERIC_STRUCT.
+*/
+static my_bool sqlnum_digits_overflow(const char *digits, int count)
+{
+  int i;
+
+  while (count && *digits == '0')
+  {
+    ++digits;
+    --count;
+  }
+
+  if (count != sizeof(sqlnum_max_digits) - 1)
+  {
+    return count > (int)sizeof(sqlnum_max_digits) - 1;
+  }
+
+  for (i= 0; i < count; ++i)
+  {
+    if (digits[i] != sqlnum_max_digits[i])
+    {
+      return digits[i] > sqlnum_max_digits[i];
+    }
+  }
+
+  return FALSE;
+}
+
+
+/**
+  Retrieve a SQL_NUMERIC_STRUCT from a string. The requested scale
+  and precesion are first read from sqlnum, and then updated values
+  are written back at the end.
+
+  Plain decimal numbers are converted from their digits in chunks, with
+  the same results as the conversion in segments that any other string
+  goes through: decimals beyond the scale are truncated, a negative scale
+  takes only zeros off, and the precision is the number of digits kept
+  without the trailing zeros.
+
+  @param[in] numstr       String representation of number to convert
+  @param[in] sqlnum       Destination struct
+  @param[in] overflow_ptr Whether or not whole-number overflow occurred.
+                          This indicates failure, and the result of sqlnum
+                          is undefined.
+*/
+void sqlnum_from_str(const char *numstr, SQL_NUMERIC_STRUCT *sqlnum,
+                     int *overflow_ptr)
+{
+  char digits[SQLNUM_MAX_STR];
+  const char *pos= numstr + (*numstr == '-');
+  int count= 0, frac= -1, kept, zeros, chunk, i;
+  int overflow= 0;
+  SQLSCHAR reqscale= sqlnum->scale;
+  SQLCHAR reqprec= sqlnum->precision;
+  sqlnum_uint value;
+
+  for (; *pos; ++pos)
+  {
+    if (*pos >= '0' && *pos <= '9' && count < SQLNUM_MAX_STR)
+    {
+      digits[count++]= *pos;
+    }
+    else if (*pos == '.' && frac < 0)
+    {
+      frac= count;
+    }
+    else
+    {
+      sqlnum_from_str_segments(numstr, sqlnum, overflow_ptr);
+      return;
+    }
+  }
+
+  if (!count)
+  {
+    sqlnum_from_str_segments(numstr, sqlnum, overflow_ptr);
+    return;
+  }
+
+  memset(&sqlnum->val, 0, sizeof(sqlnum->val));
+  sqlnum->sign= *numstr != '-';
+  frac= frac < 0 ? 0 : count - frac;
+
+  /* All the digits have to fit, even those truncated below */
+  if (sqlnum_digits_overflow(digits, count))
+  {
+    overflow= 1;
+    goto end;
+  }
+
+  /* Digits kept for the requested scale */
+  kept= count;
+  if (reqscale < frac)
+  {
+    kept-= frac - myodbc_max(reqscale, 0);
+  }
+
+  if (reqscale < 0)
+  {
+    for (i= 0; i < -reqscale && i < kept; ++i)
+    {
+      if (digits[kept - 1 - i] != '0')
+      {
+        overflow= 1;
+        goto end;
+      }
+    }
+    kept-= i;
+  }
+
+  for (zeros= 0; zeros < kept && digits[kept - 1 - zeros] == '0'; ++zeros)
+  {
+  }
+
+  /* First chunk is the short one */
+  sqlnum_set_zero(&value);
+  for (i= 0; i < kept; i+= chunk)
+  {
+    ulonglong part= 0;
+    int j;
+
+    chunk= i ? SQLNUM_CHUNK_DIGITS : (kept - 1) % SQLNUM_CHUNK_DIGITS + 1;
+    for (j= i; j < i + chunk; ++j)
+    {
+      part= part * 10 + (digits[j] - '0');
+    }
+    sqlnum_mul_add(&value, sqlnum_pow10[chunk], part);
+  }
+
+  if (sqlnum_is_zero(value))
+  {
+    sqlnum->precision= 0;
+  }
+  else
+  {
+    /* Scale up to SQL_DESC_SCALE */
+    for (i= frac; i < reqscale; ++i, ++zeros)
+    {
+      if (sqlnum_mul10(&value))
+      {
+        overflow= 1;
+        goto end;
+      }
+    }
+
+    sqlnum->precision= kept > zeros ? kept - zeros : 0;
+  }
+
+  sqlnum->scale= reqscale;
+
+  /* detect precision overflow */
+  if (sqlnum->precision > reqprec)
+  {
+    overflow= 1;
+  }
+  else
+  {
+    sqlnum->precision= reqprec;
+  }
+
+  sqlnum_to_val(value, sqlnum->val);
+
+end:
+  if (overflow_ptr)
+    *overflow_ptr= overflow;
+}
+
+
 /**
   Convert a SQL_NUMERIC_STRUCT to a string. Only val and sign are
   read from the struct. precision and scale will be updated on the
@@ -2920,9 +3818,12 @@ void sqlnum_to_str(SQL_NUMERIC_STRUCT *sqlnum, SQLCHAR *numstr,
                    SQLCHAR **numbegin, SQLCHAR reqprec, SQLSCHAR reqscale,
                    int *truncptr)
 {
-  int expanded[8];
-  int i, j;
-  int max_space= 0;
+  /* digits of the value, the lowest first */
+  char digits[40];
+  sqlnum_uint value= sqlnum_from_val(sqlnum->val);
+  ulonglong low;
+  int count= 0;
+  int j;
   int calcprec= 0;
   int trunc= 0; /* truncation indicator */
 
@@ -2933,41 +3834,32 @@ void sqlnum_to_str(SQL_NUMERIC_STRUCT *sqlnum, SQLCHAR *numstr,
      (~at least min(39, max(prec, scale+2)) + 3)
   */
 
-  /*
-     expand the packed sqlnum->val so we have space to divide through
-     expansion happens into an array in big-endian form
-  */
-  for (i= 0; i < 8; ++i)
-    expanded[7 - i]= (sqlnum->val[(2 * i) + 1] << 8) | sqlnum->val[2 * i];
-
   /* max digits = 39 = log_10(2^128)+1 */
-  for (j= 0; j < 39; ++j)
+  while (!sqlnum_fits64(value))
   {
-    /* skip empty prefix */
-    while (!expanded[max_space])
-      ++max_space;
-    /* if only the last piece has a value, it's the end */
-    if (max_space >= 7)
-    {
-      i= 7;
-      if (!expanded[7])
-      {
-        /* special case for zero, we'll end immediately */
-        if (!*(numstr + 1))
-        {
-          *numstr--= '0';
-          calcprec= 1;
-        }
-        break;
-      }
-    }
-    else
+    ulonglong part= sqlnum_div(&value, sqlnum_pow10[SQLNUM_CHUNK_DIGITS]);
+
+    for (j= 0; j < SQLNUM_CHUNK_DIGITS; ++j, part/= 10)
     {
-      /* extract the next digit */
-      sqlnum_unscale_be(expanded, max_space);
+      digits[count++]= '0' + (char)(part % 10);
     }
-    *numstr--= '0' + (expanded[7] % 10);
-    expanded[7] /= 10;
+  }
+
+  for (low= sqlnum_low64(value); low; low/= 10)
+  {
+    digits[count++]= '0' + (char)(low % 10);
+  }
+
+  if (!count)
+  {
+    /* special case for zero */
+    *numstr--= '0';
+    calcprec= 1;
+  }
+
+  for (j= 0; j < count; ++j)
+  {
+    *numstr--= digits[j];
     ++calcprec;
     if (j == reqscale - 1)
       *numstr--= '.';
@@ -3902,7 +4794,18 @@ char *extend_buffer(NET *net, char *to, ulong length)
     need= (ulong)(to - (char *)net->buff) + length;
     if (!to || need > net->max_packet - 10)
     {
-        if (myodbc_net_realloc(net, need))
+        /*
+          Grow geometrically, so that a query built by many appends does not
+          reallocate and copy the buffer each time
+        */
+        size_t grow= myodbc_max((size_t)need + 10, (size_t)net->max_packet * 2);
+
+        if (grow >= net->max_packet_size)
+        {
+            grow= myodbc_max((size_t)need, (size_t)net->max_packet_size - 1);
+        }
+
+        if (myodbc_net_realloc(net, grow))
         {
             return 0;
         }
@@ -0,0 +1,286 @@
+/*
+  Copyright (c) 2018-Present MongoDB Inc.
+
+  The MySQL Connector/ODBC is licensed under the terms of the GPLv2
+  <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+  MySQL Connectors. There are special exceptions to the terms and
+  conditions of the GPLv2 as it is applied to this software, see the
+  FLOSS License Exception
+  <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+  or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+  for more details.
+
+  You should have received a copy of the GNU General Public License along
+  with this program; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file  workers.c
+  @brief Small fork-join thread pool owned by the environment handle.
+
+  The pool runs a batch of independent tasks and returns once all of them
+  are done. The calling thread takes part in the batch, so a pool that is
+  already busy with another statement simply degrades to running the
+  tasks inline.
+*/
+
+#include "driver.h"
+#include "../include/sys/thr_cond.h"
+
+struct st_myodbc_workers
+{
+  myodbc_mutex_t    lock;
+  native_cond_t     work_cond;  /* signalled when a new batch is posted */
+  native_cond_t     done_cond;  /* signalled when a batch is complete */
+
+  my_thread_handle *threads;
+  uint              thread_count;
+  my_bool           shutdown;
+  my_bool           busy;       /* a batch is being run */
+  ulong             generation; /* incremented for each batch */
+
+  /* current batch */
+  myodbc_task_func  func;
+  char             *tasks;
+  size_t            task_size;
+  uint              task_count;
+  uint              next_task;
+  uint              pending;
+};
+
+
+/**
+  Take tasks of the current batch until there is none left.
+
+  Must be called with the pool lock held, returns with it held.
+*/
+static void workers_drain(MYODBC_WORKERS *pool)
+{
+  while (pool->next_task < pool->task_count)
+  {
+    uint task= pool->next_task++;
+
+    myodbc_mutex_unlock(&pool->lock);
+    pool->func(pool->tasks + task * pool->task_size);
+    myodbc_mutex_lock(&pool->lock);
+
+    if (--pool->pending == 0)
+    {
+      native_cond_broadcast(&pool->done_cond);
+    }
+  }
+}
+
+
+static void *workers_thread(void *arg)
+{
+  MYODBC_WORKERS *pool= (MYODBC_WORKERS *)arg;
+  ulong seen= 0;
+
+  mysql_thread_init();
+
+  myodbc_mutex_lock(&pool->lock);
+  while (!pool->shutdown)
+  {
+    if (pool->generation == seen)
+    {
+      native_cond_wait(&pool->work_cond, &pool->lock);
+      continue;
+    }
+
+    seen= pool->generation;
+    workers_drain(pool);
+  }
+  myodbc_mutex_unlock(&pool->lock);
+
+  mysql_thread_end();
+  return NULL;
+}
+
+
+/**
+  Create a pool with the given number of threads.
+
+  @return The pool, or NULL if not even one thread could be started.
+*/
+MYODBC_WORKERS *workers_create(uint thread_count)
+{
+  MYODBC_WORKERS *pool;
+  my_thread_attr_t attr;
+  uint i;
+
+  if (!thread_count)
+  {
+    return NULL;
+  }
+
+  pool= (MYODBC_WORKERS *)myodbc_malloc(sizeof(MYODBC_WORKERS),
+                                        MYF(MY_ZEROFILL));
+  if (!pool)
+  {
+    return NULL;
+  }
+
+  pool->threads= (my_thread_handle *)myodbc_malloc(sizeof(my_thread_handle) *
+                                                   thread_count,
+                                                   MYF(MY_ZEROFILL));
+  if (!pool->threads)
+  {
+    x_free(pool);
+    return NULL;
+  }
+
+  myodbc_mutex_init(&pool->lock, NULL);
+  native_cond_init(&pool->work_cond);
+  native_cond_init(&pool->done_cond);
+
+  my_thread_attr_init(&attr);
+  my_thread_attr_setstacksize(&attr, DEFAULT_THREAD_STACK);
+  my_thread_attr_setdetachstate(&attr, MY_THREAD_CREATE_JOINABLE);
+
+  for (i= 0; i < thread_count; ++i)
+  {
+    if (my_thread_create(&pool->threads[i], &attr, workers_thread, pool))
+    {
+      break;
+    }
+  }
+  my_thread_attr_destroy(&attr);
+
+  pool->thread_count= i;
+
+  if (!pool->thread_count)
+  {
+    workers_destroy(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+
+/**
+  Stop all threads of the pool and free it.
+*/
+void workers_destroy(MYODBC_WORKERS *pool)
+{
+  uint i;
+
+  if (!pool)
+  {
+    return;
+  }
+
+  myodbc_mutex_lock(&pool->lock);
+  pool->shutdown= TRUE;
+  native_cond_broadcast(&pool->work_cond);
+  myodbc_mutex_unlock(&pool->lock);
+
+  for (i= 0; i < pool->thread_count; ++i)
+  {
+    my_thread_join(&pool->threads[i], NULL);
+  }
+
+  native_cond_destroy(&pool->work_cond);
+  native_cond_destroy(&pool->done_cond);
+  myodbc_mutex_destroy(&pool->lock);
+
+  x_free(pool->threads);
+  x_free(pool);
+}
+
+
+/**
+  Number of threads in the pool, not counting the calling thread.
+*/
+uint workers_count(MYODBC_WORKERS *pool)
+{
+  return pool ? pool->thread_count : 0;
+}
+
+
+/**
+  Run a batch of tasks and wait for all of them to complete.
+
+  @param[in]  pool        Pool to use (can be NULL)
+  @param[in]  func        Function called once for each task
+  @param[in]  tasks       Array of task_count elements of task_size bytes,
+                          each element is passed to func
+  @param[in]  task_size   Size of one element of tasks
+  @param[in]  task_count  Number of tasks
+
+  Tasks are run inline if there is no pool or if the pool is already
+  running a batch for another caller.
+*/
+void workers_run(MYODBC_WORKERS *pool, myodbc_task_func func, void *tasks,
+                 size_t task_size, uint task_count)
+{
+  uint i;
+
+  if (pool && task_count > 1)
+  {
+    myodbc_mutex_lock(&pool->lock);
+
+    if (!pool->busy)
+    {
+      pool->busy= TRUE;
+      pool->func= func;
+      pool->tasks= (char *)tasks;
+      pool->task_size= task_size;
+      pool->task_count= task_count;
+      pool->next_task= 0;
+      pool->pending= task_count;
+      ++pool->generation;
+      native_cond_broadcast(&pool->work_cond);
+
+      workers_drain(pool);
+
+      while (pool->pending)
+      {
+        native_cond_wait(&pool->done_cond, &pool->lock);
+      }
+
+      pool->busy= FALSE;
+      pool->func= NULL;
+      pool->tasks= NULL;
+      pool->task_count= 0;
+      myodbc_mutex_unlock(&pool->lock);
+      return;
+    }
+
+    myodbc_mutex_unlock(&pool->lock);
+  }
+
+  for (i= 0; i < task_count; ++i)
+  {
+    func((char *)tasks + i * task_size);
+  }
+}
+
+
+/**
+  Get the pool of the environment, creating it with the requested number
+  of threads on first use.
+*/
+MYODBC_WORKERS *env_get_workers(ENV *env, uint thread_count)
+{
+  MYODBC_WORKERS *pool;
+
+  myodbc_mutex_lock(&env->lock);
+  if (!env->workers && thread_count)
+  {
+    env->workers= workers_create(thread_count);
+  }
+  pool= env->workers;
+  myodbc_mutex_unlock(&env->lock);
+
+  return pool;
+}
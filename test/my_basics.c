@@ -23,6 +23,8 @@
 */
 
 #include "odbctap.h"
+#include "../driver/myodbc_hosts.h"
+#include "../driver/myodbc_latency.h"
 
 DECLARE_TEST(my_basics)
 {
@@ -350,6 +352,72 @@ DECLARE_TEST(charset_utf8)
 }
 
 
+/*
+  utf8 results read in a single-byte ANSI character set: whole values,
+  characters without mapping, values read in pieces, and a large value.
+  The conversion itself is measured by bench/conv_bench.c.
+*/
+DECLARE_TEST(charset_latin1_conversion)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLCHAR buff[101];
+  SQLCHAR big[40001];
+  SQLLEN len, total;
+  SQLRETURN rc;
+  int i;
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                        NULL, NULL, NULL, "CHARSET=latin1"));
+
+  /* MySQL's latin1 is cp1252, it has the euro sign but no omega */
+  ok_sql(hstmt1, "SELECT CONVERT(_latin1 0x73E36F207061756C6F USING utf8), "
+                 "CONVERT(0xE282AC USING utf8), "
+                 "CONVERT(0x41CEA942 USING utf8)");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "s\xE3o paulo", 10);
+  is_str(my_fetch_str(hstmt1, buff, 2), "\x80", 2);
+
+  expect_stmt(hstmt1, SQLGetData(hstmt1, 3, SQL_C_CHAR, buff, sizeof(buff),
+                                 &len), SQL_SUCCESS_WITH_INFO);
+  is(check_sqlstate(hstmt1, "22018") == OK);
+  is_str(buff, "A?B", 4);
+  is_num(len, 3);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* 4000 characters taking 6000 bytes in utf8, read 100 at a time */
+  ok_sql(hstmt1, "SELECT REPEAT(CONVERT(_latin1 0x61E7E36F USING utf8), 1000)");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+
+  total= 0;
+  while ((rc= SQLGetData(hstmt1, 1, SQL_C_CHAR, buff, sizeof(buff), &len))
+         != SQL_NO_DATA)
+  {
+    size_t got= strlen((char *)buff);
+
+    ok_stmt(hstmt1, rc);
+    if (total == 0)
+      is_num(len, 4000);
+    for (i= 0; i < (int)got; ++i)
+      is_num(buff[i], (SQLCHAR)"a\xE7\xE3o"[(total + i) % 4]);
+    total+= got;
+  }
+  is_num(total, 4000);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* Longer than the chunks the conversion goes by */
+  ok_sql(hstmt1, "SELECT REPEAT(CONVERT(_latin1 0x61E7E36F USING utf8), "
+                 "10000)");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  ok_stmt(hstmt1, SQLGetData(hstmt1, 1, SQL_C_CHAR, big, sizeof(big), &len));
+  is_num(len, 40000);
+  is_str(big + 39996, "a\xE7\xE3o", 5);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  return OK;
+}
+
+
 /**
  GBK is a fun character set -- it contains multibyte characters that can
  contain 0x5c ('\'). This causes escaping problems if the driver doesn't
@@ -1203,6 +1271,633 @@ DECLARE_TEST(t_ssl_mode)
   return OK;
 }
 
+/*
+  A list of servers: the first one cannot be reached, the connection
+  must fail over to the second one.
+*/
+DECLARE_TEST(t_server_list)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLCHAR opts[512];
+
+  if (myport)
+    sprintf((char *)opts, "SERVER=127.0.0.1:1,%s:%d;LOAD_BALANCE=failover",
+            (char *)myserver, myport);
+  else
+    sprintf((char *)opts, "SERVER=127.0.0.1:1,%s;LOAD_BALANCE=failover",
+            (char *)myserver);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                        NULL, NULL, NULL, opts));
+  ok_sql(hstmt1, "SELECT 1");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 1);
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  return OK;
+}
+
+/*
+  Connections through a DSN. Apart from the first one, they use the cached
+  data source attributes instead of reading odbc.ini again, and get the
+  same catalog. The time saved per lookup is measured by mdbodbc-bench-dsn
+  in bench/.
+*/
+DECLARE_TEST(t_connect_dsn_cache)
+{
+  SQLHDBC hdbc1;
+  SQLCHAR catalog[MAX_NAME_LEN + 1];
+  SQLINTEGER len;
+  int i;
+
+  for (i= 0; i < 5; ++i)
+  {
+    ok_env(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc1));
+    ok_con(hdbc1, SQLConnect(hdbc1, mydsn, SQL_NTS, myuid, SQL_NTS,
+                             mypwd, SQL_NTS));
+    ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_CURRENT_CATALOG, catalog,
+                                    sizeof(catalog), &len));
+    is_str(catalog, mydb, strlen((char *)mydb) + 1);
+    ok_con(hdbc1, SQLDisconnect(hdbc1));
+    ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+  }
+
+  return OK;
+}
+
+
+/*
+  Editing the data source in odbc.ini between connections drops the cached
+  attributes: the next connection uses the new database.
+*/
+DECLARE_TEST(t_connect_dsn_edit)
+{
+  SQLHDBC hdbc1;
+  SQLCHAR catalog[MAX_NAME_LEN + 1], olddb[MAX_NAME_LEN + 1];
+  SQLCHAR *newdb= (SQLCHAR *)"information_schema";
+  SQLINTEGER len;
+  int i;
+
+  if (!strcmp((char *)mydb, (char *)newdb))
+    newdb= (SQLCHAR *)"mysql";
+
+  SQLGetPrivateProfileString((char *)mydsn, "DATABASE", "", (char *)olddb,
+                             sizeof(olddb), "ODBC.INI");
+
+  /* The first connection fills the cache, the second one uses it */
+  for (i= 0; i < 2; ++i)
+  {
+    ok_env(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc1));
+    ok_con(hdbc1, SQLConnect(hdbc1, mydsn, SQL_NTS, myuid, SQL_NTS,
+                             mypwd, SQL_NTS));
+    ok_con(hdbc1, SQLDisconnect(hdbc1));
+    ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+  }
+
+  ok_install(SQLWritePrivateProfileString((char *)mydsn, "DATABASE",
+                                          (char *)newdb, "ODBC.INI"));
+
+  ok_env(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc1));
+  if (!SQL_SUCCEEDED(SQLConnect(hdbc1, mydsn, SQL_NTS, myuid, SQL_NTS,
+                                mypwd, SQL_NTS)))
+  {
+    SQLWritePrivateProfileString((char *)mydsn, "DATABASE", (char *)olddb,
+                                 "ODBC.INI");
+    return FAIL;
+  }
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_CURRENT_CATALOG, catalog,
+                                  sizeof(catalog), &len));
+  ok_con(hdbc1, SQLDisconnect(hdbc1));
+  ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+
+  /* Put the data source back before checking the result */
+  ok_install(SQLWritePrivateProfileString((char *)mydsn, "DATABASE",
+                                          (char *)olddb, "ODBC.INI"));
+
+  is_str(catalog, newdb, strlen((char *)newdb) + 1);
+
+  return OK;
+}
+
+
+/*
+  The session state set up at connect time in one request: the attributes
+  set before connecting end up in the session, along with the settings
+  the driver always makes.
+*/
+DECLARE_TEST(t_session_bootstrap)
+{
+  SQLHDBC hdbc1;
+  SQLHSTMT hstmt1;
+  SQLUINTEGER autocommit;
+  SQLCHAR isolation[20];
+
+  ok_env(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc1));
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_AUTOCOMMIT,
+                                  (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_TXN_ISOLATION,
+                                  (SQLPOINTER)SQL_TXN_READ_COMMITTED, 0));
+  ok_con(hdbc1, SQLConnect(hdbc1, mydsn, SQL_NTS, myuid, SQL_NTS,
+                           mypwd, SQL_NTS));
+
+  /* Without transactions the driver keeps autocommit on, with a warning */
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_AUTOCOMMIT, &autocommit,
+                                  0, NULL));
+
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt1));
+  ok_sql(hstmt1, "SELECT @@autocommit, @@sql_auto_is_null, "
+                 "@@character_set_results IS NULL");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), autocommit == SQL_AUTOCOMMIT_ON ? 1 : 0);
+  is_num(my_fetch_int(hstmt1, 2), 0);
+  is_num(my_fetch_int(hstmt1, 3), 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* The isolation set before connecting is part of the same bootstrap */
+  if (mysql_min_version(hdbc1, "5.7.20", 6))
+    ok_sql(hstmt1, "SELECT @@transaction_isolation");
+  else
+    ok_sql(hstmt1, "SELECT @@tx_isolation");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, isolation, 1), "READ-COMMITTED", 14);
+
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+  ok_con(hdbc1, SQLDisconnect(hdbc1));
+  ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+
+  return OK;
+}
+
+
+/*
+  Connections of the same environment to the same server resume the TLS
+  session of the previous one when the client library allows it.
+*/
+DECLARE_TEST(t_tls_session_resume)
+{
+  SQLHDBC hdbc1;
+  SQLHSTMT hstmt1;
+  SQLCHAR buf[256];
+  int i;
+
+#if MYSQL_VERSION_ID < 80029
+  skip("The client library cannot resume TLS sessions");
+#endif
+
+  for (i= 0; i < 5; ++i)
+  {
+    ok_env(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc1));
+    ok_con(hdbc1, get_connection(&hdbc1, NULL, NULL, NULL, NULL,
+                                 "SSLMODE=REQUIRED"));
+    ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt1));
+
+    ok_sql(hstmt1, "SHOW SESSION STATUS LIKE 'Ssl_sessions_reused'");
+    ok_stmt(hstmt1, SQLFetch(hstmt1));
+    ok_stmt(hstmt1, SQLGetData(hstmt1, 2, SQL_C_CHAR, buf, sizeof(buf),
+                               NULL));
+
+    /* The first connection may make the full handshake */
+    if (i > 0)
+      is_num(atoi((char *)buf), 1);
+
+    ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+    ok_con(hdbc1, SQLDisconnect(hdbc1));
+    ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+  }
+
+  return OK;
+}
+
+
+/* Bytes the server sent on the connection of a statement so far */
+static long long bytes_sent(SQLHSTMT hstmt)
+{
+  SQLCHAR buf[32];
+
+  if (!SQL_SUCCEEDED(SQLExecDirect(hstmt, (SQLCHAR *)
+                       "SHOW SESSION STATUS LIKE 'Bytes_sent'", SQL_NTS)) ||
+      !SQL_SUCCEEDED(SQLFetch(hstmt)) ||
+      !SQL_SUCCEEDED(SQLGetData(hstmt, 2, SQL_C_CHAR, buf, sizeof(buf),
+                                NULL)))
+  {
+    return -1;
+  }
+  SQLFreeStmt(hstmt, SQL_CLOSE);
+
+  return strtoll((char *)buf, NULL, 10);
+}
+
+
+/*
+  COMPRESSION_ALGORITHM and COMPRESSION_LEVEL: a wide result set reads the
+  same with each setting, and compressed takes fewer bytes from the server.
+  Lists of algorithms with an unknown or empty item are refused.
+*/
+DECLARE_TEST(t_compression)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  const char *options[]= {"COMPRESSION_ALGORITHM=uncompressed",
+                          "COMPRESSION_ALGORITHM=zlib",
+#if MYSQL_VERSION_ID >= 80018
+                          "COMPRESSION_ALGORITHM=zstd;COMPRESSION_LEVEL=3",
+                          "COMPRESSION_ALGORITHM=zstd;COMPRESSION_LEVEL=19",
+#endif
+                         };
+  long long sent[sizeof(options) / sizeof(options[0])];
+  SQLCHAR buf[2048];
+  SQLLEN len;
+  long long raw;
+  const char *invalid[]= {"COMPRESSION_ALGORITHM=lz4",
+                          "COMPRESSION_ALGORITHM=zlib,",
+                          "COMPRESSION_ALGORITHM=,zlib",
+                          "COMPRESSION_ALGORITHM=zlib,,uncompressed"};
+  int i, j;
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_compression");
+  ok_sql(hstmt, "CREATE TABLE t_compression (id INT, txt VARCHAR(2000))");
+  ok_sql(hstmt, "INSERT INTO t_compression "
+                "VALUES (1, REPEAT('wide result set ', 100))");
+  for (i= 0; i < 10; ++i)
+  {
+    ok_sql(hstmt, "INSERT INTO t_compression SELECT id + 1, txt "
+                  "FROM t_compression");
+  }
+
+  for (i= 0; i < (int)(sizeof(options) / sizeof(options[0])); ++i)
+  {
+    is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                          NULL, NULL, NULL, options[i]));
+    sent[i]= bytes_sent(hstmt1);
+    raw= 0;
+
+    ok_sql(hstmt1, "SELECT id, txt FROM t_compression");
+    for (j= 0; SQLFetch(hstmt1) == SQL_SUCCESS; ++j)
+    {
+      ok_stmt(hstmt1, SQLGetData(hstmt1, 2, SQL_C_CHAR, buf, sizeof(buf),
+                                 &len));
+      raw+= len;
+    }
+    is_num(j, 1024);
+    is(raw == 1024 * 1600);
+    ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    sent[i]= bytes_sent(hstmt1) - sent[i];
+
+    free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+    /* The repeated text compresses well with any algorithm */
+    if (i > 0)
+    {
+      is(sent[i] < sent[0]);
+    }
+  }
+
+  for (i= 0; i < (int)(sizeof(invalid) / sizeof(invalid[0])); ++i)
+  {
+    ok_env(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc1));
+    expect_dbc(hdbc1, get_connection(&hdbc1, NULL, NULL, NULL, NULL,
+                                     invalid[i]), SQL_ERROR);
+    ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+  }
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_compression");
+
+  return OK;
+}
+
+
+/*
+  STMT_POOL: dropped statements are reused with none of their state. The
+  cost of the allocation is measured by bench/stmt_bench.c.
+*/
+DECLARE_TEST(t_stmt_pool)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  const char *options[2]= {"STMT_POOL=0", "STMT_POOL=8"};
+  SQLHSTMT hstmt2;
+  SQLINTEGER value= 0;
+  SQLULEN max_rows= 1;
+  SQLSMALLINT columns;
+  int i, pass;
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "STMT_POOL=2"));
+
+  /* Leave some state on the statement before dropping it */
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_MAX_ROWS, (SQLPOINTER)1, 0));
+  ok_sql(hstmt1, "SELECT 1, 2");
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, &value, 0, NULL));
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+  ok_stmt(hstmt2, SQLGetStmtAttr(hstmt2, SQL_ATTR_MAX_ROWS, &max_rows, 0,
+                                 NULL));
+  is_num(max_rows, 0);
+  ok_stmt(hstmt2, SQLNumResultCols(hstmt2, &columns));
+  is_num(columns, 0);
+
+  ok_sql(hstmt2, "SELECT 3");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  /* The column bound on the dropped statement is not bound anymore */
+  is_num(value, 0);
+  is_num(my_fetch_int(hstmt2, 1), 3);
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+
+  /* hstmt1 is freed already */
+  hstmt1= NULL;
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  for (pass= 0; pass < 2; ++pass)
+  {
+    is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                          NULL, NULL, options[pass]));
+
+    /* More statements than the pool keeps */
+    for (i= 0; i < 20; ++i)
+    {
+      ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+      ok_sql(hstmt2, "SELECT 4");
+      ok_stmt(hstmt2, SQLFetch(hstmt2));
+      is_num(my_fetch_int(hstmt2, 1), 4);
+      ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+    }
+
+    free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  }
+
+  return OK;
+}
+
+
+/**
+  Latency histograms of the entry points, read through the connection and
+  written to the file of LATENCY_DUMP when the environment is freed.
+*/
+DECLARE_TEST(t_latency_stats)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLCHAR dump[8192], small[16];
+  SQLINTEGER len;
+  SQLUINTEGER on= 0;
+  FILE *file;
+  int i;
+
+  remove("t_latency.json");
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL,
+                                        "LATENCY_STATS=1;"
+                                        "LATENCY_DUMP=t_latency.json"));
+
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_STATS, &on,
+                                  0, NULL));
+  is_num(on, MYODBC_LATENCY_ON);
+
+  for (i= 0; i < 10; ++i)
+  {
+    ok_sql(hstmt1, "SELECT 1");
+    ok_stmt(hstmt1, SQLFetch(hstmt1));
+    is_num(my_fetch_int(hstmt1, 1), 1);
+    ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  }
+
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_JSON, dump,
+                                  sizeof(dump), &len));
+  is_num(len, strlen((char *)dump));
+  is(strncmp((char *)dump, "{\"unit\":\"ns\",", 14) == 0);
+  is(strstr((char *)dump, "\"SQLDriverConnect\":{\"count\":1,") != NULL);
+  is(strstr((char *)dump, "\"SQLExecDirect\":{\"count\":10,") != NULL);
+  is(strstr((char *)dump, "\"SQLFetch\":{\"count\":10,") != NULL);
+  is(strstr((char *)dump, "\"SQLGetData\":{\"count\":10,") != NULL);
+
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_TEXT, dump,
+                                  sizeof(dump), &len));
+  is(strncmp((char *)dump, "function ", 9) == 0);
+  is(strstr((char *)dump, "\nSQLFetch ") != NULL);
+
+  /* A buffer too small gets the start of the dump */
+  expect_dbc(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_TEXT,
+                                      small, sizeof(small), &len),
+             SQL_SUCCESS_WITH_INFO);
+  is(len > (SQLINTEGER)sizeof(small));
+  is_num(strlen((char *)small), sizeof(small) - 1);
+
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_STATS,
+                                  (SQLPOINTER)MYODBC_LATENCY_RESET, 0));
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_JSON, dump,
+                                  sizeof(dump), &len));
+  is_str(dump, "{\"unit\":\"ns\",\"functions\":{}}\n", len);
+
+  /* Nothing is recorded while the statistics are off */
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_STATS,
+                                  (SQLPOINTER)MYODBC_LATENCY_OFF, 0));
+  ok_sql(hstmt1, "SELECT 1");
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_STATS,
+                                  (SQLPOINTER)MYODBC_LATENCY_ON, 0));
+  ok_sql(hstmt1, "SELECT 1");
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_MYODBC_LATENCY_JSON, dump,
+                                  sizeof(dump), &len));
+  is(strstr((char *)dump, "\"SQLExecDirect\":{\"count\":1,") != NULL);
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  /* The driver manager may keep the environment of the driver around */
+  if ((file= fopen("t_latency.json", "r")))
+  {
+    len= (SQLINTEGER)fread(dump, 1, sizeof(dump) - 1, file);
+    dump[len]= '\0';
+    fclose(file);
+    remove("t_latency.json");
+    is(strstr((char *)dump, "\"SQLExecDirect\":{\"count\":1,") != NULL);
+  }
+
+  return OK;
+}
+
+
+/*
+  Connect through a list of servers made of unreachable hosts, optionally
+  followed by the test server, and run a query on the connection.
+*/
+static int server_list_connect(SQLHENV henv1, const char *strategy,
+                               int dead, int live)
+{
+  SQLHDBC   hdbc1;
+  SQLHSTMT  hstmt1;
+  SQLCHAR   opts[1024], *pos;
+  SQLRETURN rc;
+  int       i;
+
+  pos= opts + sprintf((char *)opts, "LOAD_BALANCE=%s;HOST_BACKOFF=60;"
+                                    "SERVER=", strategy);
+  for (i= 1; i <= dead; ++i)
+  {
+    pos+= sprintf((char *)pos, "%s127.0.0.1:%d", i > 1 ? "," : "", i);
+  }
+  if (live && myport)
+  {
+    sprintf((char *)pos, "%s%s:%d", dead ? "," : "", (char *)myserver,
+            myport);
+  }
+  else if (live)
+  {
+    sprintf((char *)pos, "%s%s", dead ? "," : "", (char *)myserver);
+  }
+
+  ok_env(henv1, SQLAllocHandle(SQL_HANDLE_DBC, henv1, &hdbc1));
+  rc= get_connection(&hdbc1, NULL, NULL, NULL, NULL, opts);
+
+  if (SQL_SUCCEEDED(rc))
+  {
+    ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt1));
+    ok_sql(hstmt1, "SELECT 1");
+    ok_stmt(hstmt1, SQLFetch(hstmt1));
+    is_num(my_fetch_int(hstmt1, 1), 1);
+    ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+    ok_con(hdbc1, SQLDisconnect(hdbc1));
+  }
+
+  ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+  return SQL_SUCCEEDED(rc) ? OK : FAIL;
+}
+
+
+/*
+  Every strategy reaches the live server whatever the position the
+  unreachable hosts get. The environment keeps the statistics of more
+  hosts than it first allocates.
+*/
+DECLARE_TEST(t_server_list_strategies)
+{
+  const char *strategies[]= {"round_robin", "random", "latency"};
+  SQLHENV henv1;
+  int i, j;
+
+  for (i= 0; i < 3; ++i)
+  {
+    ok_env(henv1, SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &henv1));
+    ok_env(henv1, SQLSetEnvAttr(henv1, SQL_ATTR_ODBC_VERSION,
+                                (SQLPOINTER)SQL_OV_ODBC3, 0));
+
+    /* Enough connections for the rotation to start with each host */
+    for (j= 0; j < 12; ++j)
+    {
+      is(server_list_connect(henv1, strategies[i], 11, 1) == OK);
+    }
+
+    ok_env(henv1, SQLFreeHandle(SQL_HANDLE_ENV, henv1));
+  }
+
+  return OK;
+}
+
+
+/*
+  Find the line of a host in the table of SQL_ATTR_MYODBC_HOSTS_TEXT.
+*/
+static int hosts_line(const char *table, const char *name, uint *failures,
+                      long *backoff, double *rtt)
+{
+  char host[256];
+  const char *line;
+
+  for (line= strchr(table, '\n'); line; line= strchr(line + 1, '\n'))
+  {
+    if (sscanf(line + 1, "%255s %u %ld %lf", host, failures, backoff,
+               rtt) == 4 && !strcmp(host, name))
+    {
+      return OK;
+    }
+  }
+
+  return FAIL;
+}
+
+
+/*
+  Hosts in their backoff are tried after the others, and still tried when
+  no other host is left. The host statistics of the environment show it:
+  the failures of the unreachable hosts do not grow once the live server
+  comes first.
+*/
+DECLARE_TEST(t_server_list_backoff)
+{
+  SQLHENV henv1;
+  SQLHDBC hdbc1;
+  SQLCHAR opts[512], table[4096];
+  SQLINTEGER len;
+  uint failures, healthy= 0;
+  long backoff;
+  double rtt;
+  const char *line;
+
+  ok_env(henv1, SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &henv1));
+  ok_env(henv1, SQLSetEnvAttr(henv1, SQL_ATTR_ODBC_VERSION,
+                              (SQLPOINTER)SQL_OV_ODBC3, 0));
+
+  /* Both hosts fail and go into their backoff */
+  is(server_list_connect(henv1, "failover", 2, 0) == FAIL);
+
+  /* They are attempted again rather than skipped */
+  is(server_list_connect(henv1, "failover", 2, 0) == FAIL);
+
+  /* The live server, healthy, comes before them although listed last */
+  if (myport)
+    sprintf((char *)opts, "LOAD_BALANCE=failover;HOST_BACKOFF=60;"
+            "SERVER=127.0.0.1:1,127.0.0.1:2,%s:%d", (char *)myserver,
+            myport);
+  else
+    sprintf((char *)opts, "LOAD_BALANCE=failover;HOST_BACKOFF=60;"
+            "SERVER=127.0.0.1:1,127.0.0.1:2,%s", (char *)myserver);
+
+  ok_env(henv1, SQLAllocHandle(SQL_HANDLE_DBC, henv1, &hdbc1));
+  ok_con(hdbc1, get_connection(&hdbc1, NULL, NULL, NULL, NULL, opts));
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_MYODBC_HOSTS_TEXT, table,
+                                  sizeof(table), &len));
+  ok_con(hdbc1, SQLDisconnect(hdbc1));
+  ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+
+  is_num(len, strlen((char *)table));
+  is(strncmp((char *)table, "host ", 5) == 0);
+
+  /* Two failures each, the second one doubling the backoff */
+  is(hosts_line((char *)table, "127.0.0.1:1", &failures, &backoff,
+                &rtt) == OK);
+  is_num(failures, 2);
+  is(backoff > 60 && backoff <= 120);
+  is(hosts_line((char *)table, "127.0.0.1:2", &failures, &backoff,
+                &rtt) == OK);
+  is_num(failures, 2);
+  is(backoff > 60 && backoff <= 120);
+
+  /* The live server has a connect time and nothing else is healthy */
+  for (line= strchr((char *)table, '\n'); line && line[1];
+       line= strchr(line + 1, '\n'))
+  {
+    char host[256];
+
+    is(sscanf(line + 1, "%255s %u %ld %lf", host, &failures, &backoff,
+              &rtt) == 4);
+    if (!failures)
+    {
+      is(rtt > 0);
+      is_num(backoff, 0);
+      ++healthy;
+    }
+  }
+  is_num(healthy, 1);
+
+  is(server_list_connect(henv1, "latency", 2, 1) == OK);
+
+  ok_env(henv1, SQLFreeHandle(SQL_HANDLE_ENV, henv1));
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_tls_opts)
   ADD_TEST(t_ssl_mode)
@@ -1215,6 +1910,7 @@ BEGIN_TESTS
   // ADD_TEST(t_bug19823) TODO: Fix
 #endif
   ADD_TEST(charset_utf8)
+  ADD_TEST(charset_latin1_conversion)
   // ADD_TEST(charset_gbk) TODO: Fix
   ADD_TEST(t_bug7445)
   ADD_TEST(t_bug30774)
@@ -1237,6 +1933,16 @@ BEGIN_TESTS
   ADD_TEST(t_bug45378)
   ADD_TEST(t_bug63844)
   ADD_TEST(t_bug52996)
+  ADD_TEST(t_server_list)
+  ADD_TEST(t_server_list_strategies)
+  ADD_TEST(t_server_list_backoff)
+  ADD_TEST(t_connect_dsn_cache)
+  ADD_TEST(t_connect_dsn_edit)
+  ADD_TEST(t_session_bootstrap)
+  ADD_TEST(t_tls_session_resume)
+  ADD_TEST(t_compression)
+  ADD_TEST(t_stmt_pool)
+  ADD_TEST(t_latency_stats)
   END_TESTS
 
 
@@ -836,6 +836,57 @@ DECLARE_TEST(t_bug_11746572)
 }
 
 
+/*
+  A large text value read by small pieces as SQL_C_WCHAR and SQL_C_CHAR:
+  each call returns the next full buffer, and the pieces add up to the
+  length reported by the first call. Its speed is measured by the chunk
+  cells of bench/conv_bench.c.
+*/
+DECLARE_TEST(t_getdata_chunks)
+{
+  SQLSMALLINT types[2]= {SQL_C_WCHAR, SQL_C_CHAR};
+  SQLWCHAR buf[2048];
+  SQLLEN len, total, expected, unit;
+  SQLRETURN rc;
+  int i, calls;
+
+  for (i= 0; i < 2; ++i)
+  {
+    unit= types[i] == SQL_C_WCHAR ? sizeof(SQLWCHAR) : 1;
+
+    /* 2 million characters, 3 MB in utf8 */
+    ok_sql(hstmt, "SELECT REPEAT(CONVERT(_latin1 0x61E7 USING utf8), "
+                  "1000000)");
+    ok_stmt(hstmt, SQLFetch(hstmt));
+
+    total= 0;
+    expected= -1;
+    calls= 0;
+    while ((rc= SQLGetData(hstmt, 1, types[i], buf, sizeof(buf), &len))
+           != SQL_NO_DATA)
+    {
+      ok_stmt(hstmt, rc);
+      if (expected < 0)
+        expected= len;
+      /* Each piece is the buffer without its terminating NUL */
+      total+= len < (SQLLEN)sizeof(buf) - unit ? len
+                                                : (SQLLEN)sizeof(buf) - unit;
+      ++calls;
+    }
+
+    if (types[i] == SQL_C_WCHAR)
+      is_num(expected, 2000000 * sizeof(SQLWCHAR));
+    is_num(total, expected);
+    is_num(calls, (expected + sizeof(buf) - unit - 1) /
+                  ((SQLLEN)sizeof(buf) - unit));
+
+    ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  }
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_blob)
   ADD_TEST(t_1piecewrite2)
@@ -849,6 +900,7 @@ BEGIN_TESTS
   ADD_TEST(t_bug9781)
   ADD_TEST(t_bug10562)
   ADD_TEST(t_bug_11746572)
+  ADD_TEST(t_getdata_chunks)
 END_TESTS
 
 
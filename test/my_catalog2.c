@@ -1261,6 +1261,188 @@ DECLARE_TEST(t_bug_14005343)
 }
 
 
+/*
+  Collect the whole result of a catalog function as a string, to compare
+  the results of the batched and of the per table catalog queries.
+*/
+static int catalog_result_str(SQLHSTMT hstmt, char *out, size_t out_size)
+{
+  SQLSMALLINT cols, i;
+  size_t used= 0;
+
+  out[0]= '\0';
+  ok_stmt(hstmt, SQLNumResultCols(hstmt, &cols));
+
+  while (SQLFetch(hstmt) == SQL_SUCCESS)
+  {
+    for (i= 1; i <= cols; ++i)
+    {
+      SQLCHAR buff[256];
+      SQLLEN len;
+
+      ok_stmt(hstmt, SQLGetData(hstmt, i, SQL_C_CHAR, buff, sizeof(buff),
+                                &len));
+      used+= snprintf(out + used, out_size - used, "%s|",
+                      len == SQL_NULL_DATA ? "(null)" : (char *)buff);
+      is(used < out_size);
+    }
+    out[used++]= '\n';
+    out[used]= '\0';
+  }
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  return OK;
+}
+
+
+/*
+  CATALOG_BATCH: the columns of several tables, and the tables of several
+  catalogs, are fetched in one round trip with the same result as one
+  query per table or catalog.
+*/
+DECLARE_TEST(t_catalog_batch)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  static char expected[16384], batched[16384];
+  char query[256];
+  int i;
+
+  for (i= 0; i < 5; ++i)
+  {
+    sprintf(query, "DROP TABLE IF EXISTS t_catalog_batch%d", i);
+    ok_stmt(hstmt, SQLExecDirect(hstmt, (SQLCHAR *)query, SQL_NTS));
+    sprintf(query, "CREATE TABLE t_catalog_batch%d (id INT NOT NULL PRIMARY "
+                   "KEY, name VARCHAR(%d) DEFAULT 'none', "
+                   "ts TIMESTAMP DEFAULT CURRENT_TIMESTAMP, amount "
+                   "DECIMAL(10,2) DEFAULT 1.5)", i, 10 + i);
+    ok_stmt(hstmt, SQLExecDirect(hstmt, (SQLCHAR *)query, SQL_NTS));
+  }
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_I_S=1"));
+  ok_stmt(hstmt1, SQLColumns(hstmt1, mydb, SQL_NTS, NULL, 0,
+                             (SQLCHAR *)"t_catalog_batch%", SQL_NTS,
+                             NULL, 0));
+  is(OK == catalog_result_str(hstmt1, expected, sizeof(expected)));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_I_S=1;CATALOG_BATCH=2"));
+  ok_stmt(hstmt1, SQLColumns(hstmt1, mydb, SQL_NTS, NULL, 0,
+                             (SQLCHAR *)"t_catalog_batch%", SQL_NTS,
+                             NULL, 0));
+  is(OK == catalog_result_str(hstmt1, batched, sizeof(batched)));
+  is_str(batched, expected, strlen(expected) + 1);
+
+  /* With a column pattern */
+  ok_stmt(hstmt1, SQLColumns(hstmt1, mydb, SQL_NTS, NULL, 0,
+                             (SQLCHAR *)"t_catalog_batch%", SQL_NTS,
+                             (SQLCHAR *)"%a%", SQL_NTS));
+  is_num(myrowcount(hstmt1), 10);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  /* All the catalogs */
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_I_S=1"));
+  ok_stmt(hstmt1, SQLTables(hstmt1, (SQLCHAR *)SQL_ALL_CATALOGS, 1, NULL, 0,
+                            (SQLCHAR *)"t_catalog_batch%", SQL_NTS,
+                            (SQLCHAR *)"TABLE", SQL_NTS));
+  is(OK == catalog_result_str(hstmt1, expected, sizeof(expected)));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_I_S=1;CATALOG_BATCH=2"));
+  ok_stmt(hstmt1, SQLTables(hstmt1, (SQLCHAR *)SQL_ALL_CATALOGS, 1, NULL, 0,
+                            (SQLCHAR *)"t_catalog_batch%", SQL_NTS,
+                            (SQLCHAR *)"TABLE", SQL_NTS));
+  is(OK == catalog_result_str(hstmt1, batched, sizeof(batched)));
+  is_str(batched, expected, strlen(expected) + 1);
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  for (i= 0; i < 5; ++i)
+  {
+    sprintf(query, "DROP TABLE IF EXISTS t_catalog_batch%d", i);
+    ok_stmt(hstmt, SQLExecDirect(hstmt, (SQLCHAR *)query, SQL_NTS));
+  }
+
+  return OK;
+}
+
+
+/*
+  CATALOG_THREADS: the per table queries of SQLColumns and SQLForeignKeys
+  are run on auxiliary connections, with the same result as on the
+  connection of the application.
+*/
+DECLARE_TEST(t_catalog_fanout)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  static char expected[16384], fanned_out[16384];
+  char query[256];
+  int i;
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_catalog_fanout1, t_catalog_fanout2, "
+                "t_catalog_fanout3, t_catalog_fanout4, t_catalog_fanout0");
+  ok_sql(hstmt, "CREATE TABLE t_catalog_fanout0 (id INT NOT NULL PRIMARY KEY, "
+                "name VARCHAR(20) DEFAULT 'none') ENGINE=InnoDB");
+  for (i= 1; i < 5; ++i)
+  {
+    sprintf(query, "CREATE TABLE t_catalog_fanout%d (id INT NOT NULL PRIMARY "
+                   "KEY, parent INT, amount DECIMAL(10,%d), FOREIGN KEY "
+                   "(parent) REFERENCES t_catalog_fanout0 (id) ON DELETE "
+                   "CASCADE) ENGINE=InnoDB", i, i);
+    ok_stmt(hstmt, SQLExecDirect(hstmt, (SQLCHAR *)query, SQL_NTS));
+  }
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_I_S=1"));
+  ok_stmt(hstmt1, SQLColumns(hstmt1, mydb, SQL_NTS, NULL, 0,
+                             (SQLCHAR *)"t_catalog_fanout%", SQL_NTS,
+                             NULL, 0));
+  is(OK == catalog_result_str(hstmt1, expected, sizeof(expected)));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL,
+                                        "NO_I_S=1;CATALOG_THREADS=3"));
+  ok_stmt(hstmt1, SQLColumns(hstmt1, mydb, SQL_NTS, NULL, 0,
+                             (SQLCHAR *)"t_catalog_fanout%", SQL_NTS,
+                             NULL, 0));
+  is(OK == catalog_result_str(hstmt1, fanned_out, sizeof(fanned_out)));
+  is_str(fanned_out, expected, strlen(expected) + 1);
+
+  /* The current catalog is used when none is given */
+  ok_stmt(hstmt1, SQLColumns(hstmt1, NULL, 0, NULL, 0,
+                             (SQLCHAR *)"t_catalog_fanout%", SQL_NTS,
+                             (SQLCHAR *)"amount", SQL_NTS));
+  is_num(myrowcount(hstmt1), 4);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* Foreign keys referencing a table, found in all the tables */
+  ok_stmt(hstmt1, SQLForeignKeys(hstmt1, NULL, 0, NULL, 0,
+                                 (SQLCHAR *)"t_catalog_fanout0", SQL_NTS,
+                                 NULL, 0, NULL, 0, NULL, 0));
+  is(OK == catalog_result_str(hstmt1, fanned_out, sizeof(fanned_out)));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_I_S=1"));
+  ok_stmt(hstmt1, SQLForeignKeys(hstmt1, NULL, 0, NULL, 0,
+                                 (SQLCHAR *)"t_catalog_fanout0", SQL_NTS,
+                                 NULL, 0, NULL, 0, NULL, 0));
+  is(OK == catalog_result_str(hstmt1, expected, sizeof(expected)));
+  is_str(fanned_out, expected, strlen(expected) + 1);
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE t_catalog_fanout1, t_catalog_fanout2, "
+                "t_catalog_fanout3, t_catalog_fanout4, t_catalog_fanout0");
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_bug_14005343)
   ADD_TEST(t_bug69554)
@@ -1280,6 +1462,8 @@ BEGIN_TESTS
   ADD_TEST(t_bug14085211_part1)
   // ADD_TODO(t_bug14085211_part2) TODO: Fix
   ADD_TEST(t_sqlcolumns_after_select)
+  ADD_TEST(t_catalog_batch)
+  ADD_TEST(t_catalog_fanout)
   // ADD_TEST(t_bug14555713) TODO: Fix
   // ADD_TODO(t_bug69448) TODO: Fix
 END_TESTS
@@ -1412,6 +1412,119 @@ DECLARE_TEST(t_date_overflow)
 }
 
 
+/**
+  Date/time strings in the canonical layout and in other layouts must
+  convert to the same values.
+*/
+DECLARE_TEST(t_datetime_layouts)
+{
+  SQL_TIMESTAMP_STRUCT ts;
+  SQL_DATE_STRUCT      d;
+  SQL_TIME_STRUCT      t;
+  SQLLEN               len;
+
+  ok_sql(hstmt, "SELECT '2018-03-04 05:06:07.123456', '20180304050607', "
+                "'2018-03-04', '18/3/4', '05:06:07', '5:6:7', "
+                "'2018-03-04 05:06:07.5'");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 1, SQL_C_TIMESTAMP, &ts, sizeof(ts), NULL));
+  is_num(ts.year, 2018);
+  is_num(ts.month, 3);
+  is_num(ts.day, 4);
+  is_num(ts.hour, 5);
+  is_num(ts.minute, 6);
+  is_num(ts.second, 7);
+  is_num(ts.fraction, 123456000);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 2, SQL_C_TIMESTAMP, &ts, sizeof(ts), NULL));
+  is_num(ts.year, 2018);
+  is_num(ts.month, 3);
+  is_num(ts.day, 4);
+  is_num(ts.hour, 5);
+  is_num(ts.minute, 6);
+  is_num(ts.second, 7);
+  is_num(ts.fraction, 0);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 3, SQL_C_DATE, &d, sizeof(d), NULL));
+  is_num(d.year, 2018);
+  is_num(d.month, 3);
+  is_num(d.day, 4);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 4, SQL_C_DATE, &d, sizeof(d), NULL));
+  is_num(d.year, 18);
+  is_num(d.month, 3);
+  is_num(d.day, 4);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 5, SQL_C_TIME, &t, sizeof(t), NULL));
+  is_num(t.hour, 5);
+  is_num(t.minute, 6);
+  is_num(t.second, 7);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 6, SQL_C_TIME, &t, sizeof(t), NULL));
+  is_num(t.hour, 5);
+  is_num(t.minute, 6);
+  is_num(t.second, 7);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 7, SQL_C_TIMESTAMP, &ts, sizeof(ts), NULL));
+  is_num(ts.second, 7);
+  is_num(ts.fraction, 500000000);
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* Columns of a prepared statement are converted from their MYSQL_TIME */
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_datetime_layouts");
+  ok_sql(hstmt, "CREATE TABLE t_datetime_layouts (id INT, "
+                "d DATE DEFAULT '0000-00-00', "
+                "dt DATETIME(6) DEFAULT '0000-00-00 00:00:00')");
+  ok_sql(hstmt, "INSERT INTO t_datetime_layouts VALUES "
+                "(1, '2018-03-04', '2018-03-04 05:06:07.5')");
+  ok_sql(hstmt, "INSERT INTO t_datetime_layouts (id) VALUES (2)");
+
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)"SELECT d, dt "
+                            "FROM t_datetime_layouts ORDER BY id", SQL_NTS));
+  ok_stmt(hstmt, SQLExecute(hstmt));
+
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  ok_stmt(hstmt, SQLGetData(hstmt, 1, SQL_C_DATE, &d, sizeof(d), &len));
+  is_num(len, sizeof(d));
+  is_num(d.year, 2018);
+  is_num(d.month, 3);
+  is_num(d.day, 4);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 2, SQL_C_DATE, &d, sizeof(d), &len));
+  is_num(d.day, 4);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 2, SQL_C_TIMESTAMP, &ts, sizeof(ts),
+                            &len));
+  is_num(ts.hour, 5);
+  is_num(ts.second, 7);
+  is_num(ts.fraction, 500000000);
+
+  /* A zero date is NULL and leaves the buffer as it was */
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  d.year= 1999;
+  d.month= 1;
+  d.day= 2;
+  ok_stmt(hstmt, SQLGetData(hstmt, 1, SQL_C_DATE, &d, sizeof(d), &len));
+  is_num(len, SQL_NULL_DATA);
+  is_num(d.year, 1999);
+  is_num(d.month, 1);
+  is_num(d.day, 2);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 2, SQL_C_DATE, &d, sizeof(d), &len));
+  is_num(len, SQL_NULL_DATA);
+  is_num(d.year, 1999);
+
+  expect_stmt(hstmt, SQLFetch(hstmt), SQL_NO_DATA);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_datetime_layouts");
+
+  return OK;
+}
+
+
 
 BEGIN_TESTS
   ADD_TEST(t_date_overflow)
@@ -1437,6 +1550,7 @@ BEGIN_TESTS
   // ADD_TEST(t_bug60646) TODO: Fix
   ADD_TEST(t_bug60648)
   ADD_TEST(t_b13975271)
+  ADD_TEST(t_datetime_layouts)
 END_TESTS
 
 
@@ -646,6 +646,59 @@ DECLARE_TEST(t_bug18641633)
 }
 
 
+/*
+  Bindings changed through the descriptors between fetches and between
+  executions are used by the next fetch or execution.
+*/
+DECLARE_TEST(t_desc_rebind)
+{
+  SQLHANDLE ard, apd;
+  SQLINTEGER a= 0, b= 0, param1= 1, param2= 2;
+  SQLLEN a_len= 0;
+
+  ok_stmt(hstmt, SQLGetStmtAttr(hstmt, SQL_ATTR_APP_ROW_DESC,
+                                &ard, SQL_IS_POINTER, NULL));
+  ok_stmt(hstmt, SQLGetStmtAttr(hstmt, SQL_ATTR_APP_PARAM_DESC,
+                                &apd, SQL_IS_POINTER, NULL));
+
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)
+                            "SELECT ? UNION ALL SELECT ? + 10", SQL_NTS));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                  SQL_INTEGER, 0, 0, &param1, 0, NULL));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_LONG,
+                                  SQL_INTEGER, 0, 0, &param1, 0, NULL));
+  ok_stmt(hstmt, SQLExecute(hstmt));
+
+  ok_stmt(hstmt, SQLBindCol(hstmt, 1, SQL_C_LONG, &a, 0, &a_len));
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  is_num(a, 1);
+  is_num(a_len, sizeof(SQLINTEGER));
+
+  /* Move the column to another buffer */
+  ok_desc(ard, SQLSetDescField(ard, 1, SQL_DESC_DATA_PTR, &b, SQL_IS_POINTER));
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  is_num(a, 1);
+  is_num(b, 11);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* Move the second parameter to another buffer */
+  ok_desc(apd, SQLSetDescField(apd, 2, SQL_DESC_DATA_PTR, &param2,
+                               SQL_IS_POINTER));
+  ok_stmt(hstmt, SQLExecute(hstmt));
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  is_num(b, 1);
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  is_num(b, 12);
+  expect_stmt(hstmt, SQLFetch(hstmt), SQL_NO_DATA);
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_UNBIND));
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+
+  return OK;
+}
+
+
 DECLARE_TEST(dummy_test)
 {
   return OK;
@@ -668,6 +721,7 @@ BEGIN_TESTS
   ADD_TEST(t_bug18641633)
   ADD_TEST(t_bug18636600)
   // ADD_TODO(t_desc_curcatalog) TODO: Fix
+  ADD_TEST(t_desc_rebind)
   ADD_TEST(dummy_test)
 END_TESTS
 
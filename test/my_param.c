@@ -1699,6 +1699,61 @@ DECLARE_TEST(t_inoutstream17842966)
 
 #endif /* #ifndef USE_IODBC */
 
+/*
+  Client side escaping of parameter values: runs of plain bytes with the
+  escaped bytes anywhere in 8 byte words, and at the ends of the value.
+*/
+DECLARE_TEST(t_param_escape)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  const char *values[]= {"'", "a\\", "\"starts and ends with quotes\"",
+                         "plain text long enough to span several words",
+                         "0123456'89abcdef\\0123456789\n\rabc\032def%_",
+                         "12345678'", "1234567\\",
+                         "caf\xc3\xa9 \xc3\xa0 l'h\xc3\xb4tel"};
+  char value[64], hex[130], expected[130];
+  SQLLEN len;
+  unsigned int i, j;
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_SSPS=1"));
+
+  ok_stmt(hstmt1, SQLPrepare(hstmt1, (SQLCHAR *)"SELECT HEX(?)", SQL_NTS));
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_CHAR,
+                                   SQL_VARCHAR, sizeof(value), 0, value,
+                                   sizeof(value), &len));
+
+  for (i= 0; i <= sizeof(values) / sizeof(values[0]); ++i)
+  {
+    /* The last value has a zero byte in the middle */
+    if (i < sizeof(values) / sizeof(values[0]))
+    {
+      strcpy(value, values[i]);
+      len= strlen(value);
+    }
+    else
+    {
+      memcpy(value, "zero byte \0 in the middle", 26);
+      len= 26;
+    }
+
+    for (j= 0; j < (unsigned int)len; ++j)
+    {
+      sprintf(expected + 2 * j, "%02X", (unsigned char)value[j]);
+    }
+    expected[2 * len]= '\0';
+
+    ok_stmt(hstmt1, SQLExecute(hstmt1));
+    ok_stmt(hstmt1, SQLFetch(hstmt1));
+    is_str(my_fetch_str(hstmt1, (SQLCHAR *)hex, 1), expected, 2 * len + 1);
+    ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  }
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(my_init_table)
 #ifndef USE_IODBC
@@ -1723,6 +1778,7 @@ BEGIN_TESTS
   // ADD_TEST(t_bug14586094) TODO: Fix
   // ADD_TEST(t_longtextoutparam)  TODO: Fix
   ADD_TEST(t_bug53891)
+  ADD_TEST(t_param_escape)
 #if USE_UNIXODBC
   ADD_TEST(t_odbc_outstream_params)
   ADD_TEST(t_odbc_inoutstream_params)
@@ -1252,6 +1252,179 @@ DECLARE_TEST(t_bug67920)
 }
 
 
+/**
+  SELECT without parameters prepared on the server with PREPARE_SELECT,
+  results are fetched in the binary protocol into bound columns.
+*/
+DECLARE_TEST(t_prepare_select)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLHSTMT   hstmt2;
+  SQLINTEGER id[2];
+  SQLDOUBLE  amount[2];
+  SQL_TIMESTAMP_STRUCT ts[2];
+  SQLLEN     ind[2], ts_ind[2];
+  SQLINTEGER executed;
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_prepare_select");
+  ok_sql(hstmt, "CREATE TABLE t_prepare_select (id INT, amount DOUBLE, "
+                "created DATETIME)");
+  ok_sql(hstmt, "INSERT INTO t_prepare_select VALUES "
+                "(1, 1.5, '2018-01-02 03:04:05'), (2, NULL, NULL)");
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                        NULL, NULL, NULL, "PREPARE_SELECT=1"));
+
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE,
+                                 (SQLPOINTER)2, 0));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, id, 0, NULL));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_DOUBLE, amount, 0, ind));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 3, SQL_C_TIMESTAMP, ts, sizeof(ts[0]),
+                             ts_ind));
+
+  /* The SELECT is executed as a prepared statement, SHOW is not */
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+  ok_sql(hstmt2, "SHOW SESSION STATUS LIKE 'Com_stmt_execute'");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  executed= my_fetch_int(hstmt2, 2);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  ok_sql(hstmt1, "SELECT id, amount, created FROM t_prepare_select "
+                 "ORDER BY id");
+
+  ok_sql(hstmt2, "SHOW SESSION STATUS LIKE 'Com_stmt_execute'");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  is_num(my_fetch_int(hstmt2, 2), executed + 1);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_DROP));
+
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+
+  is_num(id[0], 1);
+  is(amount[0] == 1.5);
+  is_num(ts[0].year, 2018);
+  is_num(ts[0].month, 1);
+  is_num(ts[0].day, 2);
+  is_num(ts[0].hour, 3);
+  is_num(ts[0].minute, 4);
+  is_num(ts[0].second, 5);
+  is_num(ts_ind[0], sizeof(SQL_TIMESTAMP_STRUCT));
+
+  is_num(id[1], 2);
+  is_num(ind[1], SQL_NULL_DATA);
+  is_num(ts_ind[1], SQL_NULL_DATA);
+
+  expect_stmt(hstmt1, SQLFetch(hstmt1), SQL_NO_DATA);
+
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_prepare_select");
+
+  return OK;
+}
+
+
+/*
+  Preparing the same text again, on the same or on another statement of
+  the connection, reuses the parsed query.
+*/
+DECLARE_TEST(t_prepare_template)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLHSTMT hstmt2;
+  SQLCHAR buff[32];
+  SQLINTEGER param= 1;
+  const char *query= "{SELECT ? + 1, '?{}', CONCAT('a', ?)}";
+  int i;
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                        NULL, NULL, NULL, "NO_SSPS=1"));
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+
+  for (i= 0; i < 3; ++i)
+  {
+    SQLHSTMT stmt= i == 1 ? hstmt2 : hstmt1;
+
+    param= i;
+    ok_stmt(stmt, SQLPrepare(stmt, (SQLCHAR *)query, SQL_NTS));
+    ok_stmt(stmt, SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, &param, 0, NULL));
+    ok_stmt(stmt, SQLBindParameter(stmt, 2, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, &param, 0, NULL));
+    ok_stmt(stmt, SQLExecute(stmt));
+    ok_stmt(stmt, SQLFetch(stmt));
+    is_num(my_fetch_int(stmt, 1), i + 1);
+    is_str(my_fetch_str(stmt, buff, 2), "?{}", 3);
+    sprintf((char *)buff + 16, "a%d", i);
+    is_str(my_fetch_str(stmt, buff, 3), buff + 16, 2);
+    expect_stmt(stmt, SQLFetch(stmt), SQL_NO_DATA);
+    ok_stmt(stmt, SQLFreeStmt(stmt, SQL_CLOSE));
+  }
+
+  /* A text differing in the braces only is another query */
+  ok_stmt(hstmt1, SQLPrepare(hstmt1, (SQLCHAR *)"SELECT ? + 1, '?{}', "
+                             "CONCAT('a', ?)", SQL_NTS));
+  ok_stmt(hstmt1, SQLExecute(hstmt1));
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 3);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
+
+/*
+  Parameter markers of a large generated statement, with question marks in
+  its comments and strings. Its throughput is measured by
+  bench/tokenizer_bench.c.
+*/
+DECLARE_TEST(t_prepare_large)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  const size_t size= 1024 * 1024;
+  char *query= malloc(size + 256), *pos;
+  SQLCHAR buff[32];
+  SQLSMALLINT params;
+  SQLINTEGER param= 7;
+  int i;
+
+  is(query != NULL);
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                        NULL, NULL, NULL, "NO_SSPS=1"));
+
+  pos= query + sprintf(query, "SELECT /* ? */ CASE WHEN ? IN (");
+  for (i= 0; pos - query < (long)size; ++i)
+  {
+    pos+= sprintf(pos, i % 8 ? "%d, " : "\n  -1, '%d?', \"%d\\\"\", ",
+                  i, i);
+  }
+  pos+= sprintf(pos, "-2) THEN 'in ''list'' ?' ELSE \"no\" END, ? -- ?\n");
+
+  ok_stmt(hstmt1, SQLPrepare(hstmt1, (SQLCHAR *)query, SQL_NTS));
+
+  ok_stmt(hstmt1, SQLNumParams(hstmt1, &params));
+  is_num(params, 2);
+
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, &param, 0, NULL));
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 2, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, &param, 0, NULL));
+  ok_stmt(hstmt1, SQLExecute(hstmt1));
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "in 'list' ?", 11);
+  is_num(my_fetch_int(hstmt1, 2), 7);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  free(query);
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_prep_basic)
   ADD_TEST(t_prep_buffer_length)
@@ -1273,6 +1446,9 @@ BEGIN_TESTS
   ADD_TEST(t_bug67702)
   ADD_TEST(t_bug68243)
   ADD_TEST(t_bug67920)
+  ADD_TEST(t_prepare_select)
+  ADD_TEST(t_prepare_template)
+  ADD_TEST(t_prepare_large)
 END_TESTS
 
 
@@ -2251,6 +2251,92 @@ DECLARE_TEST(t_bug34429)
 }
 
 
+/**
+  Conversion of a large rowset on the worker pool, with rows that are
+  truncated mixed with rows that convert cleanly.
+*/
+DECLARE_TEST(t_parallel_fetch)
+{
+  SQLINTEGER          id[256], i;
+  SQL_INTERVAL_STRUCT interval[256];
+  SQLCHAR             str[256][4];
+  SQLLEN              str_len[256];
+  SQLUSMALLINT        status[256];
+  SQLULEN             nrows;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_parallel_fetch");
+  ok_sql(hstmt, "CREATE TABLE t_parallel_fetch (id INT, t TIME)");
+  ok_sql(hstmt, "INSERT INTO t_parallel_fetch VALUES (0, '01:02:03')");
+  for (i= 0; i < 8; ++i)
+  {
+    SQLCHAR query[80];
+
+    sprintf((char *)query, "INSERT INTO t_parallel_fetch "
+                           "SELECT id + %d, t FROM t_parallel_fetch", 1 << i);
+    ok_sql(hstmt, query);
+  }
+
+  /* Every rowset goes to the pool */
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL,
+                                        "PARALLEL_FETCH=4;"
+                                        "PARALLEL_FETCH_MIN_CELLS=1"));
+
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE,
+                                 (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE,
+                                 (SQLPOINTER)256, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_STATUS_PTR, status, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &nrows,
+                                 0));
+
+  ok_sql(hstmt1, "SELECT id, t, IF(id % 10 = 0, 'long', 'abc') "
+                 "FROM t_parallel_fetch ORDER BY id");
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, id, 0, NULL));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_INTERVAL_HOUR_TO_SECOND,
+                             interval, 0, NULL));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 3, SQL_C_CHAR, str, sizeof(str[0]),
+                             str_len));
+
+  /* The truncated rows make the whole fetch return with info */
+  expect_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_NEXT, 0),
+              SQL_SUCCESS_WITH_INFO);
+  is(check_sqlstate(hstmt1, "01004") == OK);
+  is_num(nrows, 256);
+
+  for (i= 0; i < 256; ++i)
+  {
+    is_num(id[i], i);
+    is_num(interval[i].intval.day_second.hour, 1);
+    is_num(interval[i].intval.day_second.minute, 2);
+    is_num(interval[i].intval.day_second.second, 3);
+
+    if (i % 10 == 0)
+    {
+      is_num(status[i], SQL_ROW_SUCCESS_WITH_INFO);
+      is_num(str_len[i], 4);
+      is_str(str[i], "lon", 4);
+    }
+    else
+    {
+      is_num(status[i], SQL_ROW_SUCCESS);
+      is_num(str_len[i], 3);
+      is_str(str[i], "abc", 4);
+    }
+  }
+
+  expect_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_NEXT, 0), SQL_NO_DATA);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_parallel_fetch");
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(my_resultset)
   ADD_TEST(t_convert_type)
@@ -2284,6 +2370,7 @@ BEGIN_TESTS
   ADD_TEST(t_bug13776_auto)
   ADD_TEST(t_bug28617)
   ADD_TEST(t_bug34429)
+  ADD_TEST(t_parallel_fetch)
 END_TESTS
 
 
@@ -25,6 +25,7 @@
 
 #include "odbctap.h"
 #include "../VersionInfo.h"
+#include "../driver/myodbc_arrow.h"
 
 
 /*
@@ -1368,6 +1369,323 @@ DECLARE_TEST(t_prefetch_bug)
     return OK;
 }
 
+/*
+  Fetch an Arrow batch through the entry point read from the driver, with
+  the statement handle of the driver.
+*/
+static SQLRETURN fetch_arrow(SQLHDBC hdbc1, SQLHSTMT hstmt1,
+                             struct ArrowSchema *schema,
+                             struct ArrowArray *array)
+{
+  MYODBCFetchArrowFunc fetch= NULL;
+  SQLHANDLE driver_hstmt= hstmt1;
+  SQLRETURN rc;
+
+  rc= SQLGetStmtAttr(hstmt1, SQL_ATTR_MYODBC_ARROW_FETCH, &fetch, 0, NULL);
+  if (!SQL_SUCCEEDED(rc))
+    return rc;
+
+  rc= SQLGetInfo(hdbc1, SQL_DRIVER_HSTMT, &driver_hstmt, 0, NULL);
+  if (!SQL_SUCCEEDED(rc))
+    return rc;
+
+  return fetch(driver_hstmt, schema, array);
+}
+
+
+/**
+  Columnar fetch of a result set as Arrow batches.
+*/
+DECLARE_TEST(t_arrow_fetch)
+{
+  struct
+  {
+    struct ArrowSchema schema;
+    struct ArrowArray  array;
+  } batch;
+  struct ArrowArray *col;
+  const int32_t *offsets;
+  const unsigned char *validity;
+  SQLULEN batch_size= 0;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_arrow");
+  ok_sql(hstmt, "CREATE TABLE t_arrow (id INT NOT NULL, u BIGINT UNSIGNED, "
+                "d DOUBLE, s VARCHAR(20), dt DATE, ts DATETIME(6), "
+                "b VARBINARY(10))");
+  ok_sql(hstmt, "INSERT INTO t_arrow VALUES "
+                "(1, 18446744073709551615, 1.5, 'abc', '1970-01-02', "
+                "'1970-01-01 00:00:01.000002', 0x0001), "
+                "(2, NULL, NULL, NULL, NULL, NULL, NULL), "
+                "(3, 7, -2.25, '', '1969-12-31', '2000-03-01 12:00:00', '')");
+
+  ok_stmt(hstmt, SQLGetStmtAttr(hstmt, SQL_ATTR_MYODBC_ARROW_BATCH_SIZE,
+                                &batch_size, 0, NULL));
+  is_num(batch_size, MYODBC_ARROW_DEFAULT_BATCH_SIZE);
+  ok_stmt(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_MYODBC_ARROW_BATCH_SIZE,
+                                (SQLPOINTER)2, 0));
+
+  ok_sql(hstmt, "SELECT * FROM t_arrow ORDER BY id");
+
+  ok_stmt(hstmt, fetch_arrow(hdbc, hstmt, &batch.schema, &batch.array));
+  is_str(batch.schema.format, "+s", 2);
+  is_num(batch.schema.n_children, 7);
+  is_str(batch.schema.children[0]->name, "id", 2);
+  is_str(batch.schema.children[0]->format, "i", 1);
+  is_num(batch.schema.children[0]->flags, 0);
+  is_str(batch.schema.children[1]->format, "L", 1);
+  is_num(batch.schema.children[1]->flags, ARROW_FLAG_NULLABLE);
+  is_str(batch.schema.children[2]->format, "g", 1);
+  is_str(batch.schema.children[3]->format, "u", 1);
+  is_str(batch.schema.children[4]->format, "tdD", 3);
+  is_str(batch.schema.children[5]->format, "tsu:", 4);
+  is_str(batch.schema.children[6]->format, "z", 1);
+
+  is_num(batch.array.length, 2);
+  is_num(batch.array.n_children, 7);
+
+  col= batch.array.children[0];
+  is_num(col->null_count, 0);
+  is(col->buffers[0] == NULL);
+  is_num(((const int32_t *)col->buffers[1])[0], 1);
+  is_num(((const int32_t *)col->buffers[1])[1], 2);
+
+  col= batch.array.children[1];
+  is_num(col->null_count, 1);
+  validity= (const unsigned char *)col->buffers[0];
+  is_num(validity[0] & 3, 1);
+  is(((const uint64_t *)col->buffers[1])[0] == 18446744073709551615ULL);
+
+  col= batch.array.children[2];
+  is(((const double *)col->buffers[1])[0] == 1.5);
+
+  col= batch.array.children[3];
+  is_num(col->n_buffers, 3);
+  offsets= (const int32_t *)col->buffers[1];
+  is_num(offsets[0], 0);
+  is_num(offsets[1], 3);
+  is_num(offsets[2], 3);
+  is(!memcmp(col->buffers[2], "abc", 3));
+
+  col= batch.array.children[4];
+  is_num(((const int32_t *)col->buffers[1])[0], 1);
+
+  col= batch.array.children[5];
+  is(((const int64_t *)col->buffers[1])[0] == 1000002);
+
+  col= batch.array.children[6];
+  offsets= (const int32_t *)col->buffers[1];
+  is_num(offsets[1], 2);
+  is(!memcmp(col->buffers[2], "\0\1", 2));
+
+  batch.array.release(&batch.array);
+  batch.schema.release(&batch.schema);
+  is(batch.array.release == NULL);
+
+  /* The last row, then the end of the result */
+  ok_stmt(hstmt, fetch_arrow(hdbc, hstmt, &batch.schema, &batch.array));
+  is_num(batch.array.length, 1);
+  is_num(((const int32_t *)batch.array.children[0]->buffers[1])[0], 3);
+  is_num(((const int32_t *)batch.array.children[4]->buffers[1])[0], -1);
+  is(((const int64_t *)batch.array.children[5]->buffers[1])[0] ==
+     951912000000000LL);
+  batch.array.release(&batch.array);
+  batch.schema.release(&batch.schema);
+
+  expect_stmt(hstmt, fetch_arrow(hdbc, hstmt, &batch.schema, &batch.array),
+              SQL_NO_DATA);
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* A TIME is a duration, negative or of more than a day as well */
+  ok_sql(hstmt, "SELECT CAST('-01:30:00' AS TIME), "
+                "CAST('838:59:59.5' AS TIME(1)), CAST('12:00:00' AS TIME)");
+  ok_stmt(hstmt, fetch_arrow(hdbc, hstmt, &batch.schema, &batch.array));
+  is_str(batch.schema.children[0]->format, "tDu", 3);
+  is_num(batch.array.children[0]->null_count, 0);
+  is(((const int64_t *)batch.array.children[0]->buffers[1])[0] ==
+     -5400000000LL);
+  is_num(batch.array.children[1]->null_count, 0);
+  is(((const int64_t *)batch.array.children[1]->buffers[1])[0] ==
+     3020399500000LL);
+  is(((const int64_t *)batch.array.children[2]->buffers[1])[0] ==
+     43200000000LL);
+  batch.array.release(&batch.array);
+  batch.schema.release(&batch.schema);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* Strings come in the charset of their field, here without conversion
+     by the server, and are converted from it to utf8 */
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_arrow2");
+  ok_sql(hstmt, "CREATE TABLE t_arrow2 (s VARCHAR(10) CHARACTER SET latin1)");
+  ok_sql(hstmt, "INSERT INTO t_arrow2 VALUES (_latin1 X'E961')");
+
+  is(OK == alloc_basic_handles(&henv1, &hdbc1, &hstmt1));
+  ok_sql(hstmt1, "SET character_set_results = NULL");
+  ok_sql(hstmt1, "SELECT s FROM t_arrow2");
+  ok_stmt(hstmt1, fetch_arrow(hdbc1, hstmt1, &batch.schema, &batch.array));
+  is_num(batch.array.length, 1);
+  col= batch.array.children[0];
+  offsets= (const int32_t *)col->buffers[1];
+  is_num(offsets[1], 3);
+  is(!memcmp(col->buffers[2], "\xC3\xA9" "a", 3));
+  batch.array.release(&batch.array);
+  batch.schema.release(&batch.schema);
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_arrow2");
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_arrow");
+
+  return OK;
+}
+
+
+/*
+  RESULT_CACHE_TTL: repeated SELECTs are answered from the cache until a
+  statement that may change data runs on any connection of the environment.
+*/
+DECLARE_TEST(t_result_cache)
+{
+  SQLCHAR buff[32];
+  SQLHDBC hdbc2;
+  SQLHSTMT hstmt2;
+  SQLINTEGER id1;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_result_cache");
+  ok_sql(hstmt, "CREATE TABLE t_result_cache (id INT PRIMARY KEY, "
+                "v VARCHAR(10))");
+  ok_sql(hstmt, "INSERT INTO t_result_cache VALUES (1, 'a'), (2, 'x')");
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL,
+                                        "RESULT_CACHE_TTL=60;NO_SSPS=1"));
+
+  ok_sql(hstmt1, "SELECT v FROM t_result_cache WHERE id = 1");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "a", 1);
+  expect_stmt(hstmt1, SQLFetch(hstmt1), SQL_NO_DATA);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* A change made from another environment is not seen */
+  ok_sql(hstmt, "UPDATE t_result_cache SET v = 'b' WHERE id = 1");
+
+  ok_sql(hstmt1, "SELECT v  FROM t_result_cache\n WHERE id = 1;");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "a", 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* Whitespace inside of literals is part of the query: the row is changed
+     behind the cached result, and only the server sees the change */
+  ok_sql(hstmt1, "SELECT id FROM t_result_cache WHERE v = 'x'");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 2);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt, "UPDATE t_result_cache SET v = 'y' WHERE id = 2");
+
+  ok_sql(hstmt1, "SELECT id FROM t_result_cache WHERE v = 'x'");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 2);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt1, "SELECT id FROM t_result_cache WHERE v = 'x  '");
+  expect_stmt(hstmt1, SQLFetch(hstmt1), SQL_NO_DATA);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* Results that depend on the session are not shared */
+  ok_env(henv1, SQLAllocHandle(SQL_HANDLE_DBC, henv1, &hdbc2));
+  ok_con(hdbc2, get_connection(&hdbc2, NULL, NULL, NULL, NULL,
+                               "RESULT_CACHE_TTL=60;NO_SSPS=1"));
+  ok_con(hdbc2, SQLAllocHandle(SQL_HANDLE_STMT, hdbc2, &hstmt2));
+
+  ok_sql(hstmt1, "SELECT CONNECTION_ID()");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  id1= my_fetch_int(hstmt1, 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt2, "SELECT CONNECTION_ID()");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  is(my_fetch_int(hstmt2, 1) != id1);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  ok_sql(hstmt1, "SET @result_cache= 1");
+  ok_sql(hstmt1, "SELECT @result_cache");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt2, "SELECT @result_cache IS NULL");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  is_num(my_fetch_int(hstmt2, 1), 1);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+  ok_con(hdbc2, SQLDisconnect(hdbc2));
+  ok_con(hdbc2, SQLFreeHandle(SQL_HANDLE_DBC, hdbc2));
+
+  /* A statement that may change data clears the cache */
+  ok_sql(hstmt1, "UPDATE t_result_cache SET v = 'c' WHERE id = 2");
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt1, "SELECT v FROM t_result_cache WHERE id = 1");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "b", 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* A write from a connection of the environment without the option
+     clears the cache too */
+  ok_env(henv1, SQLAllocHandle(SQL_HANDLE_DBC, henv1, &hdbc2));
+  ok_con(hdbc2, get_connection(&hdbc2, NULL, NULL, NULL, NULL,
+                               "NO_SSPS=1;MULTI_STATEMENTS=1"));
+  ok_con(hdbc2, SQLAllocHandle(SQL_HANDLE_STMT, hdbc2, &hstmt2));
+
+  ok_sql(hstmt2, "UPDATE t_result_cache SET v = 'e' WHERE id = 1");
+
+  ok_sql(hstmt1, "SELECT v FROM t_result_cache WHERE id = 1");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "e", 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* So does a batch that starts with a SELECT */
+  ok_sql(hstmt2, "SELECT 1; UPDATE t_result_cache SET v = 'f' WHERE id = 1");
+  ok_stmt(hstmt2, SQLMoreResults(hstmt2));
+  expect_stmt(hstmt2, SQLMoreResults(hstmt2), SQL_NO_DATA);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  ok_sql(hstmt1, "SELECT v FROM t_result_cache WHERE id = 1");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "f", 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+  ok_con(hdbc2, SQLDisconnect(hdbc2));
+  ok_con(hdbc2, SQLFreeHandle(SQL_HANDLE_DBC, hdbc2));
+
+  /* Nothing is cached inside of a transaction */
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_AUTOCOMMIT,
+                                  (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+  ok_sql(hstmt1, "SELECT v FROM t_result_cache WHERE id = 2");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "c", 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_con(hdbc1, SQLEndTran(SQL_HANDLE_DBC, hdbc1, SQL_COMMIT));
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_AUTOCOMMIT,
+                                  (SQLPOINTER)SQL_AUTOCOMMIT_ON, 0));
+
+  ok_sql(hstmt, "UPDATE t_result_cache SET v = 'd' WHERE id = 2");
+  ok_sql(hstmt1, "SELECT v FROM t_result_cache WHERE id = 2");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, buff, 1), "d", 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_result_cache");
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_bug32420)
   ADD_TEST(t_bug34575)
@@ -1395,6 +1713,8 @@ BEGIN_TESTS
 #endif
   ADD_TEST(t_bug17311065)
   ADD_TEST(t_prefetch_bug)
+  ADD_TEST(t_arrow_fetch)
+  ADD_TEST(t_result_cache)
 END_TESTS
 
 
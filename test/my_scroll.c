@@ -1224,6 +1224,119 @@ DECLARE_TEST(t_absolute_2)
 }
 
 
+/**
+  Keyset-driven cursor reading its rowsets again by primary key.
+*/
+DECLARE_TEST(t_keyset_cursor)
+{
+  SQLINTEGER   id[3];
+  SQLCHAR      name[3][20];
+  SQLUSMALLINT status[3];
+  SQLULEN      nrows;
+  SQLUINTEGER  options;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_keyset_cursor");
+  ok_sql(hstmt, "CREATE TABLE t_keyset_cursor "
+                "(id INT PRIMARY KEY, name VARCHAR(20))");
+  ok_sql(hstmt, "INSERT INTO t_keyset_cursor VALUES (1, 'a'), (2, 'b'), "
+                "(3, 'c'), (4, 'd'), (5, 'e'), (6, 'f'), (7, 'g'), "
+                "(8, 'h'), (9, 'i'), (10, 'j')");
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "KEYSET_CURSOR=1"));
+
+  ok_con(hdbc1, SQLGetInfo(hdbc1, SQL_SCROLL_OPTIONS, &options, 0, NULL));
+  is(options & SQL_SO_KEYSET_DRIVEN);
+
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE,
+                                 (SQLPOINTER)SQL_CURSOR_KEYSET_DRIVEN, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE,
+                                 (SQLPOINTER)3, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_STATUS_PTR, status, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR, &nrows,
+                                 0));
+
+  ok_sql(hstmt1, "SELECT id, name FROM t_keyset_cursor ORDER BY id");
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, id, 0, NULL));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_CHAR, name, sizeof(name[0]),
+                             NULL));
+
+  ok_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 1));
+  is_num(nrows, 3);
+  is_num(id[0], 1);
+  is_num(id[2], 3);
+
+  /* Changes made by another connection are seen by the next fetch */
+  ok_sql(hstmt, "UPDATE t_keyset_cursor SET name= 'changed' WHERE id = 4");
+  ok_sql(hstmt, "DELETE FROM t_keyset_cursor WHERE id = 5");
+
+  ok_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_NEXT, 0));
+  is_num(nrows, 3);
+  is_num(status[0], SQL_ROW_SUCCESS);
+  is_num(id[0], 4);
+  is_str(name[0], "changed", 8);
+  is_num(status[1], SQL_ROW_DELETED);
+  is_num(status[2], SQL_ROW_SUCCESS);
+  is_num(id[2], 6);
+
+  ok_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_LAST, 0));
+  is_num(id[0], 8);
+  is_num(id[2], 10);
+
+  ok_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_PRIOR, 0));
+  is_num(status[0], SQL_ROW_DELETED);
+  is_num(id[1], 6);
+
+  /* The cursor is read-only */
+  expect_stmt(hstmt1, SQLSetPos(hstmt1, 2, SQL_DELETE, SQL_LOCK_NO_CHANGE),
+              SQL_ERROR);
+  is(check_sqlstate(hstmt1, "HYC00") == OK);
+
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+  /* Without the key in the result, the cursor is a static one */
+  ok_sql(hstmt1, "SELECT name FROM t_keyset_cursor ORDER BY id");
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_CHAR, name, sizeof(name[0]),
+                             NULL));
+  ok_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_LAST, 0));
+  is_num(nrows, 3);
+  is_str(name[2], "j", 2);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+
+  /* A non-ASCII string key is looked up in the charset of its column */
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_keyset_cursor2");
+  ok_sql(hstmt, "CREATE TABLE t_keyset_cursor2 "
+                "(name VARCHAR(20) CHARACTER SET latin1 PRIMARY KEY, id INT)");
+  ok_sql(hstmt, "INSERT INTO t_keyset_cursor2 VALUES (_latin1 X'E9', 1), "
+                "(_latin1 X'C5E9', 2), ('a''b', 3)");
+
+  ok_sql(hstmt1, "SELECT name, id FROM t_keyset_cursor2 ORDER BY id");
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_LONG, id, 0, NULL));
+
+  ok_sql(hstmt, "UPDATE t_keyset_cursor2 SET id= id + 10");
+
+  ok_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_NEXT, 0));
+  is_num(nrows, 3);
+  is_num(status[0], SQL_ROW_SUCCESS);
+  is_num(id[0], 11);
+  is_num(status[1], SQL_ROW_SUCCESS);
+  is_num(id[1], 12);
+  is_num(status[2], SQL_ROW_SUCCESS);
+  is_num(id[2], 13);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_keyset_cursor2");
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_keyset_cursor");
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_scroll)
   ADD_TEST(t_array_relative_10)
@@ -1231,6 +1344,7 @@ BEGIN_TESTS
   ADD_TEST(t_relative_1)
   ADD_TEST(t_absolute_1)
   ADD_TEST(t_absolute_2)
+  ADD_TEST(t_keyset_cursor)
 END_TESTS
 
 
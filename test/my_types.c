@@ -915,6 +915,501 @@ DECLARE_TEST(t_sqlnum_from_str)
 }
 
 
+/*
+  The conversions between strings and SQL_NUMERIC_STRUCT as the driver had
+  them in 4-digit segments of int arrays, to check the 128-bit ones against
+  for the values where both are defined.
+*/
+#define REF_TRUNC_FRAC 1
+#define REF_TRUNC_WHOLE 2
+
+static void ref_sqlnum_scale(int *ary, int s)
+{
+  /* multiply out all pieces */
+  while (s--)
+  {
+    ary[0] *= 10;
+    ary[1] *= 10;
+    ary[2] *= 10;
+    ary[3] *= 10;
+    ary[4] *= 10;
+    ary[5] *= 10;
+    ary[6] *= 10;
+    ary[7] *= 10;
+  }
+}
+
+
+static void ref_sqlnum_unscale_le(int *ary)
+{
+  int i;
+  for (i= 7; i > 0; --i)
+  {
+    ary[i - 1] += (ary[i] % 10) << 16;
+    ary[i] /= 10;
+  }
+}
+
+
+static void ref_sqlnum_unscale_be(int *ary, int start)
+{
+  int i;
+  for (i= start; i < 7; ++i)
+  {
+    ary[i + 1] += (ary[i] % 10) << 16;
+    ary[i] /= 10;
+  }
+}
+
+
+static void ref_sqlnum_carry(int *ary)
+{
+  int i;
+  /* carry over rest of structure */
+  for (i= 0; i < 7; ++i)
+  {
+    ary[i+1] += ary[i] >> 16;
+    ary[i] &= 0xffff;
+  }
+}
+
+
+static void ref_sqlnum_from_str(const char *numstr, SQL_NUMERIC_STRUCT *sqlnum,
+                     int *overflow_ptr)
+{
+  /*
+     We use 16 bits of each integer to convert the
+     current segment of the number leaving extra bits
+     to multiply/carry
+  */
+  int build_up[8], tmp_prec_calc[8];
+  /* current segment as integer */
+  unsigned int curnum;
+  /* current segment digits copied for strtoul() */
+  char curdigs[5];
+  /* number of digits in current segment */
+  int usedig;
+  int i;
+  int len;
+  char *decpt= strchr(numstr, '.');
+  int overflow= 0;
+  SQLSCHAR reqscale= sqlnum->scale;
+  SQLCHAR reqprec= sqlnum->precision;
+
+  memset(&sqlnum->val, 0, sizeof(sqlnum->val));
+  memset(build_up, 0, sizeof(build_up));
+
+  /* handle sign */
+  if (!(sqlnum->sign= !(*numstr == '-')))
+    ++numstr;
+
+  len= (int) strlen(numstr);
+  sqlnum->precision= len;
+  sqlnum->scale= 0;
+
+  /* process digits in groups of <=4 */
+  for (i= 0; i < len; i += usedig)
+  {
+    if (i + 4 < len)
+      usedig= 4;
+    else
+      usedig= len - i;
+    /*
+       if we have the decimal point, ignore it by setting it to the
+       last char (will be ignored by strtoul)
+    */
+    if (decpt && decpt >= numstr + i && decpt < numstr + i + usedig)
+    {
+      usedig = (int) (decpt - (numstr + i) + 1);
+      sqlnum->scale= len - (i + usedig);
+      --sqlnum->precision;
+      decpt= NULL;
+    }
+    /* terminate prematurely if we can't do anything else */
+    /*if (overflow && !decpt)
+      break;
+    else */if (overflow)
+      /*continue;*/goto end;
+    /* grab just this piece, and convert to int */
+    memcpy(curdigs, numstr + i, usedig);
+    curdigs[usedig]= 0;
+    curnum= strtoul(curdigs, NULL, 10);
+    if (curdigs[usedig - 1] == '.')
+      ref_sqlnum_scale(build_up, usedig - 1);
+    else
+      ref_sqlnum_scale(build_up, usedig);
+    /* add the current number */
+    build_up[0] += curnum;
+    ref_sqlnum_carry(build_up);
+    if (build_up[7] & ~0xffff)
+      overflow= 1;
+  }
+
+  /* scale up to SQL_DESC_SCALE */
+  if (reqscale > 0 && reqscale > sqlnum->scale)
+  {
+    while (reqscale > sqlnum->scale)
+    {
+      ref_sqlnum_scale(build_up, 1);
+      ref_sqlnum_carry(build_up);
+      ++sqlnum->scale;
+    }
+  }
+  /* scale back, truncating decimals */
+  else if (reqscale < sqlnum->scale)
+  {
+    while (reqscale < sqlnum->scale && sqlnum->scale > 0)
+    {
+      ref_sqlnum_unscale_le(build_up);
+      build_up[0] /= 10;
+      --sqlnum->precision;
+      --sqlnum->scale;
+    }
+  }
+
+  /* scale back whole numbers while there's no significant digits */
+  if (reqscale < 0)
+  {
+    memcpy(tmp_prec_calc, build_up, sizeof(build_up));
+    while (reqscale < sqlnum->scale)
+    {
+      ref_sqlnum_unscale_le(tmp_prec_calc);
+      if (tmp_prec_calc[0] % 10)
+      {
+        overflow= 1;
+        goto end;
+      }
+      ref_sqlnum_unscale_le(build_up);
+      tmp_prec_calc[0] /= 10;
+      build_up[0] /= 10;
+      --sqlnum->precision;
+      --sqlnum->scale;
+    }
+  }
+
+  /* calculate minimum precision */
+  memcpy(tmp_prec_calc, build_up, sizeof(build_up));
+
+  do
+  {
+    ref_sqlnum_unscale_le(tmp_prec_calc);
+    i= tmp_prec_calc[0] % 10;
+    tmp_prec_calc[0] /= 10;
+    if (i == 0)
+      --sqlnum->precision;
+  } while (i == 0 && sqlnum->precision > 0);
+
+  /* detect precision overflow */
+  if (sqlnum->precision > reqprec)
+    overflow= 1;
+  else
+    sqlnum->precision= reqprec;
+
+  /* compress results into SQL_NUMERIC_STRUCT.val */
+  for (i= 0; i < 8; ++i)
+  {
+    int elem= 2 * i;
+    sqlnum->val[elem]= build_up[i] & 0xff;
+    sqlnum->val[elem+1]= (build_up[i] >> 8) & 0xff;
+  }
+
+end:
+  if (overflow_ptr)
+    *overflow_ptr= overflow;
+}
+
+
+static void ref_sqlnum_to_str(SQL_NUMERIC_STRUCT *sqlnum, SQLCHAR *numstr,
+                   SQLCHAR **numbegin, SQLCHAR reqprec, SQLSCHAR reqscale,
+                   int *truncptr)
+{
+  /* with a non-zero sentinel, where the loop skipping zeros stops */
+  int expanded[9];
+  int i, j;
+  int max_space= 0;
+  int calcprec= 0;
+  int trunc= 0; /* truncation indicator */
+
+  *numstr--= 0;
+
+  /*
+     it's expected to have enough space
+     (~at least min(39, max(prec, scale+2)) + 3)
+  */
+
+  /*
+     expand the packed sqlnum->val so we have space to divide through
+     expansion happens into an array in big-endian form
+  */
+  expanded[8]= 1;
+  for (i= 0; i < 8; ++i)
+    expanded[7 - i]= (sqlnum->val[(2 * i) + 1] << 8) | sqlnum->val[2 * i];
+
+  /* max digits = 39 = log_10(2^128)+1 */
+  for (j= 0; j < 39; ++j)
+  {
+    /* skip empty prefix */
+    while (!expanded[max_space])
+      ++max_space;
+    /* if only the last piece has a value, it's the end */
+    if (max_space >= 7)
+    {
+      i= 7;
+      if (!expanded[7])
+      {
+        /* special case for zero, we'll end immediately */
+        if (!*(numstr + 1))
+        {
+          *numstr--= '0';
+          calcprec= 1;
+        }
+        break;
+      }
+    }
+    else
+    {
+      /* extract the next digit */
+      ref_sqlnum_unscale_be(expanded, max_space);
+    }
+    *numstr--= '0' + (expanded[7] % 10);
+    expanded[7] /= 10;
+    ++calcprec;
+    if (j == reqscale - 1)
+      *numstr--= '.';
+  }
+
+  sqlnum->scale= reqscale;
+
+  /* add <- dec pt */
+  if (calcprec < reqscale)
+  {
+    while (calcprec < reqscale)
+    {
+      *numstr--= '0';
+      --reqscale;
+    }
+    *numstr--= '.';
+    *numstr--= '0';
+  }
+
+  /* handle fractional truncation */
+  if (calcprec > reqprec && reqscale > 0)
+  {
+    SQLCHAR *end= numstr + strlen((char *)numstr) - 1;
+    while (calcprec > reqprec && reqscale)
+    {
+      *end--= 0;
+      --calcprec;
+      --reqscale;
+    }
+    if (calcprec > reqprec && reqscale == 0)
+    {
+      trunc= REF_TRUNC_WHOLE;
+      goto end;
+    }
+    if (*end == '.')
+    {
+      *end--= '\0';
+    }
+    else
+    {
+      /* move the dec pt-- ??? */
+      /*
+      char c2, c= numstr[calcprec - reqscale];
+      numstr[calcprec - reqscale]= '.';
+      while (reqscale)
+      {
+        c2= numstr[calcprec + 1 - reqscale];
+        numstr[calcprec + 1 - reqscale]= c;
+        c= c2;
+        --reqscale;
+      }
+      */
+    }
+    trunc= REF_TRUNC_FRAC;
+  }
+
+  /* add zeros for negative scale */
+  if (reqscale < 0)
+  {
+    int i;
+    reqscale *= -1;
+    for (i= 1; i <= calcprec; ++i)
+      *(numstr + i - reqscale)= *(numstr + i);
+    numstr -= reqscale;
+    memset(numstr + calcprec + 1, '0', reqscale);
+  }
+
+  sqlnum->precision= calcprec;
+
+  /* finish up, handle auxilary fix-ups */
+  if (!sqlnum->sign)
+  {
+    *numstr--= '-';
+  }
+  ++numstr;
+  *numbegin= numstr;
+
+end:
+  if (truncptr)
+    *truncptr= trunc;
+}
+
+
+/* Random numbers from a fixed seed, so that a failure can be repeated */
+static unsigned long sqlnum_rand(unsigned long *seed)
+{
+  *seed= *seed * 1103515245UL + 12345UL;
+  return (*seed >> 8) & 0xffffff;
+}
+
+
+/*
+  Differential test of SQL_NUMERIC_STRUCT conversions against the
+  reference implementation above. Strings are stored verbatim in a
+  VARCHAR column and fetched as SQL_C_NUMERIC, and random structs are sent
+  as string parameters, with random precision and scale both ways. Values
+  stay below 10^36, the range where the reference has no int overflow.
+*/
+DECLARE_TEST(t_sqlnum_differential)
+{
+  SQL_NUMERIC_STRUCT num, ref;
+  SQLHANDLE ard, ipd;
+  SQLCHAR str[64], refbuf[128], *refstr;
+  unsigned long seed= 20180301;
+  int i, j, overflow, trunc;
+  const int rows= 400;
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_sqlnum_diff");
+  ok_sql(hstmt, "CREATE TABLE t_sqlnum_diff (id INT PRIMARY KEY, "
+                "s VARCHAR(64))");
+
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)"INSERT INTO t_sqlnum_diff "
+                            "VALUES (?, ?)", SQL_NTS));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                  SQL_INTEGER, 0, 0, &i, 0, NULL));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR,
+                                  SQL_VARCHAR, 64, 0, str, 0, NULL));
+
+  for (i= 0; i < rows; ++i)
+  {
+    char *pos= (char *)str;
+    int whole= sqlnum_rand(&seed) % 21, frac= sqlnum_rand(&seed) % 11;
+
+    if (!whole && !frac)
+      whole= 1;
+    if (sqlnum_rand(&seed) % 3 == 0)
+      *pos++= '-';
+    if (sqlnum_rand(&seed) % 5 == 0)
+      *pos++= '0';
+    for (j= 0; j < whole; ++j)
+      *pos++= '0' + (char)(sqlnum_rand(&seed) % 10);
+    /* "1." is a number too */
+    if (frac || sqlnum_rand(&seed) % 5 == 0)
+      *pos++= '.';
+    for (j= 0; j < frac; ++j)
+      *pos++= '0' + (char)(sqlnum_rand(&seed) % 10);
+    *pos= '\0';
+
+    ok_stmt(hstmt, SQLExecute(hstmt));
+  }
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* From strings */
+  ok_sql(hstmt, "SELECT s, s FROM t_sqlnum_diff ORDER BY id");
+  ok_stmt(hstmt, SQLBindCol(hstmt, 1, SQL_C_CHAR, str, sizeof(str), NULL));
+  ok_stmt(hstmt, SQLGetStmtAttr(hstmt, SQL_ATTR_APP_ROW_DESC, &ard, 0, NULL));
+  ok_desc(ard, SQLSetDescField(ard, 2, SQL_DESC_TYPE,
+                               (SQLPOINTER)SQL_C_NUMERIC, SQL_IS_INTEGER));
+
+  for (i= 0; i < rows; ++i)
+  {
+    SQLCHAR prec= (SQLCHAR)(1 + sqlnum_rand(&seed) % 38);
+    SQLSCHAR scale= (SQLSCHAR)(sqlnum_rand(&seed) % 20 - 4);
+    SQLRETURN rc;
+
+    ok_desc(ard, SQLSetDescField(ard, 2, SQL_DESC_PRECISION,
+                                 (SQLPOINTER)(SQLINTEGER)prec,
+                                 SQL_IS_INTEGER));
+    ok_desc(ard, SQLSetDescField(ard, 2, SQL_DESC_SCALE,
+                                 (SQLPOINTER)(SQLINTEGER)scale,
+                                 SQL_IS_INTEGER));
+    ok_desc(ard, SQLSetDescField(ard, 2, SQL_DESC_DATA_PTR, &num,
+                                 SQL_IS_POINTER));
+
+    rc= SQLFetch(hstmt);
+
+    ref.precision= prec;
+    ref.scale= scale;
+    ref_sqlnum_from_str((char *)str, &ref, &overflow);
+
+    if (overflow)
+    {
+      is_num(rc, SQL_ERROR);
+      is(check_sqlstate(hstmt, "22003") == OK);
+      continue;
+    }
+
+    ok_stmt(hstmt, rc);
+    is_num(num.precision, ref.precision);
+    is_num(num.scale, ref.scale);
+    is_num(num.sign, ref.sign);
+    is(!memcmp(num.val, ref.val, SQL_MAX_NUMERIC_LEN));
+  }
+  expect_stmt(hstmt, SQLFetch(hstmt), SQL_NO_DATA);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_UNBIND));
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* To strings */
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)"SELECT ?", SQL_NTS));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_NUMERIC,
+                                  SQL_VARCHAR, 64, 0, &num, 0, NULL));
+  ok_stmt(hstmt, SQLGetStmtAttr(hstmt, SQL_ATTR_IMP_PARAM_DESC, &ipd, 0,
+                                NULL));
+
+  for (i= 0; i < rows; ++i)
+  {
+    SQLCHAR prec= (SQLCHAR)(1 + sqlnum_rand(&seed) % 38);
+    SQLSCHAR scale= (SQLSCHAR)(sqlnum_rand(&seed) % 35 - 4);
+    int bytes= 1 + sqlnum_rand(&seed) % 15;
+
+    memset(&num, 0, sizeof(num));
+    num.sign= (SQLCHAR)(sqlnum_rand(&seed) % 2);
+    for (j= 0; j < bytes; ++j)
+      num.val[j]= (SQLCHAR)sqlnum_rand(&seed);
+    ref= num;
+
+    ref_sqlnum_to_str(&ref, refbuf + sizeof(refbuf) - 1, &refstr, prec, scale,
+                      &trunc);
+    /* Whole number truncation is not reported to the application */
+    if (trunc == REF_TRUNC_WHOLE)
+      continue;
+
+    /* Precision and scale of the string the numeric is sent as */
+    ok_desc(ipd, SQLSetDescField(ipd, 1, SQL_DESC_PRECISION,
+                                 (SQLPOINTER)(SQLINTEGER)prec,
+                                 SQL_IS_SMALLINT));
+    ok_desc(ipd, SQLSetDescField(ipd, 1, SQL_DESC_SCALE,
+                                 (SQLPOINTER)(SQLINTEGER)scale,
+                                 SQL_IS_SMALLINT));
+
+    ok_stmt(hstmt, SQLExecute(hstmt));
+    ok_stmt(hstmt, SQLFetch(hstmt));
+    ok_stmt(hstmt, SQLGetData(hstmt, 1, SQL_C_CHAR, str, sizeof(str), NULL));
+    is_str(str, refstr, strlen((char *)refstr) + 1);
+    is_num(num.precision, ref.precision);
+    is_num(num.scale, ref.scale);
+    ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  }
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_sqlnum_diff");
+
+  return OK;
+}
+
+
 /*
    Basic test of binding a SQL_NUMERIC_STRUCT as a query parameter
 */
@@ -1229,6 +1724,7 @@ BEGIN_TESTS
   ADD_TEST(binary_suffix)
   ADD_TEST(t_sqlnum_msdn)
   ADD_TEST(t_sqlnum_from_str)
+  ADD_TEST(t_sqlnum_differential)
 #endif
   ADD_TEST(t_bug16917)
   ADD_TEST(t_bug16235)
@@ -193,10 +193,123 @@ DECLARE_TEST(t_bug39878)
 }
 
 
+/**
+  Fetch all rows of t_read_ahead, checking their values.
+
+  @return Number of rows, or -1 if a value is wrong
+*/
+static int read_ahead_scan(SQLHSTMT hstmt1)
+{
+  SQLINTEGER a, rows= 0;
+  SQLCHAR    b[32];
+  SQLLEN     b_len;
+  SQLRETURN  rc;
+
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE,
+                                 (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0));
+  ok_sql(hstmt1, "SELECT a, IF(a % 2, CONCAT('row ', a), NULL) "
+                 "FROM t_read_ahead ORDER BY a");
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, &a, 0, NULL));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_CHAR, b, sizeof(b), &b_len));
+
+  while (SQL_SUCCEEDED(rc= SQLFetch(hstmt1)))
+  {
+    if (a != rows)
+    {
+      return -1;
+    }
+    if (a % 2)
+    {
+      char expected[32];
+
+      sprintf(expected, "row %d", (int)a);
+      if (b_len != (SQLLEN)strlen(expected) || strcmp((char *)b, expected))
+      {
+        return -1;
+      }
+    }
+    else if (b_len != SQL_NULL_DATA)
+    {
+      return -1;
+    }
+    ++rows;
+  }
+  is_num(rc, SQL_NO_DATA);
+
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_UNBIND));
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  return rows;
+}
+
+
+/**
+  Rows of forward-only results read ahead by a background thread.
+*/
+DECLARE_TEST(t_read_ahead)
+{
+  int         i;
+  SQLINTEGER  a;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_read_ahead");
+  ok_sql(hstmt, "CREATE TABLE t_read_ahead (a INT PRIMARY KEY)");
+  ok_sql(hstmt, "INSERT INTO t_read_ahead VALUES (0), (1)");
+  for (i= 1; i < 14; ++i)
+  {
+    SQLCHAR query[80];
+
+    sprintf((char *)query, "INSERT INTO t_read_ahead "
+                           "SELECT a + %d FROM t_read_ahead", 1 << i);
+    ok_sql(hstmt, query);
+  }
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_CACHE=1"));
+  is_num(read_ahead_scan(hstmt1), 16384);
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL,
+                                        "NO_CACHE=1;READ_AHEAD=3"));
+  is_num(read_ahead_scan(hstmt1), 16384);
+
+  /* Closing the cursor early leaves the connection usable */
+  ok_sql(hstmt1, "SELECT a FROM t_read_ahead ORDER BY a");
+  for (i= 0; i < 10; ++i)
+  {
+    ok_stmt(hstmt1, SQLFetch(hstmt1));
+    is_num(my_fetch_int(hstmt1, 1), i);
+  }
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt1, "SELECT COUNT(*) FROM t_read_ahead");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  ok_stmt(hstmt1, SQLGetData(hstmt1, 1, SQL_C_LONG, &a, 0, NULL));
+  is_num(a, 16384);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* Scrollable cursors are not affected by the option */
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE,
+                                 (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+  ok_sql(hstmt1, "SELECT a FROM t_read_ahead ORDER BY a");
+  ok_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_LAST, 0));
+  is_num(my_fetch_int(hstmt1, 1), 16383);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_read_ahead");
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_use_result)
   ADD_TEST(t_bug4657)
   ADD_TEST(t_bug39878)
+  ADD_TEST(t_read_ahead)
 END_TESTS
 
 
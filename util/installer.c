@@ -37,6 +37,11 @@
 #include "stringutil.h"
 #include "installer.h"
 
+#include <stddef.h>
+#ifndef _WIN32
+# include <sys/stat.h>
+#endif
+
 
 /*
    SQLGetPrivateProfileStringW is buggy in all releases of unixODBC
@@ -187,6 +192,38 @@ static SQLWCHAR W_SSLMODE[] =
 { 'S', 'S', 'L', 'M', 'O', 'D', 'E', 0 };
 static SQLWCHAR W_NO_DATE_OVERFLOW[] =
 { 'N', 'O', '_', 'D', 'A', 'T', 'E', '_', 'O', 'V', 'E', 'R', 'F', 'L', 'O', 'W', 0 };
+static SQLWCHAR W_PARALLEL_FETCH[] =
+{ 'P', 'A', 'R', 'A', 'L', 'L', 'E', 'L', '_', 'F', 'E', 'T', 'C', 'H', 0 };
+static SQLWCHAR W_PARALLEL_FETCH_MIN_CELLS[] =
+{ 'P', 'A', 'R', 'A', 'L', 'L', 'E', 'L', '_', 'F', 'E', 'T', 'C', 'H', '_', 'M', 'I', 'N', '_', 'C', 'E', 'L', 'L', 'S', 0 };
+static SQLWCHAR W_PREPARE_SELECT[] =
+{ 'P', 'R', 'E', 'P', 'A', 'R', 'E', '_', 'S', 'E', 'L', 'E', 'C', 'T', 0 };
+static SQLWCHAR W_LOAD_BALANCE[] =
+{ 'L', 'O', 'A', 'D', '_', 'B', 'A', 'L', 'A', 'N', 'C', 'E', 0 };
+static SQLWCHAR W_HOST_BACKOFF[] =
+{ 'H', 'O', 'S', 'T', '_', 'B', 'A', 'C', 'K', 'O', 'F', 'F', 0 };
+static SQLWCHAR W_CATALOG_BATCH[] =
+{ 'C', 'A', 'T', 'A', 'L', 'O', 'G', '_', 'B', 'A', 'T', 'C', 'H', 0 };
+static SQLWCHAR W_CATALOG_THREADS[] =
+{ 'C', 'A', 'T', 'A', 'L', 'O', 'G', '_', 'T', 'H', 'R', 'E', 'A', 'D', 'S', 0 };
+static SQLWCHAR W_STMT_POOL[] =
+{ 'S', 'T', 'M', 'T', '_', 'P', 'O', 'O', 'L', 0 };
+static SQLWCHAR W_COMPRESSION_ALGORITHM[] =
+{ 'C', 'O', 'M', 'P', 'R', 'E', 'S', 'S', 'I', 'O', 'N', '_', 'A', 'L', 'G', 'O', 'R', 'I', 'T', 'H', 'M', 0 };
+static SQLWCHAR W_COMPRESSION_LEVEL[] =
+{ 'C', 'O', 'M', 'P', 'R', 'E', 'S', 'S', 'I', 'O', 'N', '_', 'L', 'E', 'V', 'E', 'L', 0 };
+static SQLWCHAR W_READ_AHEAD[] =
+{ 'R', 'E', 'A', 'D', '_', 'A', 'H', 'E', 'A', 'D', 0 };
+static SQLWCHAR W_RESULT_CACHE_TTL[] =
+{ 'R', 'E', 'S', 'U', 'L', 'T', '_', 'C', 'A', 'C', 'H', 'E', '_', 'T', 'T', 'L', 0 };
+static SQLWCHAR W_RESULT_CACHE_SIZE[] =
+{ 'R', 'E', 'S', 'U', 'L', 'T', '_', 'C', 'A', 'C', 'H', 'E', '_', 'S', 'I', 'Z', 'E', 0 };
+static SQLWCHAR W_LATENCY_STATS[] =
+{ 'L', 'A', 'T', 'E', 'N', 'C', 'Y', '_', 'S', 'T', 'A', 'T', 'S', 0 };
+static SQLWCHAR W_LATENCY_DUMP[] =
+{ 'L', 'A', 'T', 'E', 'N', 'C', 'Y', '_', 'D', 'U', 'M', 'P', 0 };
+static SQLWCHAR W_KEYSET_CURSOR[] =
+{ 'K', 'E', 'Y', 'S', 'E', 'T', '_', 'C', 'U', 'R', 'S', 'O', 'R', 0 };
 
 /* DS_PARAM */
 /* externally used strings */
@@ -220,7 +257,13 @@ SQLWCHAR *dsnparams[]= {W_DSN, W_DRIVER, W_DESCRIPTION, W_SERVER,
                         W_SAVEFILE, W_RSAKEY, W_PLUGIN_DIR, W_DEFAULT_AUTH,
                         W_DISABLE_SSL_DEFAULT, W_SSL_ENFORCE,
                         W_TLS_1, W_NO_TLS_1_1, W_NO_TLS_1_2,
-                        W_SSLMODE, W_NO_DATE_OVERFLOW};
+                        W_SSLMODE, W_NO_DATE_OVERFLOW, W_PARALLEL_FETCH,
+                        W_PARALLEL_FETCH_MIN_CELLS, W_PREPARE_SELECT,
+                        W_LOAD_BALANCE, W_HOST_BACKOFF, W_CATALOG_BATCH,
+                        W_CATALOG_THREADS, W_STMT_POOL,
+                        W_COMPRESSION_ALGORITHM, W_COMPRESSION_LEVEL,
+                        W_READ_AHEAD, W_RESULT_CACHE_TTL, W_RESULT_CACHE_SIZE,
+                        W_LATENCY_STATS, W_LATENCY_DUMP, W_KEYSET_CURSOR};
 static const
 int dsnparamcnt= sizeof(dsnparams) / sizeof(SQLWCHAR *);
 /* DS_PARAM */
@@ -673,6 +716,9 @@ void ds_delete(DataSource *ds)
   x_free(ds->savefile);
   x_free(ds->plugin_dir);
   x_free(ds->default_auth);
+  x_free(ds->latency_dump);
+  x_free(ds->load_balance);
+  x_free(ds->compression_algorithm);
   
   x_free(ds->name8);
   x_free(ds->driver8);
@@ -694,6 +740,9 @@ void ds_delete(DataSource *ds)
   x_free(ds->savefile8);
   x_free(ds->plugin_dir8);
   x_free(ds->default_auth8);
+  x_free(ds->load_balance8);
+  x_free(ds->compression_algorithm8);
+  x_free(ds->latency_dump8);
 
   x_free(ds);
 }
@@ -739,6 +788,206 @@ int ds_set_strnattr(SQLWCHAR **attr, const SQLWCHAR *val, size_t charcount)
 }
 
 
+/* Kinds of data source parameters, see dsparammap */
+#define DS_PARAM_STR  0
+#define DS_PARAM_INT  1
+#define DS_PARAM_BOOL 2
+
+typedef struct
+{
+  const SQLWCHAR *name;
+  int             kind;
+  size_t          offset;   /* of the field in DataSource */
+} DS_PARAM_MAP;
+
+#define DS_STR(field)   DS_PARAM_STR, offsetof(DataSource, field)
+#define DS_INT(field)   DS_PARAM_INT, offsetof(DataSource, field)
+#define DS_BOOL(field)  DS_PARAM_BOOL, offsetof(DataSource, field)
+
+/*
+ * Parameter names and the fields of the data source object they are
+ * stored in. Parameter aliases can be used here, see W_UID, W_USER.
+ */
+static const
+DS_PARAM_MAP dsparammap[]= {
+  {W_DSN, DS_STR(name)},
+  {W_DRIVER, DS_STR(driver)},
+  {W_DESCRIPTION, DS_STR(description)},
+  {W_SERVER, DS_STR(server)},
+  {W_UID, DS_STR(uid)},
+  {W_USER, DS_STR(uid)},
+  {W_PWD, DS_STR(pwd)},
+  {W_PASSWORD, DS_STR(pwd)},
+  {W_DB, DS_STR(database)},
+  {W_DATABASE, DS_STR(database)},
+  {W_SOCKET, DS_STR(socket)},
+  {W_INITSTMT, DS_STR(initstmt)},
+  {W_CHARSET, DS_STR(charset)},
+  {W_SSLKEY, DS_STR(sslkey)},
+  {W_SSLCERT, DS_STR(sslcert)},
+  {W_SSLCA, DS_STR(sslca)},
+  {W_SSLCAPATH, DS_STR(sslcapath)},
+  {W_SSLCIPHER, DS_STR(sslcipher)},
+  {W_SSLMODE, DS_STR(sslmode)},
+  {W_SAVEFILE, DS_STR(savefile)},
+  {W_RSAKEY, DS_STR(rsakey)},
+  {W_PORT, DS_INT(port)},
+  {W_SSLVERIFY, DS_INT(sslverify)},
+  {W_READTIMEOUT, DS_INT(readtimeout)},
+  {W_WRITETIMEOUT, DS_INT(writetimeout)},
+  {W_CLIENT_INTERACTIVE, DS_INT(clientinteractive)},
+  {W_PREFETCH, DS_INT(cursor_prefetch_number)},
+  {W_FOUND_ROWS, DS_BOOL(return_matching_rows)},
+  {W_BIG_PACKETS, DS_BOOL(allow_big_results)},
+  {W_NO_PROMPT, DS_BOOL(dont_prompt_upon_connect)},
+  {W_DYNAMIC_CURSOR, DS_BOOL(dynamic_cursor)},
+  {W_NO_SCHEMA, DS_BOOL(ignore_N_in_name_table)},
+  {W_NO_DEFAULT_CURSOR, DS_BOOL(user_manager_cursor)},
+  {W_NO_LOCALE, DS_BOOL(dont_use_set_locale)},
+  {W_PAD_SPACE, DS_BOOL(pad_char_to_full_length)},
+  {W_FULL_COLUMN_NAMES, DS_BOOL(return_table_names_for_SqlDescribeCol)},
+  {W_COMPRESSED_PROTO, DS_BOOL(use_compressed_protocol)},
+  {W_IGNORE_SPACE, DS_BOOL(ignore_space_after_function_names)},
+  {W_NAMED_PIPE, DS_BOOL(force_use_of_named_pipes)},
+  {W_NO_BIGINT, DS_BOOL(change_bigint_columns_to_int)},
+  {W_NO_CATALOG, DS_BOOL(no_catalog)},
+  {W_USE_MYCNF, DS_BOOL(read_options_from_mycnf)},
+  {W_SAFE, DS_BOOL(safe)},
+  {W_NO_TRANSACTIONS, DS_BOOL(disable_transactions)},
+  {W_LOG_QUERY, DS_BOOL(save_queries)},
+  {W_NO_CACHE, DS_BOOL(dont_cache_result)},
+  {W_FORWARD_CURSOR, DS_BOOL(force_use_of_forward_only_cursors)},
+  {W_AUTO_RECONNECT, DS_BOOL(auto_reconnect)},
+  {W_AUTO_IS_NULL, DS_BOOL(auto_increment_null_search)},
+  {W_ZERO_DATE_TO_MIN, DS_BOOL(zero_date_to_min)},
+  {W_MIN_DATE_TO_ZERO, DS_BOOL(min_date_to_zero)},
+  {W_MULTI_STATEMENTS, DS_BOOL(allow_multiple_statements)},
+  {W_COLUMN_SIZE_S32, DS_BOOL(limit_column_size)},
+  {W_NO_BINARY_RESULT, DS_BOOL(handle_binary_as_char)},
+  {W_DFLT_BIGINT_BIND_STR, DS_BOOL(default_bigint_bind_str)},
+  {W_NO_I_S, DS_BOOL(no_information_schema)},
+  {W_NO_SSPS, DS_BOOL(no_ssps)},
+  {W_CAN_HANDLE_EXP_PWD, DS_BOOL(can_handle_exp_pwd)},
+  {W_ENABLE_CLEARTEXT_PLUGIN, DS_BOOL(enable_cleartext_plugin)},
+  {W_PLUGIN_DIR, DS_STR(plugin_dir)},
+  {W_DEFAULT_AUTH, DS_STR(default_auth)},
+  {W_DISABLE_SSL_DEFAULT, DS_BOOL(disable_ssl_default)},
+  {W_SSL_ENFORCE, DS_BOOL(ssl_enforce)},
+  {W_TLS_1, DS_BOOL(tls_1)},
+  {W_NO_TLS_1_1, DS_BOOL(no_tls_1_1)},
+  {W_NO_TLS_1_2, DS_BOOL(no_tls_1_2)},
+  {W_NO_DATE_OVERFLOW, DS_BOOL(no_date_overflow)},
+  {W_PARALLEL_FETCH, DS_INT(parallel_fetch_threads)},
+  {W_PARALLEL_FETCH_MIN_CELLS, DS_INT(parallel_fetch_min_cells)},
+  {W_PREPARE_SELECT, DS_BOOL(prepare_select)},
+  {W_LOAD_BALANCE, DS_STR(load_balance)},
+  {W_HOST_BACKOFF, DS_INT(host_backoff)},
+  {W_CATALOG_BATCH, DS_INT(catalog_batch)},
+  {W_CATALOG_THREADS, DS_INT(catalog_threads)},
+  {W_STMT_POOL, DS_INT(stmt_pool)},
+  {W_COMPRESSION_ALGORITHM, DS_STR(compression_algorithm)},
+  {W_COMPRESSION_LEVEL, DS_INT(compression_level)},
+  {W_READ_AHEAD, DS_INT(read_ahead)},
+  {W_RESULT_CACHE_TTL, DS_INT(result_cache_ttl)},
+  {W_RESULT_CACHE_SIZE, DS_INT(result_cache_size)},
+  {W_LATENCY_STATS, DS_BOOL(latency_stats)},
+  {W_LATENCY_DUMP, DS_STR(latency_dump)},
+  {W_KEYSET_CURSOR, DS_BOOL(keyset_cursor)},
+  /* DS_PARAM */
+};
+static const
+int dsparammapcnt= sizeof(dsparammap) / sizeof(DS_PARAM_MAP);
+
+
+/*
+ * Perfect hash of the parameter names, so that mapping a parameter costs
+ * one hash and one comparison instead of a comparison per known name.
+ * The seed giving each name of dsparammap its own slot is searched once,
+ * a slot holds the index in dsparammap plus one, 0 for a free slot.
+ */
+#define DS_PARAM_HASH_SIZE  1024
+#define DS_PARAM_HASH_TRIES 4096
+
+static unsigned short dsparamhash[DS_PARAM_HASH_SIZE];
+static unsigned int dsparamseed;
+static BOOL dsparamhashed= FALSE;
+static my_thread_once_t dsparamhash_once= MY_THREAD_ONCE_INIT;
+
+
+static unsigned int ds_param_hash(const SQLWCHAR *param, unsigned int seed)
+{
+  unsigned int h= 2166136261U ^ (seed * 2654435761U);
+  SQLWCHAR c;
+
+  while ((c= *param++))
+  {
+    /* same case folding as sqlwcharcasecmp() */
+    if (c >= 'a')
+      c -= ('a' - 'A');
+    h= (h ^ c) * 16777619U;
+  }
+
+  return (h ^ (h >> 13)) & (DS_PARAM_HASH_SIZE - 1);
+}
+
+
+static void ds_param_hash_init()
+{
+  unsigned int seed;
+  int i;
+
+  for (seed= 0; seed < DS_PARAM_HASH_TRIES; ++seed)
+  {
+    memset(dsparamhash, 0, sizeof(dsparamhash));
+
+    for (i= 0; i < dsparammapcnt; ++i)
+    {
+      unsigned int slot= ds_param_hash(dsparammap[i].name, seed);
+      if (dsparamhash[slot])
+        break;
+      dsparamhash[slot]= (unsigned short)(i + 1);
+    }
+
+    if (i == dsparammapcnt)
+    {
+      dsparamseed= seed;
+      dsparamhashed= TRUE;
+      return;
+    }
+  }
+
+  /* No luck, ds_param_find() falls back to scanning dsparammap */
+}
+
+
+/*
+ * Find the description of a data source parameter, NULL if the parameter
+ * is unknown.
+ */
+static const DS_PARAM_MAP *ds_param_find(const SQLWCHAR *param)
+{
+  int i;
+
+  my_thread_once(&dsparamhash_once, ds_param_hash_init);
+
+  if (dsparamhashed)
+  {
+    i= dsparamhash[ds_param_hash(param, dsparamseed)];
+    if (i && !sqlwcharcasecmp(dsparammap[i - 1].name, param))
+      return &dsparammap[i - 1];
+    return NULL;
+  }
+
+  for (i= 0; i < dsparammapcnt; ++i)
+  {
+    if (!sqlwcharcasecmp(dsparammap[i].name, param))
+      return &dsparammap[i];
+  }
+
+  return NULL;
+}
+
+
 /*
  * Internal function to map a parameter name of the data source object
  * to the pointer needed to set the parameter. Only one of strdest or
@@ -749,147 +998,226 @@ void ds_map_param(DataSource *ds, const SQLWCHAR *param,
                   SQLWCHAR ***strdest, unsigned int **intdest,
                   BOOL **booldest)
 {
+  const DS_PARAM_MAP *map= ds_param_find(param);
+
   *strdest= NULL;
   *intdest= NULL;
   *booldest= NULL;
-  /* parameter aliases can be used here, see W_UID, W_USER */
-  if (!sqlwcharcasecmp(W_DSN, param))
-    *strdest= &ds->name;
-  else if (!sqlwcharcasecmp(W_DRIVER, param))
-    *strdest= &ds->driver;
-  else if (!sqlwcharcasecmp(W_DESCRIPTION, param))
-    *strdest= &ds->description;
-  else if (!sqlwcharcasecmp(W_SERVER, param))
-    *strdest= &ds->server;
-  else if (!sqlwcharcasecmp(W_UID, param))
-    *strdest= &ds->uid;
-  else if (!sqlwcharcasecmp(W_USER, param))
-    *strdest= &ds->uid;
-  else if (!sqlwcharcasecmp(W_PWD, param))
-    *strdest= &ds->pwd;
-  else if (!sqlwcharcasecmp(W_PASSWORD, param))
-    *strdest= &ds->pwd;
-  else if (!sqlwcharcasecmp(W_DB, param))
-    *strdest= &ds->database;
-  else if (!sqlwcharcasecmp(W_DATABASE, param))
-    *strdest= &ds->database;
-  else if (!sqlwcharcasecmp(W_SOCKET, param))
-    *strdest= &ds->socket;
-  else if (!sqlwcharcasecmp(W_INITSTMT, param))
-    *strdest= &ds->initstmt;
-  else if (!sqlwcharcasecmp(W_CHARSET, param))
-    *strdest= &ds->charset;
-  else if (!sqlwcharcasecmp(W_SSLKEY, param))
-    *strdest= &ds->sslkey;
-  else if (!sqlwcharcasecmp(W_SSLCERT, param))
-    *strdest= &ds->sslcert;
-  else if (!sqlwcharcasecmp(W_SSLCA, param))
-    *strdest= &ds->sslca;
-  else if (!sqlwcharcasecmp(W_SSLCAPATH, param))
-    *strdest= &ds->sslcapath;
-  else if (!sqlwcharcasecmp(W_SSLCIPHER, param))
-    *strdest= &ds->sslcipher;
-  else if (!sqlwcharcasecmp(W_SSLMODE, param))
-    *strdest = &ds->sslmode;
-  else if (!sqlwcharcasecmp(W_SAVEFILE, param))
-    *strdest= &ds->savefile;
-  else if (!sqlwcharcasecmp(W_RSAKEY, param))
-    *strdest= &ds->rsakey;
-
-  else if (!sqlwcharcasecmp(W_PORT, param))
-    *intdest= &ds->port;
-  else if (!sqlwcharcasecmp(W_SSLVERIFY, param))
-    *intdest= &ds->sslverify;
-  else if (!sqlwcharcasecmp(W_READTIMEOUT, param))
-    *intdest= &ds->readtimeout;
-  else if (!sqlwcharcasecmp(W_WRITETIMEOUT, param))
-    *intdest= &ds->writetimeout;
-  else if (!sqlwcharcasecmp(W_CLIENT_INTERACTIVE, param))
-    *intdest= &ds->clientinteractive;
-  else if (!sqlwcharcasecmp(W_PREFETCH, param))
-    *intdest= &ds->cursor_prefetch_number;
-  else if (!sqlwcharcasecmp(W_FOUND_ROWS, param))
-    *booldest= &ds->return_matching_rows;
-  else if (!sqlwcharcasecmp(W_BIG_PACKETS, param))
-    *booldest= &ds->allow_big_results;
-  else if (!sqlwcharcasecmp(W_NO_PROMPT, param))
-    *booldest= &ds->dont_prompt_upon_connect;
-  else if (!sqlwcharcasecmp(W_DYNAMIC_CURSOR, param))
-    *booldest= &ds->dynamic_cursor;
-  else if (!sqlwcharcasecmp(W_NO_SCHEMA, param))
-    *booldest= &ds->ignore_N_in_name_table;
-  else if (!sqlwcharcasecmp(W_NO_DEFAULT_CURSOR, param))
-    *booldest= &ds->user_manager_cursor;
-  else if (!sqlwcharcasecmp(W_NO_LOCALE, param))
-    *booldest= &ds->dont_use_set_locale;
-  else if (!sqlwcharcasecmp(W_PAD_SPACE, param))
-    *booldest= &ds->pad_char_to_full_length;
-  else if (!sqlwcharcasecmp(W_FULL_COLUMN_NAMES, param))
-    *booldest= &ds->return_table_names_for_SqlDescribeCol;
-  else if (!sqlwcharcasecmp(W_COMPRESSED_PROTO, param))
-    *booldest= &ds->use_compressed_protocol;
-  else if (!sqlwcharcasecmp(W_IGNORE_SPACE, param))
-    *booldest= &ds->ignore_space_after_function_names;
-  else if (!sqlwcharcasecmp(W_NAMED_PIPE, param))
-    *booldest= &ds->force_use_of_named_pipes;
-  else if (!sqlwcharcasecmp(W_NO_BIGINT, param))
-    *booldest= &ds->change_bigint_columns_to_int;
-  else if (!sqlwcharcasecmp(W_NO_CATALOG, param))
-    *booldest= &ds->no_catalog;
-  else if (!sqlwcharcasecmp(W_USE_MYCNF, param))
-    *booldest= &ds->read_options_from_mycnf;
-  else if (!sqlwcharcasecmp(W_SAFE, param))
-    *booldest= &ds->safe;
-  else if (!sqlwcharcasecmp(W_NO_TRANSACTIONS, param))
-    *booldest= &ds->disable_transactions;
-  else if (!sqlwcharcasecmp(W_LOG_QUERY, param))
-    *booldest= &ds->save_queries;
-  else if (!sqlwcharcasecmp(W_NO_CACHE, param))
-    *booldest= &ds->dont_cache_result;
-  else if (!sqlwcharcasecmp(W_FORWARD_CURSOR, param))
-    *booldest= &ds->force_use_of_forward_only_cursors;
-  else if (!sqlwcharcasecmp(W_AUTO_RECONNECT, param))
-    *booldest= &ds->auto_reconnect;
-  else if (!sqlwcharcasecmp(W_AUTO_IS_NULL, param))
-    *booldest= &ds->auto_increment_null_search;
-  else if (!sqlwcharcasecmp(W_ZERO_DATE_TO_MIN, param))
-    *booldest= &ds->zero_date_to_min;
-  else if (!sqlwcharcasecmp(W_MIN_DATE_TO_ZERO, param))
-    *booldest= &ds->min_date_to_zero;
-  else if (!sqlwcharcasecmp(W_MULTI_STATEMENTS, param))
-    *booldest= &ds->allow_multiple_statements;
-  else if (!sqlwcharcasecmp(W_COLUMN_SIZE_S32, param))
-    *booldest= &ds->limit_column_size;
-  else if (!sqlwcharcasecmp(W_NO_BINARY_RESULT, param))
-    *booldest= &ds->handle_binary_as_char;
-  else if (!sqlwcharcasecmp(W_DFLT_BIGINT_BIND_STR, param))
-    *booldest= &ds->default_bigint_bind_str;
-  else if (!sqlwcharcasecmp(W_NO_I_S, param))
-    *booldest= &ds->no_information_schema;
-  else if (!sqlwcharcasecmp(W_NO_SSPS, param))
-    *booldest= &ds->no_ssps;
-  else if (!sqlwcharcasecmp(W_CAN_HANDLE_EXP_PWD, param))
-    *booldest= &ds->can_handle_exp_pwd;
-  else if (!sqlwcharcasecmp(W_ENABLE_CLEARTEXT_PLUGIN, param))
-    *booldest= &ds->enable_cleartext_plugin;
-  else if (!sqlwcharcasecmp(W_PLUGIN_DIR, param))
-    *strdest= &ds->plugin_dir;
-  else if (!sqlwcharcasecmp(W_DEFAULT_AUTH, param))
-    *strdest= &ds->default_auth;
-  else if (!sqlwcharcasecmp(W_DISABLE_SSL_DEFAULT, param))
-    *booldest = &ds->disable_ssl_default;
-  else if (!sqlwcharcasecmp(W_SSL_ENFORCE, param))
-    *booldest = &ds->ssl_enforce;
-  else if (!sqlwcharcasecmp(W_TLS_1, param))
-    *booldest = &ds->tls_1;
-  else if (!sqlwcharcasecmp(W_NO_TLS_1_1, param))
-    *booldest = &ds->no_tls_1_1;
-  else if (!sqlwcharcasecmp(W_NO_TLS_1_2, param))
-    *booldest = &ds->no_tls_1_2;
-  else if (!sqlwcharcasecmp(W_NO_DATE_OVERFLOW, param))
-    *booldest = &ds->no_date_overflow;
 
-  /* DS_PARAM */
+  if (!map)
+    return;
+
+  switch (map->kind)
+  {
+  case DS_PARAM_STR:
+    *strdest= (SQLWCHAR **)((char *)ds + map->offset);
+    break;
+  case DS_PARAM_INT:
+    *intdest= (unsigned int *)((char *)ds + map->offset);
+    break;
+  case DS_PARAM_BOOL:
+    *booldest= (BOOL *)((char *)ds + map->offset);
+    break;
+  }
+}
+
+
+#ifndef _WIN32
+/*
+ * Cache of the data sources read by ds_lookup().
+ *
+ * Reading a data source takes one SQLGetPrivateProfileString() call per
+ * attribute, and unixODBC opens and parses odbc.ini again for each of
+ * them. The attributes found are kept per data source name and config
+ * mode, and the whole cache is dropped when one of the ini files changes.
+ * On Windows the data sources are in the registry, which is cheap to
+ * read, so there is no cache there.
+ */
+#define DS_CACHE_MAX 64
+
+typedef struct ds_profile
+{
+  struct ds_profile *next;
+  SQLWCHAR          *name;
+  UWORD              mode;
+  SQLWCHAR          *attrs;     /* name\0value\0 pairs, ended by \0 */
+  size_t             len;       /* characters used in attrs */
+  size_t             alloced;
+} DS_PROFILE;
+
+static DS_PROFILE *ds_cache= NULL;
+static unsigned int ds_cache_count= 0;
+static ulonglong ds_cache_stamp= 0;
+static native_mutex_t ds_cache_lock;
+static my_thread_once_t ds_cache_once= MY_THREAD_ONCE_INIT;
+
+
+static void ds_cache_init()
+{
+  native_mutex_init(&ds_cache_lock, NULL);
+}
+
+
+static void ds_profile_free(DS_PROFILE *profile)
+{
+  x_free(profile->name);
+  x_free(profile->attrs);
+  x_free(profile);
+}
+
+
+/*
+ * Append an attribute to a profile being read. Returns non-zero if out
+ * of memory.
+ */
+static int ds_profile_add(DS_PROFILE *profile, const SQLWCHAR *name,
+                          const SQLWCHAR *val, size_t valsize)
+{
+  size_t namesize= sqlwcharlen(name);
+  size_t needed= profile->len + namesize + valsize + 3;
+
+  if (needed > profile->alloced)
+  {
+    size_t alloced= myodbc_max(needed, profile->alloced * 2);
+    SQLWCHAR *attrs= (SQLWCHAR *)myodbc_realloc(profile->attrs,
+                                                alloced * sizeof(SQLWCHAR),
+                                                MYF(MY_ALLOW_ZERO_PTR));
+    if (!attrs)
+      return 1;
+    profile->attrs= attrs;
+    profile->alloced= alloced;
+  }
+
+  memcpy(profile->attrs + profile->len, name, namesize * sizeof(SQLWCHAR));
+  profile->len+= namesize;
+  profile->attrs[profile->len++]= 0;
+  memcpy(profile->attrs + profile->len, val, valsize * sizeof(SQLWCHAR));
+  profile->len+= valsize;
+  profile->attrs[profile->len++]= 0;
+  profile->attrs[profile->len]= 0;
+
+  return 0;
+}
+
+
+/*
+ * Mix the modification time, size and inode of a file into a stamp,
+ * missing files count too.
+ */
+static void ds_stamp_file(ulonglong *stamp, const char *dir, const char *file)
+{
+  char path[1024];
+  struct stat st;
+
+  if (!file)
+    return;
+
+  if (dir)
+  {
+    if (!*dir)
+      return;
+    myodbc_snprintf(path, sizeof(path), "%s/%s", dir, file);
+    file= path;
+  }
+
+  if (stat(file, &st))
+  {
+    *stamp= *stamp * 1099511628211ULL;
+    return;
+  }
+
+  *stamp= (*stamp ^ (ulonglong)st.st_mtime) * 1099511628211ULL;
+  *stamp= (*stamp ^ (ulonglong)st.st_size) * 1099511628211ULL;
+  *stamp= (*stamp ^ (ulonglong)st.st_ino) * 1099511628211ULL;
+}
+
+
+/*
+ * Get a stamp of the ini files the driver manager may read data sources
+ * and drivers from. The stamp changes whenever one of them is modified.
+ */
+static ulonglong ds_ini_stamp()
+{
+  ulonglong stamp= 14695981039346656037ULL;
+  const char *home= getenv("HOME");
+  const char *sysdir= getenv("ODBCSYSINI");
+
+  ds_stamp_file(&stamp, NULL, getenv("ODBCINI"));
+  ds_stamp_file(&stamp, NULL, getenv("SYSODBCINI"));
+  ds_stamp_file(&stamp, NULL, getenv("ODBCINSTINI"));
+  ds_stamp_file(&stamp, home, ".odbc.ini");
+  ds_stamp_file(&stamp, home, ".odbcinst.ini");
+  ds_stamp_file(&stamp, sysdir, "odbc.ini");
+  ds_stamp_file(&stamp, sysdir, "odbcinst.ini");
+  ds_stamp_file(&stamp, NULL, "/etc/odbc.ini");
+  ds_stamp_file(&stamp, NULL, "/etc/odbcinst.ini");
+  ds_stamp_file(&stamp, NULL, "/usr/local/etc/odbc.ini");
+  ds_stamp_file(&stamp, NULL, "/usr/local/etc/odbcinst.ini");
+#ifdef __APPLE__
+  ds_stamp_file(&stamp, home, "Library/ODBC/odbc.ini");
+  ds_stamp_file(&stamp, home, "Library/ODBC/odbcinst.ini");
+  ds_stamp_file(&stamp, NULL, "/Library/ODBC/odbc.ini");
+  ds_stamp_file(&stamp, NULL, "/Library/ODBC/odbcinst.ini");
+#endif
+
+  return stamp;
+}
+
+
+/*
+ * Drop all cached data sources. Must be called with ds_cache_lock held.
+ */
+static void ds_cache_clear()
+{
+  while (ds_cache)
+  {
+    DS_PROFILE *next= ds_cache->next;
+    ds_profile_free(ds_cache);
+    ds_cache= next;
+  }
+  ds_cache_count= 0;
+}
+
+
+/*
+ * Drop all cached data sources, for when they are changed by us.
+ */
+void ds_cache_flush()
+{
+  my_thread_once(&ds_cache_once, ds_cache_init);
+
+  native_mutex_lock(&ds_cache_lock);
+  ds_cache_clear();
+  native_mutex_unlock(&ds_cache_lock);
+}
+#else
+void ds_cache_flush()
+{
+}
+#endif
+
+
+/*
+ * Set a parameter read from the system information of a data source.
+ * String parameters already set are left as they are.
+ */
+static void ds_set_param(DataSource *ds, const SQLWCHAR *param,
+                         const SQLWCHAR *val, size_t valsize)
+{
+  SQLWCHAR **dest;
+  unsigned int *intdest;
+  BOOL *booldest;
+
+  ds_map_param(ds, param, &dest, &intdest, &booldest);
+
+  if (dest && !*dest)
+    ds_set_strnattr(dest, val, valsize);
+  else if (intdest)
+    *intdest= sqlwchartoul(val, NULL);
+  else if (booldest)
+    *booldest= sqlwchartoul(val, NULL) > 0;
+  else if (!sqlwcharcasecmp(W_OPTION, param))
+    ds_set_options(ds, ds_get_options(ds) | sqlwchartoul(val, NULL));
 }
 
 
@@ -905,15 +1233,57 @@ int ds_lookup(DataSource *ds)
 {
   SQLWCHAR buf[8192];
   SQLWCHAR *entries= buf;
-  SQLWCHAR **dest;
   SQLWCHAR val[256];
   int size, used;
   int rc= 0;
   UWORD config_mode= config_get();
-  unsigned int *intdest;
-  BOOL *booldest;
+#ifndef _WIN32
+  DS_PROFILE *profile;
+  ulonglong stamp= ds_ini_stamp();
+#endif
   /* No need for SAVE_MODE() because we always call config_get() above. */
 
+#ifndef _WIN32
+  my_thread_once(&ds_cache_once, ds_cache_init);
+  native_mutex_lock(&ds_cache_lock);
+
+  if (stamp != ds_cache_stamp)
+  {
+    ds_cache_clear();
+    ds_cache_stamp= stamp;
+  }
+
+  for (profile= ds->name ? ds_cache : NULL; profile; profile= profile->next)
+  {
+    if (profile->mode == config_mode && !sqlwcharcasecmp(profile->name,
+                                                         ds->name))
+    {
+      const SQLWCHAR *attr= profile->attrs;
+
+      while (attr && *attr)
+      {
+        const SQLWCHAR *value= attr + sqlwcharlen(attr) + 1;
+        size_t valsize= sqlwcharlen(value);
+
+        ds_set_param(ds, attr, value, valsize);
+        attr= value + valsize + 1;
+      }
+
+      native_mutex_unlock(&ds_cache_lock);
+      return 0;
+    }
+  }
+
+  native_mutex_unlock(&ds_cache_lock);
+
+  profile= (DS_PROFILE *)myodbc_malloc(sizeof(DS_PROFILE), MYF(MY_ZEROFILL));
+  if (profile)
+  {
+    profile->mode= config_mode;
+    profile->name= sqlwchardup(ds->name, SQL_NTS);
+  }
+#endif
+
 #ifdef _WIN32
   /* We must do this to detect the WinXP bug mentioned below */
   memset(buf, 0xff, sizeof(buf));
@@ -976,7 +1346,6 @@ int ds_lookup(DataSource *ds)
                              entries += sqlwcharlen(entries) + 1)
   {
     int valsize;
-    ds_map_param(ds, entries, &dest, &intdest, &booldest);
 
     if ((valsize= SQLGetPrivateProfileStringW(ds->name, entries, W_EMPTY,
                                               val, ODBCDATASOURCE_STRLEN,
@@ -985,22 +1354,52 @@ int ds_lookup(DataSource *ds)
       rc= 1;
       goto end;
     }
-    else if (!valsize)
-      /* skip blanks */;
-    else if (dest && !*dest)
-      ds_set_strnattr(dest, val, valsize);
-    else if (intdest)
-      *intdest= sqlwchartoul(val, NULL);
-    else if (booldest)
-      *booldest= sqlwchartoul(val, NULL) > 0;
-    else if (!sqlwcharcasecmp(W_OPTION, entries))
-      ds_set_options(ds, ds_get_options(ds) | sqlwchartoul(val, NULL));
+    else if (valsize)
+    {
+      /* blanks are skipped */
+      ds_set_param(ds, entries, val, valsize);
+
+#ifndef _WIN32
+      if (profile && ds_profile_add(profile, entries, val, valsize))
+      {
+        ds_profile_free(profile);
+        profile= NULL;
+      }
+#endif
+    }
 
     RESTORE_MODE();
   }
 
 end:
   config_set(config_mode);
+
+#ifndef _WIN32
+  if (profile)
+  {
+    /* Only data sources read completely are kept */
+    if (rc || !profile->name)
+    {
+      ds_profile_free(profile);
+    }
+    else
+    {
+      native_mutex_lock(&ds_cache_lock);
+      if (ds_cache_stamp == stamp && ds_cache_count < DS_CACHE_MAX)
+      {
+        profile->next= ds_cache;
+        ds_cache= profile;
+        ++ds_cache_count;
+      }
+      else
+      {
+        ds_profile_free(profile);
+      }
+      native_mutex_unlock(&ds_cache_lock);
+    }
+  }
+#endif
+
   return rc;
 }
 
@@ -1382,6 +1781,22 @@ int ds_add(DataSource *ds)
   if (ds_add_intprop(ds->name, W_NO_TLS_1_1, ds->no_tls_1_1)) goto error;
   if (ds_add_intprop(ds->name, W_NO_TLS_1_2, ds->no_tls_1_2)) goto error;
   if (ds_add_intprop(ds->name, W_NO_DATE_OVERFLOW, ds->no_date_overflow)) goto error;
+  if (ds_add_intprop(ds->name, W_PARALLEL_FETCH, ds->parallel_fetch_threads)) goto error;
+  if (ds_add_intprop(ds->name, W_PARALLEL_FETCH_MIN_CELLS, ds->parallel_fetch_min_cells)) goto error;
+  if (ds_add_intprop(ds->name, W_PREPARE_SELECT, ds->prepare_select)) goto error;
+  if (ds_add_strprop(ds->name, W_LOAD_BALANCE, ds->load_balance)) goto error;
+  if (ds_add_intprop(ds->name, W_HOST_BACKOFF, ds->host_backoff)) goto error;
+  if (ds_add_intprop(ds->name, W_CATALOG_BATCH, ds->catalog_batch)) goto error;
+  if (ds_add_intprop(ds->name, W_CATALOG_THREADS, ds->catalog_threads)) goto error;
+  if (ds_add_intprop(ds->name, W_STMT_POOL, ds->stmt_pool)) goto error;
+  if (ds_add_strprop(ds->name, W_COMPRESSION_ALGORITHM, ds->compression_algorithm)) goto error;
+  if (ds_add_intprop(ds->name, W_COMPRESSION_LEVEL, ds->compression_level)) goto error;
+  if (ds_add_intprop(ds->name, W_READ_AHEAD, ds->read_ahead)) goto error;
+  if (ds_add_intprop(ds->name, W_RESULT_CACHE_TTL, ds->result_cache_ttl)) goto error;
+  if (ds_add_intprop(ds->name, W_RESULT_CACHE_SIZE, ds->result_cache_size)) goto error;
+  if (ds_add_intprop(ds->name, W_LATENCY_STATS, ds->latency_stats)) goto error;
+  if (ds_add_strprop(ds->name, W_LATENCY_DUMP, ds->latency_dump)) goto error;
+  if (ds_add_intprop(ds->name, W_KEYSET_CURSOR, ds->keyset_cursor)) goto error;
   /* DS_PARAM */
 
   rc= 0;
@@ -1389,6 +1804,8 @@ int ds_add(DataSource *ds)
 error:
   if (driver)
     driver_delete(driver);
+  /* the data source was changed, even if only partly */
+  ds_cache_flush();
   return rc;
 }
 
@@ -87,6 +87,9 @@ typedef struct {
   SQLWCHAR *savefile;
   SQLWCHAR *plugin_dir;
   SQLWCHAR *default_auth;
+  SQLWCHAR *load_balance;
+  SQLWCHAR *compression_algorithm;
+  SQLWCHAR *latency_dump;
 
   unsigned int port;
   unsigned int readtimeout;
@@ -113,6 +116,9 @@ typedef struct {
   SQLWCHAR *savefile8;
   SQLCHAR *plugin_dir8;
   SQLCHAR *default_auth8;
+  SQLCHAR *load_balance8;
+  SQLCHAR *compression_algorithm8;
+  SQLCHAR *latency_dump8;
 
   /*  */
   BOOL return_matching_rows;
@@ -162,6 +168,21 @@ typedef struct {
   BOOL no_tls_1_2;
 
   BOOL no_date_overflow;
+
+  /* performance */
+  unsigned int parallel_fetch_threads;
+  unsigned int parallel_fetch_min_cells;
+  BOOL prepare_select;
+  unsigned int host_backoff;
+  unsigned int catalog_batch;
+  unsigned int catalog_threads;
+  unsigned int stmt_pool;
+  unsigned int compression_level;
+  unsigned int read_ahead;
+  unsigned int result_cache_ttl;
+  unsigned int result_cache_size;
+  BOOL latency_stats;
+  BOOL keyset_cursor;
 } DataSource;
 
 /* perhaps that is a good idea to have const ds object with defaults */
@@ -183,6 +204,7 @@ void ds_delete(DataSource *ds);
 int ds_set_strattr(SQLWCHAR **attr, const SQLWCHAR *val);
 int ds_set_strnattr(SQLWCHAR **attr, const SQLWCHAR *val, size_t charcount);
 int ds_lookup(DataSource *ds);
+void ds_cache_flush();
 int ds_from_kvpair(DataSource *ds, const SQLWCHAR *attrs, SQLWCHAR delim);
 int ds_to_kvpair(DataSource *ds, SQLWCHAR *attrs, size_t attrslen,
                  SQLWCHAR delim);
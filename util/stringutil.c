@@ -491,6 +491,293 @@ SQLINTEGER sqlwchar_as_sqlchar_buf(CHARSET_INFO *charset_info,
 }
 
 
+/*
+ * Direct conversion tables between pairs of character sets.
+ *
+ * Converting through the mb_wc/wc_mb functions of the character sets
+ * costs two indirect calls per character. When the target is a
+ * single-byte character set, a table built the first time the pair is
+ * used gives the result byte directly: indexed by the source byte for a
+ * single-byte source, and by code point for an utf8 source, whose ASCII
+ * runs are copied as they are. Tables are never freed, there are only a
+ * few pairs in use in a process.
+ */
+#define CONV_TABLES_MAX 32
+
+typedef struct
+{
+  CHARSET_INFO *from_cs;
+  CHARSET_INFO *to_cs;
+  my_bool       from_utf8;
+  my_bool       usable;       /* FALSE if the generic conversion is needed */
+  uchar         bytes[256];   /* single-byte source: byte in the target */
+  uchar         bad[256];     /* single-byte source: 1 if no mapping */
+  uchar        *pages[256];   /* utf8 source: byte of each code point of
+                                 the BMP by 256 code pages, 0 if none */
+} CONV_TABLE;
+
+static CONV_TABLE *conv_tables[CONV_TABLES_MAX];
+static native_mutex_t conv_tables_lock;
+static my_thread_once_t conv_tables_once= MY_THREAD_ONCE_INIT;
+
+/*
+  Number of the tables that are complete. It is only increased, under the
+  lock, with a release store after the table is built and put in the list,
+  and read with an acquire load, so that the lookups need no lock.
+*/
+#ifdef __WIN__
+static volatile LONG conv_table_count= 0;
+# define CONV_TABLE_COUNT() \
+  ((uint)InterlockedCompareExchange(&conv_table_count, 0, 0))
+# define CONV_TABLE_COUNT_SET(count) \
+  InterlockedExchange(&conv_table_count, (LONG)(count))
+#else
+static uint conv_table_count= 0;
+# define CONV_TABLE_COUNT() \
+  __atomic_load_n(&conv_table_count, __ATOMIC_ACQUIRE)
+# define CONV_TABLE_COUNT_SET(count) \
+  __atomic_store_n(&conv_table_count, (count), __ATOMIC_RELEASE)
+#endif
+
+
+static void conv_tables_init()
+{
+  native_mutex_init(&conv_tables_lock, NULL);
+}
+
+
+static void conv_table_free(CONV_TABLE *table)
+{
+  uint i;
+
+  for (i= 0; i < 256; ++i)
+  {
+    x_free(table->pages[i]);
+  }
+  x_free(table);
+}
+
+
+/*
+ * Build the conversion table of a pair of character sets, the target
+ * being a single-byte one.
+ */
+static CONV_TABLE *conv_table_build(CHARSET_INFO *from_cs,
+                                    CHARSET_INFO *to_cs)
+{
+  CONV_TABLE *table= (CONV_TABLE *)myodbc_malloc(sizeof(CONV_TABLE),
+                                                 MYF(MY_ZEROFILL));
+  uint i;
+
+  if (!table)
+  {
+    return NULL;
+  }
+
+  table->from_cs= from_cs;
+  table->to_cs= to_cs;
+  table->from_utf8= from_cs->mbmaxlen > 1;
+  table->usable= TRUE;
+
+  for (i= 0; i < 256; ++i)
+  {
+    uchar byte= (uchar)i, out[8];
+    my_wc_t wc;
+
+    if (table->from_utf8)
+    {
+      /* Code point of each byte of the target, back to its usual byte */
+      if (to_cs->cset->mb_wc(to_cs, &wc, &byte, &byte + 1) <= 0 ||
+          wc > 0xFFFF ||
+          to_cs->cset->wc_mb(to_cs, wc, out, out + 1) != 1)
+      {
+        continue;
+      }
+
+      /* ASCII is copied without looking at the table */
+      if (wc < 0x80 && out[0] != wc)
+      {
+        table->usable= FALSE;
+      }
+
+      if (!table->pages[wc >> 8] &&
+          !(table->pages[wc >> 8]= (uchar *)myodbc_malloc(256,
+                                                          MYF(MY_ZEROFILL))))
+      {
+        conv_table_free(table);
+        return NULL;
+      }
+      table->pages[wc >> 8][wc & 0xFF]= out[0];
+    }
+    else
+    {
+      if (from_cs->cset->mb_wc(from_cs, &wc, &byte, &byte + 1) <= 0)
+      {
+        table->bad[i]= 1;
+        wc= '?';
+      }
+
+      if (to_cs->cset->wc_mb(to_cs, wc, out, out + 1) != 1)
+      {
+        table->bad[i]= 1;
+        if (to_cs->cset->wc_mb(to_cs, '?', out, out + 1) != 1)
+          out[0]= '?';
+      }
+      table->bytes[i]= out[0];
+    }
+  }
+
+  return table;
+}
+
+
+/*
+ * Get the conversion table of a pair of character sets, building it if
+ * needed.
+ *
+ * @return The table, or NULL if the conversion has to go through the
+ *         functions of the character sets
+ */
+static const CONV_TABLE *conv_table_get(CHARSET_INFO *from_cs,
+                                        CHARSET_INFO *to_cs)
+{
+  CONV_TABLE *table= NULL;
+  uint i, count;
+
+  if (to_cs->mbmaxlen != 1 ||
+      (from_cs->mbmaxlen != 1 && !is_utf8_charset(from_cs->number)))
+  {
+    return NULL;
+  }
+
+  /* Once counted, a table and its slot are read-only */
+  count= CONV_TABLE_COUNT();
+  for (i= 0; i < count; ++i)
+  {
+    if (conv_tables[i]->from_cs == from_cs && conv_tables[i]->to_cs == to_cs)
+    {
+      return conv_tables[i]->usable ? conv_tables[i] : NULL;
+    }
+  }
+
+  my_thread_once(&conv_tables_once, conv_tables_init);
+  native_mutex_lock(&conv_tables_lock);
+
+  /* Another thread may have built it meanwhile */
+  for (i= count; i < conv_table_count && !table; ++i)
+  {
+    if (conv_tables[i]->from_cs == from_cs && conv_tables[i]->to_cs == to_cs)
+    {
+      table= conv_tables[i];
+    }
+  }
+
+  if (!table && conv_table_count < CONV_TABLES_MAX &&
+      (table= conv_table_build(from_cs, to_cs)))
+  {
+    conv_tables[conv_table_count]= table;
+    CONV_TABLE_COUNT_SET(conv_table_count + 1);
+  }
+
+  native_mutex_unlock(&conv_tables_lock);
+
+  return table && table->usable ? table : NULL;
+}
+
+
+/*
+ * Convert a string with a conversion table. Same interface as
+ * copy_and_convert().
+ */
+static uint32 convert_by_table(const CONV_TABLE *table,
+                               char *to, uint32 to_length,
+                               const char *from, uint32 from_length,
+                               uint32 *used_bytes, uint32 *used_chars,
+                               uint *errors)
+{
+  const uchar *src= (const uchar *)from, *src_end= src + from_length;
+  uchar *dst= (uchar *)to, *dst_end= dst + to_length;
+  uint error_count= 0;
+
+  if (!table->from_utf8)
+  {
+    const uchar *end= src + myodbc_min(from_length, to_length);
+
+    while (src < end)
+    {
+      error_count+= table->bad[*src];
+      *dst++= table->bytes[*src++];
+    }
+  }
+  else
+  {
+    while (src < src_end && dst < dst_end)
+    {
+      my_wc_t wc;
+      int len;
+
+      if (*src < 0x80)
+      {
+        const uchar *run_end= src + myodbc_min(src_end - src, dst_end - dst),
+                    *pos= src;
+
+        while (pos < run_end && *pos < 0x80)
+        {
+          ++pos;
+        }
+        memcpy(dst, src, pos - src);
+        dst+= pos - src;
+        src= pos;
+        continue;
+      }
+
+      /* Two bytes cover the Latin, Greek and Cyrillic letters */
+      if (*src >= 0xC2 && *src < 0xE0 && src + 1 < src_end &&
+          (src[1] ^ 0x80) < 0x40)
+      {
+        wc= ((my_wc_t)(src[0] & 0x1F) << 6) | (src[1] ^ 0x80);
+        len= 2;
+      }
+      else
+      {
+        len= table->from_cs->cset->mb_wc(table->from_cs, &wc, src, src_end);
+
+        if (len == MY_CS_ILSEQ || (len < 0 && len > MY_CS_TOOSMALL))
+        {
+          ++error_count;
+          len= len ? -len : 1;
+          wc= '?';
+        }
+        else if (len < 0)
+        {
+          break; /* Not enough characters */
+        }
+      }
+
+      if (wc < 0x10000 && table->pages[wc >> 8] &&
+          table->pages[wc >> 8][wc & 0xFF])
+      {
+        *dst++= table->pages[wc >> 8][wc & 0xFF];
+      }
+      else
+      {
+        if (wc != '?')
+          ++error_count;
+        *dst++= '?';
+      }
+      src+= len;
+    }
+  }
+
+  *used_bytes= (uint32)(src - (const uchar *)from);
+  *used_chars= (uint32)(dst - (uchar *)to);
+  if (errors)
+    *errors+= error_count;
+
+  return (uint32)(dst - (uchar *)to);
+}
+
+
 /**
   Copy a string from one character set to another. Taken from sql_string.cc
   in the MySQL Server source code, since we don't export this functionality
@@ -527,6 +814,13 @@ copy_and_convert(char *to, uint32 to_length, CHARSET_INFO *to_cs,
   int (*wc_mb)(struct charset_info_st *, my_wc_t, uchar *s, uchar *e)=
     to_cs->cset->wc_mb;
   uint error_count= 0;
+  const CONV_TABLE *table= conv_table_get(from_cs, to_cs);
+
+  if (table)
+  {
+    return convert_by_table(table, to, to_length, from, from_length,
+                            used_bytes, used_chars, errors);
+  }
 
   *used_bytes= *used_chars= 0;
 
@@ -538,6 +832,7 @@ copy_and_convert(char *to, uint32 to_length, CHARSET_INFO *to_cs,
     {
       ++error_count;
       ++from;
+      from_cnvres= 1;
       wc= '?';
     }
     else if (from_cnvres > MY_CS_TOOSMALL)
@@ -547,7 +842,8 @@ copy_and_convert(char *to, uint32 to_length, CHARSET_INFO *to_cs,
         But it doesn't have Unicode mapping.
       */
       ++error_count;
-      from+= (-from_cnvres);
+      from_cnvres= -from_cnvres;
+      from+= from_cnvres;
       wc= '?';
     }
     else